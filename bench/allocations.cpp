@@ -0,0 +1,118 @@
+/**
+ *  Allocations.cpp
+ *
+ *  Counts the number of heap allocations that are needed to process a
+ *  loop-heavy template, both with and without a reused RenderContext, and
+ *  with a context that allocates every temporary value on the heap instead
+ *  of in an arena.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+#include <cstdlib>
+#include <new>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Number of calls to operator new
+ *  @var size_t
+ */
+static size_t allocations = 0;
+
+/**
+ *  Replacement allocation functions that count the allocations
+ */
+void *operator new(size_t size)
+{
+    allocations += 1;
+    if (void *result = malloc(size ? size : 1)) return result;
+    throw std::bad_alloc();
+}
+void operator delete(void *pointer) noexcept { free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+
+/**
+ *  The render context has a private constructor for the benchmarks
+ */
+namespace SmartTpl { namespace Internal {
+class Benchmark
+{
+public:
+    /**
+     *  Create a context that allocates the temporary values on the heap
+     *  @return RenderContext
+     */
+    static RenderContext *heap() { return new RenderContext(false); }
+};
+}}
+
+/**
+ *  Count the allocations of a function
+ *  @param  name        name of the benchmark
+ *  @param  iterations  number of times to run the function
+ *  @param  function    the function to run
+ */
+template <typename Function>
+static void count(const std::string &name, size_t iterations, Function &&function)
+{
+    // warm up
+    function();
+
+    // remember the start value
+    size_t start = allocations;
+
+    // run the function
+    for (size_t i = 0; i < iterations; ++i) function();
+
+    // report
+    printf("%-50s %12.1f allocations/iteration\n", name.c_str(), double(allocations - start) / iterations);
+}
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // a template that creates many temporaries in a loop
+    Template tpl((Buffer(
+        "{$total = 0}"
+        "{foreach $item in $list}"
+            "{$item.name|toupper} costs {$item.price * $item.quantity}, "
+            "{$total = $total + $item.price * $item.quantity}"
+            "{if $item.quantity % 2 == 0}even{else}odd{/if}\n"
+        "{/foreach}"
+        "total: {$total}"
+    )));
+
+    // the data that is used
+    std::vector<VariantValue> list;
+    for (int i = 0; i < 1000; ++i) list.push_back(std::map<std::string, VariantValue>({
+        { "name", "product" },
+        { "price", i },
+        { "quantity", i % 7 }
+    }));
+    Data data;
+    data.assign("list", list);
+
+    // reusable contexts, with and without an arena
+    RenderContext context;
+    std::unique_ptr<RenderContext> heap(Internal::Benchmark::heap());
+
+    // count the allocations
+    count("process(data)", 100, [&]() { tpl.process(data); });
+    count("process(context, data) heap", 100, [&]() { tpl.process(*heap, data); });
+    count("process(context, data) arena", 100, [&]() { tpl.process(context, data); });
+
+    // and measure the time
+    measure("process(data)", 100, [&]() { tpl.process(data); });
+    measure("process(context, data) heap", 100, [&]() { tpl.process(*heap, data); });
+    measure("process(context, data) arena", 100, [&]() { tpl.process(context, data); });
+
+    // done
+    return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ *  Base64.cpp
+ *
+ *  Measures the base64 encoding and decoding of an attachment sized value,
+ *  with and without mime line wrapping.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // templates that encode, wrap and decode the value
+    Template encode((Buffer("{$attachment|base64_encode}")));
+    Template wrap((Buffer("{$attachment|base64_encode:76}")));
+    Template decode((Buffer("{$encoded|base64_decode}")));
+
+    // a one megabyte attachment with binary data
+    std::string attachment;
+    for (size_t i = 0; i < 1024 * 1024; ++i) attachment.push_back(char(i * 2654435761u >> 24));
+
+    // the data that is used
+    Data data;
+    data.assign("attachment", attachment);
+    data.assign("encoded", wrap.process(data));
+
+    // reusable context
+    RenderContext context;
+
+    // measure all of them
+    measure("base64_encode 1MB", 100, [&]() { encode.process(context, data); });
+    measure("base64_encode:76 1MB", 100, [&]() { wrap.process(context, data); });
+    measure("base64_decode 1MB", 100, [&]() { decode.process(context, data); });
+
+    // done
+    return 0;
+}
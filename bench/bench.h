@@ -0,0 +1,45 @@
+/**
+ *  Bench.h
+ *
+ *  Small helpers that are shared by the benchmarks
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cstdio>
+
+/**
+ *  Run a function a number of times, and report the time per iteration
+ *  @param  name        name of the benchmark
+ *  @param  iterations  number of times to run the function
+ *  @param  function    the function to run
+ *  @return double      nanoseconds per iteration
+ */
+template <typename Function>
+double measure(const std::string &name, size_t iterations, Function &&function)
+{
+    // warm up (caches, lazily initialized structures, etc)
+    function();
+
+    // start the clock
+    auto start = std::chrono::steady_clock::now();
+
+    // run the function
+    for (size_t i = 0; i < iterations; ++i) function();
+
+    // stop the clock
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    // time per iteration
+    double result = elapsed / iterations;
+
+    // report
+    printf("%-50s %12.1f ns/iteration\n", name.c_str(), result);
+
+    // done
+    return result;
+}
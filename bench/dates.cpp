@@ -0,0 +1,46 @@
+/**
+ *  Dates.cpp
+ *
+ *  Measures the date_format modifier in a loop over a list in which the
+ *  same few dates occur over and over again, both as timestamps and as
+ *  strings that have to be parsed, and the formatting of DateValue objects.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // the template that formats the dates
+    Template tpl((Buffer("{foreach $date in $dates}{$date|date_format:\"%Y-%m-%d\"}{/foreach}")));
+
+    // a couple of different dates, repeated many times
+    std::vector<VariantValue> timestamps, strings;
+    for (int i = 0; i < 1000; ++i) timestamps.emplace_back(std::to_string(1546300800 + (i % 10) * 86400));
+    for (int i = 0; i < 1000; ++i) strings.emplace_back("2019-01-0" + std::to_string(1 + i % 9) + " 12:00:00");
+
+    // the data that is used
+    Data data1, data2;
+    data1.assign("dates", timestamps);
+    data2.assign("dates", strings);
+
+    // measure the templates
+    measure("date_format timestamps x 1000", 100, [&]() { tpl.process(data1); });
+    measure("date_format strings x 1000", 100, [&]() { tpl.process(data2); });
+
+    // a date value that shows the current time
+    DateValue now("%Y-%m-%d %H:%M:%S");
+    measure("DateValue::toString", 1000000, [&]() { now.toString(); });
+
+    // done
+    return 0;
+}
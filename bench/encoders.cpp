@@ -0,0 +1,49 @@
+/**
+ *  Encoders.cpp
+ *
+ *  Measures the json and url encoding of variables. The url encoding is
+ *  measured with long tracking links, the json encoding with text that
+ *  contains the occasional quote and newline.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // a template that outputs a single value for each item
+    Template tpl((Buffer("{foreach $item in $list}{$item}{/foreach}")));
+
+    // a long tracking link
+    std::string link("https://www.example.com/landing/page?utm_source=newsletter&utm_medium=email&utm_campaign=spring sale 2019"
+                     "&recipient=4815162342&hash=a1b2c3d4e5f6a7b8c9d0&redirect=https://shop.example.com/products/shoes?size=42&color=blue");
+
+    // a piece of text
+    std::string text("Dear customer,\nThank you for ordering our \"Spring\" collection. Your order will be shipped within "
+                     "two working days, and you will receive a message with the tracking code as soon as it leaves our warehouse.");
+
+    // the data that is used
+    Data links;
+    links.assign("list", std::vector<VariantValue>(1000, link));
+    Data texts;
+    texts.assign("list", std::vector<VariantValue>(1000, text));
+
+    // reusable context, so that we mostly measure the output
+    RenderContext context;
+
+    // measure both encodings
+    measure("url x 1000", 200, [&]() { tpl.process(context, links, "url"); });
+    measure("json x 1000", 200, [&]() { tpl.process(context, texts, "json"); });
+
+    // done
+    return 0;
+}
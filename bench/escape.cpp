@@ -0,0 +1,59 @@
+/**
+ *  Escape.cpp
+ *
+ *  Measures the html escaping of variables, using values that look like
+ *  the personalisation data of a mailing: most of them contain nothing
+ *  that has to be escaped, some contain a few special characters.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // a template that outputs a number of fields for each recipient
+    Template tpl((Buffer(
+        "{foreach $recipient in $recipients}"
+            "<p>Dear {$recipient.name},</p>"
+            "<p>Your order from {$recipient.company} will be delivered at {$recipient.address}.</p>"
+            "<p>{$recipient.note}</p>\n"
+        "{/foreach}"
+    )));
+
+    // realistic values
+    std::vector<std::string> names({ "John Doe", "Jane O'Connor", "Pieter van den Berg", "Émile Zola" });
+    std::vector<std::string> companies({ "Copernica BV", "Smith & Sons", "ACME Corporation", "\"The\" Company" });
+    std::vector<std::string> addresses({ "Main Street 12, Amsterdam", "Rue de la Paix 3, Paris", "Baker Street 221b, London" });
+    std::string note("Thank you for your order, we hope that you enjoy the products. If you have any questions "
+                     "about your order, please reply to this message and <b>we</b> will get back to you within a day.");
+
+    // the data that is used
+    std::vector<VariantValue> recipients;
+    for (size_t i = 0; i < 1000; ++i) recipients.push_back(std::map<std::string, VariantValue>({
+        { "name", names[i % names.size()] },
+        { "company", companies[i % companies.size()] },
+        { "address", addresses[i % addresses.size()] },
+        { "note", note }
+    }));
+    Data data;
+    data.assign("recipients", recipients);
+
+    // reusable context, so that we mostly measure the output
+    RenderContext context;
+
+    // measure with and without escaping
+    measure("raw x 1000", 200, [&]() { tpl.process(context, data, "raw"); });
+    measure("html x 1000", 200, [&]() { tpl.process(context, data, "html"); });
+
+    // done
+    return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ *  Interpreter.cpp
+ *
+ *  Compares the interpreter with the jit compiler. The jit compiler takes
+ *  more time to set up a template, but processes it faster. For every
+ *  template we report after how many renders the compilation pays off.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Measure a template in both executors
+ *  @param  name        name of the template
+ *  @param  input       the template source
+ *  @param  data        the data that is used
+ */
+static void compare(const std::string &name, const std::string &input, const Data &data)
+{
+    // the time that it takes to set up the template
+    double compiling = measure(name + ": compile", 100, [&]() { Template tpl((Buffer(input))); });
+    double parsing = measure(name + ": interpret (setup)", 100, [&]() { Template tpl(Buffer(input), Template::never); });
+
+    // the time that it takes to process the template
+    Template compiled((Buffer(input)));
+    Template interpreted(Buffer(input), Template::never);
+    double jit = measure(name + ": compiled (render)", 1000, [&]() { compiled.process(data); });
+    double interpreter = measure(name + ": interpreted (render)", 1000, [&]() { interpreted.process(data); });
+
+    // after how many renders is the compiled template faster?
+    if (interpreter <= jit) printf("%-50s %12s\n", (name + ": crossover").c_str(), "never");
+    else printf("%-50s %12.0f renders\n", (name + ": crossover").c_str(), (compiling - parsing) / (interpreter - jit));
+}
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // the data that is used
+    std::vector<VariantValue> products;
+    for (int i = 0; i < 100; ++i) products.emplace_back(std::map<std::string, VariantValue>({ { "name", std::string("product ") + std::to_string(i) }, { "price", i * 1.25 } }));
+    Data data;
+    data.assign("name", "John").assign("products", products).assign("count", 3);
+
+    // a small template, like a subject line
+    compare("subject", "Hello {$name|ucfirst}, we have {$count} offers for you", data);
+
+    // a template with conditions
+    compare("conditions", "{if $count > 2}many{elseif $count == 1}one{else}none{/if} {if $name == \"John\"}hi John{/if} {$count * 2 + 1}", data);
+
+    // a template with a loop, like a newsletter
+    compare("loop x 100", "<ul>{foreach $p in $products}<li>{$p.name|toupper}: {$p.price|number_format:2} {if $p.price > 50}expensive{/if}</li>{/foreach}</ul>", data);
+
+    // done
+    return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ *  Loops.cpp
+ *
+ *  Measures loops that output variables that do not change during the loop,
+ *  next to variables that do.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // templates with output that is the same on every iteration, and output that changes
+    Template invariant((Buffer("{foreach $p in $products}{$shop.currency|upper} {$campaign|escape:\"url\"} {$brand|truncate:20}{/foreach}")));
+    Template variant((Buffer("{foreach $p in $products}{$p|upper} {$p|escape:\"url\"} {$p|truncate:20}{/foreach}")));
+
+    // the data that is used
+    std::vector<VariantValue> products;
+    for (int i = 0; i < 1000; ++i) products.emplace_back(std::string("product name ") + std::to_string(i));
+    std::map<std::string, VariantValue> shop({ { "currency", "eur" } });
+    Data data;
+    data.assign("products", products)
+        .assign("shop", shop)
+        .assign("campaign", "https://www.example.com/spring sale?utm=mail")
+        .assign("brand", "A brand with a rather long name");
+
+    // measure the templates
+    measure("loop invariant output x 1000", 1000, [&]() { invariant.process(data); });
+    measure("loop variant output x 1000", 1000, [&]() { variant.process(data); });
+
+    // done
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ *  Numbers.cpp
+ *
+ *  Compares the number conversions of the standard library (that allocate,
+ *  or throw for text that is not numeric) with the ones in SmartTpl::Number,
+ *  and measures templates that output and parse numbers.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // the values that are converted
+    integer_t integer = -1234567890123;
+    double number = 31415.926535;
+    std::string numeric("1234567");
+    std::string text("not a number");
+
+    // output string that is reused
+    std::string output;
+
+    // formatting integers
+    measure("std::to_string(integer)", 1000000, [&]() { output = std::to_string(integer); });
+    measure("Number::append(integer)", 1000000, [&]() { output.clear(); Number::append(integer, output); });
+
+    // formatting doubles
+    measure("snprintf(\"%.5f\")", 1000000, [&]() {
+        char buffer[512];
+        size_t written = snprintf(buffer, 512, "%.5f", number);
+        output.assign(buffer, written);
+    });
+    measure("Number::append(double)", 1000000, [&]() { output.clear(); Number::append(number, output); });
+
+    // parsing numbers, and text that is not numeric
+    integer_t result = 0;
+    measure("std::stoll(numeric)", 1000000, [&]() { result += std::stoll(numeric); });
+    measure("Number::parse(numeric)", 1000000, [&]() { integer_t value; Number::parse(numeric.data(), numeric.size(), value); result += value; });
+    measure("std::stoll(text) + catch", 100000, [&]() { try { result += std::stoll(text); } catch (...) {} });
+    measure("Number::parse(text)", 1000000, [&]() { integer_t value; Number::parse(text.data(), text.size(), value); result += value; });
+
+    // templates that output numbers, do arithmetic on strings, and format numbers
+    Template outputs((Buffer("{foreach $i in $list}{$i} {$i * 1.5} {/foreach}")));
+    Template arithmetic((Buffer("{foreach $s in $strings}{$s + 1}{/foreach}")));
+    Template formats((Buffer("{foreach $i in $list}{$i|number_format:2:',':'.'}{/foreach}")));
+
+    // the data that is used
+    std::vector<VariantValue> list, strings;
+    for (integer_t i = 0; i < 1000; ++i) list.emplace_back(i * 7919);
+    for (integer_t i = 0; i < 1000; ++i) strings.emplace_back(i % 2 ? std::to_string(i) : std::string("text"));
+    Data data;
+    data.assign("list", list).assign("strings", strings);
+
+    // measure the templates
+    measure("output integers and doubles x 1000", 1000, [&]() { outputs.process(data); });
+    measure("string arithmetic x 1000", 1000, [&]() { arithmetic.process(data); });
+    measure("number_format x 1000", 1000, [&]() { formats.process(data); });
+
+    // use the result, so that the parsing is not optimized away
+    return result == 42;
+}
@@ -0,0 +1,44 @@
+/**
+ *  Segments.cpp
+ *
+ *  Compares processing a big template that is mostly static into a string,
+ *  into a reused render context, and into a list of segments.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <../smarttpl.h>
+
+#include "bench.h"
+
+using namespace SmartTpl;
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // a newsletter of about 100KB with a couple of personalized fields
+    std::string block(10000, 'x');
+    std::string input;
+    for (int i = 0; i < 10; ++i) input.append(block).append("<p>Dear {$name}, your code is {$code}</p>");
+    Template tpl((Buffer(input)));
+
+    // the data that is used
+    Data data;
+    data.assign("name", "John").assign("code", "ABC123");
+
+    // objects that are reused
+    RenderContext context;
+    Segments segments;
+
+    // measure the different outputs
+    size_t total = 0;
+    measure("process() into a string", 10000, [&]() { total += tpl.process(data).size(); });
+    measure("process() into a render context", 10000, [&]() { total += tpl.process(context, data).size(); });
+    measure("process() into segments", 10000, [&]() { total += tpl.process(segments, data).bytes(); });
+
+    // use the result, so that the processing is not optimized away
+    return total == 42;
+}
@@ -60,4 +60,14 @@ struct smart_tpl_callbacks {
     const void *(*params_append_boolean)(void *userdata, const void *parameters, int boolean);
     void        (*mark_failed)          (void *userdata, const char *message);
     int         (*throw_exception)      (void *userdata, const char *message);
+    void        (*enter_scope)          (void *userdata);
+    void        (*leave_scope)          (void *userdata);
+    const void *(*variable_slot)        (void *userdata, size_t index);
+    void       *(*modifier_slot)        (void *userdata, size_t index);
+    void       *(*regex_cached)         (void *userdata, void **handle, const char *regex, size_t size);
+    int         (*regex_match)          (void *userdata, void *handle, const char *message, size_t size);
+    int         (*regex_search)         (void *userdata, const char *regex, size_t regex_size, const char *message, size_t size);
+    void        (*cache_reset)          (void *userdata, size_t slot, const void *variable);
+    int         (*output_cached)        (void *userdata, size_t slot);
+    void        (*output_store)         (void *userdata, size_t slot, const void *variable, int escape);
 };
@@ -0,0 +1,82 @@
+/**
+ *  CallbackSink.h
+ *
+ *  Sink implementation that passes the template output to a function
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include <functional>
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Class definition
+ */
+class CallbackSink : public Sink
+{
+public:
+    /**
+     *  Signature of the function
+     */
+    using Function = std::function<void(const char *buffer, size_t size)>;
+
+private:
+    /**
+     *  The function to call
+     *  @var    Function
+     */
+    Function _function;
+
+    /**
+     *  The chunk size
+     *  @var    size_t
+     */
+    size_t _chunksize;
+
+public:
+    /**
+     *  Constructor
+     *  @param  function    the function that is called for every chunk
+     *  @param  chunksize   preferred size of the chunks
+     */
+    CallbackSink(const Function &function, size_t chunksize = 4096) :
+        _function(function), _chunksize(chunksize) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~CallbackSink() {}
+
+    /**
+     *  Write a chunk of output
+     *  @param  buffer      pointer to the output
+     *  @param  size        size of the output
+     */
+    virtual void write(const char *buffer, size_t size) override
+    {
+        // pass on to the function
+        _function(buffer, size);
+    }
+
+    /**
+     *  The preferred size of the chunks
+     *  @return size_t
+     */
+    virtual size_t chunksize() const override
+    {
+        return _chunksize;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
+
@@ -30,9 +30,17 @@ private:
 
     /**
      *  All variables, indexed by name
-     *  @var    std::map
+     *  @var    Internal::HashTable
      */
-    std::map<std::string, const Value*> _variables;
+    Internal::HashTable<const Value*> _variables;
+
+    /**
+     *  All values that are stored in _variables, so that we can quickly
+     *  find out whether a value is held by this data object
+     *  @see contains
+     *  @var    std::unordered_multiset
+     */
+    std::unordered_multiset<const Value*> _values;
 
     /**
      *  All managed values that should be cleaned up upon destruction
@@ -41,9 +49,16 @@ private:
 
     /**
      *  All modifiers
-     *  @var std::map
+     *  @var Internal::HashTable
+     */
+    Internal::HashTable<Modifier*> _modifiers;
+
+    /**
+     *  Store a value in _variables (and keep _values in sync)
+     *  @param  name        name of the variable
+     *  @param  value       the value to store
      */
-    std::map<std::string, Modifier*> _modifiers;
+    void store(const std::string &name, const Value *value);
 
 public:
     /**
@@ -57,11 +72,12 @@ public:
      */
     Data(const Data &that)
     : _variables(that._variables),
+      _values(that._values),
       _managed_values(that._managed_values),
       _modifiers(that._modifiers)
     {
         // overwrite the state
-        _variables["smarty"] = &_state;
+        store("smarty", &_state);
     }
 
     /**
@@ -113,6 +129,14 @@ public:
 
     /**
      *  Register a modifier
+     *
+     *  Note that built-in modifiers without side effects (like toupper or
+     *  replace) that are applied to a literal in a template, are already
+     *  evaluated when the template is compiled. Inside a foreach loop, such
+     *  modifiers are only applied once per loop to variables that do not change
+     *  during the loop. Overriding a built-in modifier therefore only works
+     *  reliably when the replacement has no side effects either.
+     *
      *  @param  name        Name of the modifier
      *  @param  modifier    Pointer to the modifier object
      *  @return Data        Same object for chaining
@@ -127,6 +151,28 @@ public:
      */
     const Value *value(const char *name, size_t size) const;
 
+    /**
+     *  Retrieve a variable pointer by name and a precomputed hash
+     *  @param  name        the name
+     *  @param  size        size of the name
+     *  @param  hash        hash of the name (@see Internal::nameHash)
+     *  @return Value
+     */
+    const Value *value(const char *name, size_t size, uint64_t hash) const;
+
+    /**
+     *  Retrieve the values of a number of variables at once
+     *
+     *  This is used to bind the variables of a compiled template to the
+     *  data before the template is run, so that the template does not have
+     *  to look up the variables by name every time they are accessed.
+     *
+     *  @param  names       the names of the variables
+     *  @param  hashes      the hashes of the names (@see Internal::nameHash)
+     *  @param  values      filled with the values (nullptr for unknown variables)
+     */
+    void bind(const std::vector<std::string> &names, const std::vector<uint64_t> &hashes, std::vector<const Value*> &values) const;
+
     /**
      *  Retrieve a modifier by name
      *  @param  name        the name of the modifier
@@ -134,6 +180,15 @@ public:
      *  @return Modifier*   nullptr in case it isn't found
      */
     Modifier *modifier(const char *name, size_t size) const;
+
+    /**
+     *  Retrieve a modifier by name and a precomputed hash
+     *  @param  name        the name of the modifier
+     *  @param  size        size of the name
+     *  @param  hash        hash of the name (@see Internal::nameHash)
+     *  @return Modifier*   nullptr in case it isn't found
+     */
+    Modifier *modifier(const char *name, size_t size, uint64_t hash) const;
     
     /**
      *  contains a specific value
@@ -35,52 +35,60 @@ private:
      */
     mutable std::string _buffer;
 
+    /**
+     *  Is there a formatted timestamp in the _buffer?
+     *  @var   bool
+     */
+    mutable bool _valid = false;
+
+    /**
+     *  The timestamp that is currently in the _buffer
+     *  @var   std::time_t
+     */
+    mutable std::time_t _formatted = 0;
+
     /**
      *  Put the current date/time in the _buffer
      *  @note This method is only const as it is called from const methods
      */
     void initializeDate() const
     {
-        // Get the current timestamp
-        std::time_t time = _timestamp;
+        // Get the current timestamp, if time is 0 we want to current time
+        std::time_t time = _timestamp == 0 ? std::time(NULL) : _timestamp;
 
-        // If time is 0 we want to current time
-        if (time == 0) time = std::time(NULL);
-        // if our buffer isn't empty and our time was already set we have everything we need so we return
-        else if (!_buffer.empty()) return;
+        // if our buffer already holds this time (the current time only changes
+        // once per second) we have everything we need so we return
+        if (_valid && time == _formatted) return;
 
         // Convert it to our local time
-        std::tm *timeinfo = std::localtime(&time);
+        std::tm timeinfo;
+        localtime_r(&time, &timeinfo);
 
-        // Print it into _buffer using strftime
+        // Print it into _buffer using strftime, the buffer is doubled as long as
+        // it is too small (if 64kb is still not enough the format gives no output at all)
         // http://en.cppreference.com/w/cpp/chrono/c/strftime
-        // First declare a char buffer
-        char buf[_buffer.capacity()];
+        for (size_t size = std::max<size_t>(64, _format.size() * 4); size <= 65536; size *= 2)
+        {
+            // make room in the buffer
+            _buffer.resize(size);
 
-        // Then print into our character buffer
-        std::size_t len = std::strftime(buf, _buffer.capacity(), _format.c_str(), timeinfo);
+            // print into the buffer
+            std::size_t len = std::strftime(&_buffer[0], size, _format.c_str(), &timeinfo);
 
-        // as long as len is 0 we failed printing it, so increase our _buffer and redeclare a char buffer
-        while (len == 0)
-        {
-            // reserve more space in _buffer
-            _buffer.reserve(_buffer.capacity() * 2);
-
-            // declare a new char buffer
-            char nbuf[_buffer.capacity()];
-
-            // call strftime again
-            len = std::strftime(nbuf, _buffer.capacity(), _format.c_str(), timeinfo);
-            if (len > 0)
-            {
-                // if std::strftime returned more than 0 assign nbuf to _buffer and return
-                _buffer = nbuf;
-                return;
-            }
+            // try again with a bigger buffer if it did not fit
+            if (len == 0) continue;
+
+            // remove the unused part of the buffer, and remember what is in it
+            _buffer.resize(len);
+            _formatted = time;
+            _valid = true;
+            return;
         }
 
-        // If we reach this we never entered the loop, so just assign the original buf
-        _buffer = buf;
+        // the format gives no output
+        _buffer.clear();
+        _formatted = time;
+        _valid = true;
     }
 
 public:
@@ -94,7 +102,6 @@ public:
     DateValue(const std::string &format, const std::time_t timestamp = 0)
     : _format(format)
     , _timestamp(timestamp) {
-        _buffer.reserve(_format.size());
         if (_format.empty()) throw std::runtime_error("A DateValue with an empty format is undefined");
     }
 
@@ -52,20 +52,8 @@ public:
      */
     virtual std::string toString() const override
     {
-        // create buffer
-        char buffer[512];
-
-        // format string
-        size_t written = snprintf(buffer, 512, "%.5f", _value);
-
-        // Remove trailing zeroes
-        while (buffer[written - 1] == '0') written--;
-
-        // Round number?
-        if (buffer[written - 1] == '.') written--;
-
-        // Create string object
-        return std::string(buffer, written);
+        // at most five decimals, without trailing zeros
+        return Number::toString(_value);
     }
 
     /**
@@ -0,0 +1,74 @@
+/**
+ *  FileDescriptorSink.h
+ *
+ *  Sink implementation that writes the template output to a file descriptor,
+ *  which could be a regular file, a pipe or a socket.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Class definition
+ */
+class FileDescriptorSink : public Sink
+{
+private:
+    /**
+     *  The file descriptor
+     *  @var    int
+     */
+    int _fd;
+
+public:
+    /**
+     *  Constructor
+     *
+     *  The file descriptor is not closed by this object, that is the
+     *  responsibility of the caller.
+     *
+     *  @param  fd          the (blocking) file descriptor to write to
+     */
+    FileDescriptorSink(int fd) : _fd(fd) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~FileDescriptorSink() {}
+
+    /**
+     *  Write a chunk of output
+     *  @param  buffer      pointer to the output
+     *  @param  size        size of the output
+     *  @throws std::runtime_error  if writing to the descriptor failed
+     */
+    virtual void write(const char *buffer, size_t size) override
+    {
+        // keep going until everything is written
+        while (size > 0)
+        {
+            // write as much as possible
+            ssize_t written = ::write(_fd, buffer, size);
+
+            // interrupted calls can simply be retried
+            if (written < 0 && errno == EINTR) continue;
+
+            // other errors are fatal
+            if (written < 0) throw std::runtime_error(strerror(errno));
+
+            // move on to the remaining data
+            buffer += written;
+            size -= written;
+        }
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
+
@@ -0,0 +1,262 @@
+/**
+ *  HashTable.h
+ *
+ *  Open addressing hash table that is used by the Data class to store the
+ *  variables and modifiers. Lookups can be done with a plain buffer and
+ *  size (so that no std::string has to be constructed), and with a hash
+ *  that was calculated in advance (the code generators embed the hashes
+ *  of all names in the compiled templates).
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Calculate the hash of a name (64 bits FNV-1a)
+ *  @param  name        the name
+ *  @param  size        size of the name
+ *  @return uint64_t
+ */
+inline uint64_t nameHash(const char *name, size_t size)
+{
+    // start with the offset basis
+    uint64_t hash = 14695981039346656037ULL;
+
+    // process all bytes
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ (unsigned char)name[i]) * 1099511628211ULL;
+
+    // done
+    return hash;
+}
+
+/**
+ *  Class definition
+ */
+template <typename T>
+class HashTable
+{
+private:
+    /**
+     *  An entry in the table
+     */
+    struct Entry
+    {
+        /**
+         *  The key and its hash
+         */
+        std::string key;
+        uint64_t hash = 0;
+
+        /**
+         *  The value
+         */
+        T value = T();
+
+        /**
+         *  Is this entry in use?
+         */
+        bool used = false;
+    };
+
+    /**
+     *  All entries, the size is always zero or a power of two
+     *  @var    std::vector
+     */
+    std::vector<Entry> _entries;
+
+    /**
+     *  Number of entries in use
+     *  @var    size_t
+     */
+    size_t _size = 0;
+
+    /**
+     *  Find the position of a key, or the free position where it should go
+     *  @param  key         the key
+     *  @param  size        size of the key
+     *  @param  hash        hash of the key
+     *  @return size_t
+     */
+    size_t locate(const char *key, size_t size, uint64_t hash) const
+    {
+        // the table size is a power of two
+        size_t mask = _entries.size() - 1;
+
+        // probe the entries, there is always a free one
+        for (size_t i = hash & mask; ; i = (i + 1) & mask)
+        {
+            // get the entry
+            const auto &entry = _entries[i];
+
+            // a free entry means that the key is not in the table
+            if (!entry.used) return i;
+
+            // is this the key we're looking for?
+            if (entry.hash == hash && entry.key.size() == size && memcmp(entry.key.data(), key, size) == 0) return i;
+        }
+    }
+
+    /**
+     *  Double the size of the table
+     */
+    void grow()
+    {
+        // the new entries
+        std::vector<Entry> entries(std::max(_entries.size() * 2, size_t(16)));
+
+        // swap them with the current entries
+        std::swap(entries, _entries);
+
+        // move the old entries to their new position
+        for (auto &entry : entries)
+        {
+            // skip empty entries
+            if (entry.used) _entries[locate(entry.key.data(), entry.key.size(), entry.hash)] = std::move(entry);
+        }
+    }
+
+public:
+    /**
+     *  Constructor
+     */
+    HashTable() {}
+
+    /**
+     *  Constructor with initial values
+     *  @param  values      the keys and values
+     */
+    HashTable(std::initializer_list<std::pair<std::string, T>> values)
+    {
+        // add all values
+        insert(values);
+    }
+
+    /**
+     *  Copy and move constructors
+     *  @param  that
+     */
+    HashTable(const HashTable &that) = default;
+    HashTable(HashTable &&that) : _entries(std::move(that._entries)), _size(that._size) { that._entries.clear(); that._size = 0; }
+
+    /**
+     *  Assignment operators
+     *  @param  that
+     *  @return HashTable
+     */
+    HashTable &operator=(const HashTable &that) = default;
+    HashTable &operator=(HashTable &&that) { std::swap(_entries, that._entries); std::swap(_size, that._size); return *this; }
+
+    /**
+     *  Destructor
+     */
+    virtual ~HashTable() {}
+
+    /**
+     *  Find a value
+     *  @param  key         the key
+     *  @param  size        size of the key
+     *  @param  hash        hash of the key
+     *  @return T*          pointer to the value, nullptr if the key is not found
+     */
+    const T *find(const char *key, size_t size, uint64_t hash) const
+    {
+        // an empty table has no entries at all
+        if (_size == 0) return nullptr;
+
+        // get the entry
+        const auto &entry = _entries[locate(key, size, hash)];
+
+        // check if it is in use
+        return entry.used ? &entry.value : nullptr;
+    }
+
+    /**
+     *  Find a value
+     *  @param  key         the key
+     *  @param  size        size of the key
+     *  @return T*          pointer to the value, nullptr if the key is not found
+     */
+    const T *find(const char *key, size_t size) const
+    {
+        return find(key, size, nameHash(key, size));
+    }
+
+    /**
+     *  Find a value
+     *  @param  key         the key
+     *  @return T*          pointer to the value, nullptr if the key is not found
+     */
+    const T *find(const std::string &key) const
+    {
+        return find(key.data(), key.size());
+    }
+
+    /**
+     *  Find a value that can be changed
+     *  @param  key         the key
+     *  @return T*          pointer to the value, nullptr if the key is not found
+     */
+    T *find(const std::string &key)
+    {
+        return const_cast<T *>(static_cast<const HashTable *>(this)->find(key));
+    }
+
+    /**
+     *  Insert or overwrite a value
+     *  @param  key         the key
+     *  @param  value       the value
+     *  @return T           reference to the stored value
+     */
+    T &insert(const std::string &key, T value)
+    {
+        // make sure that at most half of the entries are in use
+        if ((_size + 1) * 2 > _entries.size()) grow();
+
+        // calculate the hash and find the entry
+        auto hash = nameHash(key.data(), key.size());
+        auto &entry = _entries[locate(key.data(), key.size(), hash)];
+
+        // is this a new entry?
+        if (!entry.used)
+        {
+            // fill the entry
+            entry.key = key;
+            entry.hash = hash;
+            entry.used = true;
+
+            // one more entry in use
+            _size += 1;
+        }
+
+        // store the value
+        return entry.value = std::move(value);
+    }
+
+    /**
+     *  Insert or overwrite a number of values
+     *  @param  values      the keys and values
+     */
+    void insert(std::initializer_list<std::pair<std::string, T>> values)
+    {
+        // insert all values
+        for (const auto &value : values) insert(value.first, value.second);
+    }
+
+    /**
+     *  Number of values in the table
+     *  @return size_t
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}}
@@ -17,6 +17,7 @@ namespace SmartTpl {
  *  Forward declarations
  */
 class VariantValue;
+class Value;
 
 /**
  *  Class definition
@@ -59,6 +60,18 @@ public:
      *  @return Variant
      */
     virtual VariantValue key() const = 0;
+
+    /**
+     *  Retrieve a pointer to the current member, without copying it
+     *
+     *  Iterators over containers that hold their members as Value objects
+     *  can override this method, so that a foreach loop does not have to
+     *  copy every member. The default returns nullptr, in which case the
+     *  value() method is used instead.
+     *
+     *  @return Value
+     */
+    virtual const Value *current() const { return nullptr; }
 };
 
 /**
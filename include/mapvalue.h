@@ -109,11 +109,11 @@ public:
      */
     virtual VariantValue member(size_t position) const override
     {
-        // create string from position
-        std::string key(std::to_string(position));
+        // format the position on the stack
+        char key[Number::integerSize];
 
         // pass on
-        return member(key.data(), key.size());
+        return member(key, Number::format((integer_t)position, key));
     }
 
     /**
@@ -146,6 +146,9 @@ public:
      *  feel free to return nullptr if you don't want to be able to iterate
      *  over your type
      *
+     *  The iterator refers to the map inside this object, so it should not
+     *  outlive this object, and the map should not be modified while iterating
+     *
      *  @return Newly allocated Iterator
      */
     virtual Iterator *iterator() const override;
@@ -0,0 +1,106 @@
+/**
+ *  Number.h
+ *
+ *  Conversions between numbers and text, as they are used by the values and
+ *  by the template output. The numbers are formatted into a buffer that is
+ *  supplied by the caller (or appended straight to an output string), and
+ *  parsing reports failure with a return value instead of an exception, so
+ *  none of these functions allocate or throw.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Class definition
+ */
+class Number
+{
+public:
+    /**
+     *  Size of the buffer that is needed to format an integer (this includes
+     *  the minus sign)
+     *  @var size_t
+     */
+    static constexpr size_t integerSize = 20;
+
+    /**
+     *  Size of the buffer that is needed to format a double (a double can
+     *  have more than three hundred digits before the decimal point)
+     *  @var size_t
+     */
+    static constexpr size_t doubleSize = 512;
+
+    /**
+     *  Format an integer
+     *  @param  value       the value to format
+     *  @param  buffer      buffer of at least integerSize bytes
+     *  @return size_t      number of bytes written (no null character is written)
+     */
+    static size_t format(integer_t value, char *buffer);
+
+    /**
+     *  Format a double, this gives the same output as printf("%.5f") with
+     *  the trailing zeros (and a trailing decimal point) removed
+     *  @param  value       the value to format
+     *  @param  buffer      buffer of at least doubleSize bytes
+     *  @return size_t      number of bytes written (no null character is written)
+     */
+    static size_t format(double value, char *buffer);
+
+    /**
+     *  Append a formatted integer or double to a string
+     *  @param  value       the value to format
+     *  @param  output      the string to append to
+     */
+    static void append(integer_t value, std::string &output);
+    static void append(double value, std::string &output);
+
+    /**
+     *  Append a double with a fixed number of decimals, and with custom
+     *  separators, to a string (this is what the number_format modifier does)
+     *  @param  value       the value to format
+     *  @param  decimals    number of decimals
+     *  @param  point       the decimal separator
+     *  @param  thousands   the thousands separator, or zero for no separator
+     *  @param  output      the string to append to
+     */
+    static void append(double value, int decimals, char point, char thousands, std::string &output);
+
+    /**
+     *  Convert a number to a string
+     *  @param  value       the value to convert
+     *  @return std::string
+     */
+    static std::string toString(integer_t value);
+    static std::string toString(double value);
+
+    /**
+     *  Parse an integer, just like strtoll() does this skips leading whitespace,
+     *  and ignores everything after the digits
+     *  @param  data        the text to parse
+     *  @param  size        size of the text
+     *  @param  result      the parsed value, or zero if the text could not be parsed
+     *  @return bool        false if the text has no digits or is out of range
+     */
+    static bool parse(const char *data, size_t size, integer_t &result);
+
+    /**
+     *  Parse a double, just like strtod() does this skips leading whitespace,
+     *  and ignores everything after the number
+     *  @param  data        the text to parse
+     *  @param  size        size of the text
+     *  @param  result      the parsed value, or zero if the text could not be parsed
+     *  @return bool        false if the text holds no number or is out of range
+     */
+    static bool parse(const char *data, size_t size, double &result);
+};
+
+/**
+ *  End namespace
+ */
+}
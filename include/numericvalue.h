@@ -43,7 +43,7 @@ public:
      */
     virtual std::string toString() const override
     {
-        return std::to_string(_value);
+        return Number::toString(_value);
     }
 
     /**
@@ -0,0 +1,88 @@
+/**
+ *  RegexCache.h
+ *
+ *  Process-wide cache of compiled regular expressions. Compiling a regex is
+ *  much more expensive than running it, so modifiers that get their pattern
+ *  as a parameter (or that use a fixed pattern) fetch the compiled regex
+ *  from this cache instead of compiling it on every call. The cache is
+ *  thread-safe, and holds at most capacity() regexes: the ones that were
+ *  least recently used are removed first.
+ *
+ *  This header is not included by smarttpl.h, because it depends on the
+ *  boost regex headers. Include it yourself if you want to use the cache
+ *  from your own modifiers.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Include guard, this header can be included on its own
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <boost/regex.hpp>
+#include <memory>
+#include <string>
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Class definition
+ */
+class RegexCache
+{
+public:
+    /**
+     *  The flags that are passed to the boost::regex constructor
+     */
+    using Flags = boost::regex_constants::syntax_option_type;
+
+    /**
+     *  Get a compiled regex, it is compiled and added to the cache if it
+     *  was not in it yet
+     *
+     *  The returned object stays valid as long as you hold it, even if it
+     *  is removed from the cache in the meantime.
+     *
+     *  @param  pattern     the regular expression
+     *  @param  flags       flags for compiling the regex
+     *  @return std::shared_ptr
+     *  @throws boost::regex_error  if the pattern is not valid
+     */
+    static std::shared_ptr<const boost::regex> get(const std::string &pattern, Flags flags = boost::regex_constants::normal);
+
+    /**
+     *  The max number of regexes in the cache
+     *  @return size_t
+     */
+    static size_t capacity();
+
+    /**
+     *  Change the max number of regexes in the cache, if there are more
+     *  regexes in the cache the least recently used ones are removed
+     *  @param  capacity    the new capacity
+     */
+    static void capacity(size_t capacity);
+
+    /**
+     *  Number of regexes that are currently in the cache
+     *  @return size_t
+     */
+    static size_t size();
+
+    /**
+     *  Remove all regexes from the cache
+     */
+    static void clear();
+};
+
+/**
+ *  End namespace
+ */
+}
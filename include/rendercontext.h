@@ -0,0 +1,105 @@
+/**
+ *  RenderContext.h
+ *
+ *  Object that holds the state that is needed while a template is being
+ *  processed (the output buffer, the local variables, etc). Normally, every
+ *  call to Template::process() sets up this state from scratch. If you
+ *  process many templates in a row, you can instead create a RenderContext
+ *  (for example one per thread) and pass it to Template::process(). The
+ *  buffers and containers are then cleared between the calls, and do not
+ *  have to be allocated over and over again.
+ *
+ *  A RenderContext is not thread-safe, it can only be used for one call
+ *  to Template::process() at a time.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Forward declarations
+ */
+namespace Internal {
+    class Handler;
+    class Benchmark;
+}
+
+/**
+ *  Class definition
+ */
+class RenderContext
+{
+private:
+    /**
+     *  The handler that is reused for every call
+     *  @var    Internal::Handler
+     */
+    Internal::Handler *_handler;
+
+    /**
+     *  Constructor that can allocate every temporary value on the heap
+     *  instead of in an arena, this is not part of the API, it only exists
+     *  so that the benchmarks can measure how many allocations the arena saves
+     *  @param  arena       allocate the temporary values from an arena?
+     */
+    explicit RenderContext(bool arena);
+
+    /**
+     *  The template class needs access to the handler, the benchmarks
+     *  need access to the constructor above
+     */
+    friend class Template;
+    friend class Internal::Benchmark;
+
+public:
+    /**
+     *  Constructor
+     */
+    RenderContext();
+
+    /**
+     *  Deleted copy constructor
+     *  @param  that
+     */
+    RenderContext(const RenderContext &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~RenderContext();
+
+    /**
+     *  Deleted assign operator
+     *  @param  that
+     */
+    RenderContext& operator=(const RenderContext &that) = delete;
+
+    /**
+     *  The output of the last call to Template::process()
+     *
+     *  The returned reference remains valid until the context is used again.
+     *
+     *  @return std::string
+     */
+    const std::string &output() const;
+
+    /**
+     *  Move the output of the last call to Template::process() out of the context
+     *
+     *  This saves a copy of the output, but it also means that the next call
+     *  has to allocate a new output buffer.
+     *
+     *  @return std::string
+     */
+    std::string release();
+};
+
+/**
+ *  End namespace
+ */
+}
+
@@ -0,0 +1,127 @@
+/**
+ *  Segments.h
+ *
+ *  Object that receives the output of a template as a list of segments, in
+ *  the same format as is used by writev(2). The static text of the template
+ *  is not copied: the segments for static text point directly into the
+ *  compiled template. Only the dynamic parts of the output (the variables,
+ *  and very short pieces of text) are stored in a buffer.
+ *
+ *  This is useful for big templates that are mostly static, and that are
+ *  processed over and over again (a newsletter that is sent to many
+ *  recipients for example). Just like a RenderContext, a Segments object can
+ *  be reused for many calls to Template::process().
+ *
+ *  The segments remain valid until the object is used again, or until the
+ *  template that generated them is destructed, whatever comes first.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Forward declarations
+ */
+namespace Internal {
+    class Handler;
+}
+
+/**
+ *  Class definition
+ */
+class Segments
+{
+private:
+    /**
+     *  The handler that is reused for every call
+     *  @var    Internal::Handler
+     */
+    Internal::Handler *_handler;
+
+    /**
+     *  The segments of the last call
+     *  @var    std::vector
+     */
+    std::vector<struct iovec> _segments;
+
+    /**
+     *  Total size of the output
+     *  @var    size_t
+     */
+    size_t _bytes = 0;
+
+    /**
+     *  Collect the segments from the handler, this is called by the
+     *  template once the output is complete
+     */
+    void collect();
+
+    /**
+     *  The template class needs access to the handler
+     */
+    friend class Template;
+
+public:
+    /**
+     *  Constructor
+     */
+    Segments();
+
+    /**
+     *  Deleted copy constructor
+     *  @param  that
+     */
+    Segments(const Segments &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~Segments();
+
+    /**
+     *  Deleted assign operator
+     *  @param  that
+     */
+    Segments& operator=(const Segments &that) = delete;
+
+    /**
+     *  The segments, this can be passed straight to writev(2) (although you
+     *  may have to split them up if there are more than IOV_MAX segments)
+     *  @return struct iovec
+     */
+    const struct iovec *data() const { return _segments.data(); }
+
+    /**
+     *  Number of segments
+     *  @return size_t
+     */
+    size_t size() const { return _segments.size(); }
+
+    /**
+     *  Total size of the output, in bytes
+     *  @return size_t
+     */
+    size_t bytes() const { return _bytes; }
+
+    /**
+     *  Iterate over the segments
+     *  @return std::vector<struct iovec>::const_iterator
+     */
+    std::vector<struct iovec>::const_iterator begin() const { return _segments.begin(); }
+    std::vector<struct iovec>::const_iterator end() const { return _segments.end(); }
+
+    /**
+     *  Copy the entire output into one string
+     *  @return std::string
+     */
+    std::string str() const;
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -0,0 +1,69 @@
+/**
+ *  Sink.h
+ *
+ *  Base class for objects that receive the output of a template while it
+ *  is being processed. Instead of collecting the entire output in one big
+ *  string, the output is passed to the sink in chunks, so that memory usage
+ *  stays bounded and the first bytes can be sent before processing is done.
+ *
+ *  There are a couple of implementations available:
+ *
+ *      StreamSink          writes the output to a std::ostream
+ *      FileDescriptorSink  writes the output to a file descriptor (file, pipe, socket)
+ *      CallbackSink        passes the output to a user supplied function
+ *
+ *  You can create your own derived classes if you want to send the output
+ *  somewhere else.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Class definition
+ */
+class Sink
+{
+public:
+    /**
+     *  Destructor
+     */
+    virtual ~Sink() {}
+
+    /**
+     *  Write a chunk of output
+     *
+     *  This method is called every time the internal buffer is full, and one
+     *  final time when the template was completely processed. If you throw an
+     *  exception from this method, all further output is discarded and
+     *  Template::process() throws a RunTimeError once the template is done.
+     *
+     *  @param  buffer      pointer to the output
+     *  @param  size        size of the output
+     */
+    virtual void write(const char *buffer, size_t size) = 0;
+
+    /**
+     *  The preferred size of the chunks
+     *
+     *  The template output is buffered until (at least) this many bytes are
+     *  available, and is then passed to the write() method.
+     *
+     *  @return size_t
+     */
+    virtual size_t chunksize() const
+    {
+        // by default we use the same size as the regular output buffer
+        return 4096;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
+
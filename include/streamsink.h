@@ -0,0 +1,54 @@
+/**
+ *  StreamSink.h
+ *
+ *  Sink implementation that writes the template output to a std::ostream
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Class definition
+ */
+class StreamSink : public Sink
+{
+private:
+    /**
+     *  The stream to write to
+     *  @var    std::ostream
+     */
+    std::ostream &_stream;
+
+public:
+    /**
+     *  Constructor
+     *  @param  stream      the stream to write to
+     */
+    StreamSink(std::ostream &stream) : _stream(stream) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~StreamSink() {}
+
+    /**
+     *  Write a chunk of output
+     *  @param  buffer      pointer to the output
+     *  @param  size        size of the output
+     */
+    virtual void write(const char *buffer, size_t size) override
+    {
+        // pass on to the stream
+        _stream.write(buffer, size);
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
+
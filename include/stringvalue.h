@@ -51,14 +51,10 @@ public:
      */
     virtual integer_t toNumeric() const override
     {
-        try
-        {
-            return std::stoll(_value);
-        }
-        catch (...)
-        {
-            return 0;
-        }
+        // parse the number (this gives zero if the string is not numeric)
+        integer_t result;
+        Number::parse(_value.data(), _value.size(), result);
+        return result;
     };
 
     /**
@@ -79,14 +75,19 @@ public:
      */
     virtual double toDouble() const override
     {
-        try
-        {
-            return std::stod(_value);
-        }
-        catch (...)
-        {
-            return 0.0;
-        }
+        // parse the number (this gives zero if the string is not numeric)
+        double result;
+        Number::parse(_value.data(), _value.size(), result);
+        return result;
+    }
+
+    /**
+     *  The stored string, without making a copy
+     *  @return std::string
+     */
+    const std::string &value() const
+    {
+        return _value;
     }
 };
 
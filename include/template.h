@@ -35,9 +35,12 @@ private:
      *  This is a different object depending whether you constructed the template
      *  with a shared object (*.so file) or with a template source file (*.tpl)
      *
+     *  The executor can be shared with other templates (and other threads)
+     *  when the template was loaded from a TemplateCache.
+     *
      *  @var    Executor
      */
-    Internal::Executor *_executor = nullptr;
+    std::shared_ptr<Internal::Executor> _executor;
 
     /**
      *  Contains the human readable name of the encoding that is used natively
@@ -46,8 +49,24 @@ private:
      */
     std::string _encoding = "raw";
 
+    /**
+     *  Constructor for a template that uses an executor that already exists
+     *  @param  executor           The shared executor
+     */
+    Template(const std::shared_ptr<Internal::Executor> &executor);
+
+    /**
+     *  The cache shares the executors between templates
+     */
+    friend class TemplateCache;
 
 public:
+    /**
+     *  Threshold for templates that should never be compiled, but always be interpreted
+     *  @var    size_t
+     */
+    static constexpr size_t never = size_t(-1);
+
     /**
      *  Constructor
      *  @param  source             Source of your template
@@ -56,6 +75,44 @@ public:
      */
     Template(const Source &source);
 
+    /**
+     *  Constructor that uses a directory with compiled templates
+     *
+     *  The template is compiled into a shared library (with the system
+     *  compiler) that is stored in the directory, so that it only has to be
+     *  loaded the next time the template is used, even by another process.
+     *  If the library can not be created (for example because there is no
+     *  compiler), the template is compiled in memory as usual.
+     *
+     *  @param  source             Source of your template
+     *  @param  directory          Directory with compiled templates (an empty string to not use one)
+     *
+     *  @throws CompileError       In case the template could not be compiled
+     */
+    Template(const Source &source, const std::string &directory);
+
+    /**
+     *  Constructor for a template that is compiled when it turns out to be used a lot
+     *
+     *  Compiling a template takes much more time than processing it, which
+     *  does not pay off for templates that are only processed once or twice.
+     *  This template is interpreted until it has been processed 'threshold'
+     *  times, and it is then compiled in the background, while it is still
+     *  being interpreted. If a directory is given, the template is in addition
+     *  compiled into a shared library, and that library is used as soon as
+     *  it is ready.
+     *
+     *  Pass Template::never as threshold for templates that are only used
+     *  once, like previews: these are always interpreted.
+     *
+     *  @param  source             Source of your template
+     *  @param  threshold          Number of times that the template is processed before it is compiled
+     *  @param  directory          Directory with compiled templates (an empty string to not use one)
+     *
+     *  @throws CompileError       In case the template could not be parsed
+     */
+    Template(const Source &source, size_t threshold, const std::string &directory = std::string());
+
     /**
      *  Deleted copy constructor
      *  @param  that
@@ -67,12 +124,8 @@ public:
      *  @param  that
      */
     Template(Template &&that) : 
-        _executor(that._executor),
-        _encoding(std::move(that._encoding))
-    {
-        // reset other object
-        that._executor = nullptr;
-    }
+        _executor(std::move(that._executor)),
+        _encoding(std::move(that._encoding)) {}
 
     /**
      *  Destructor
@@ -146,6 +199,111 @@ public:
         return process(Data(), _encoding);
     }
 
+    /**
+     *  Process the template, reusing the buffers of a render context
+     *
+     *  The output is stored in the context, and a reference to it is returned.
+     *  This reference remains valid until the context is used again. If you
+     *  need to keep the output longer, you can move it out of the context with
+     *  RenderContext::release().
+     *
+     *  @param  context      Context that is reused between calls
+     *  @param  data         Data source
+     *  @param  outencoding  The encoding that should be used for the output
+     *  @return std::string
+     *  @throws RunTimeError
+     */
+    const std::string &process(RenderContext &context, const Data &data, const std::string &outencoding) const;
+
+    /**
+     *  Process the template, reusing the buffers of a render context
+     *  @param  context     Context that is reused between calls
+     *  @param  data        Data source
+     *  @return std::string
+     */
+    const std::string &process(RenderContext &context, const Data &data) const
+    {
+        return process(context, data, _encoding);
+    }
+
+    /**
+     *  Process the template, and collect the output as a list of segments
+     *
+     *  The static text of the template is not copied, but referred to by the
+     *  segments. The segments remain valid until the Segments object is used
+     *  again, or until this template is destructed.
+     *
+     *  @param  segments     Object that receives the segments, and that is reused between calls
+     *  @param  data         Data source
+     *  @param  outencoding  The encoding that should be used for the output
+     *  @return Segments     The same object
+     *  @throws RunTimeError
+     */
+    const Segments &process(Segments &segments, const Data &data, const std::string &outencoding) const;
+
+    /**
+     *  Process the template, and collect the output as a list of segments
+     *  @param  segments    Object that receives the segments
+     *  @param  data        Data source
+     *  @return Segments
+     */
+    const Segments &process(Segments &segments, const Data &data) const
+    {
+        return process(segments, data, _encoding);
+    }
+
+    /**
+     *  Process the template, and stream the output to a sink
+     *
+     *  Instead of returning the output as one big string, the output is
+     *  passed to the sink in chunks while the template is being processed.
+     *  This keeps the memory usage bounded, no matter how big the output is.
+     *
+     *  Note that when a runtime error occurs, part of the output may already
+     *  have been passed to the sink.
+     *
+     *  @param  data         Data source
+     *  @param  sink         The sink that receives the output
+     *  @param  outencoding  The encoding that should be used for the output
+     *  @throws RunTimeError
+     */
+    void process(const Data &data, Sink &sink, const std::string &outencoding) const;
+
+    /**
+     *  Process the template, and stream the output to a sink
+     *  @param  data        Data source
+     *  @param  sink        The sink that receives the output
+     */
+    void process(const Data &data, Sink &sink) const
+    {
+        process(data, sink, _encoding);
+    }
+
+    /**
+     *  The output of a template that does not use personalisation data
+     *
+     *  The output of such a template is always the same, so it is generated
+     *  only once for every encoding, and shared after that (also with other
+     *  templates that were loaded from the same TemplateCache). This returns
+     *  a nullptr for templates that do use personalisation data (and for
+     *  templates that use modifiers, because these come from the data too),
+     *  these have to be processed every time.
+     *
+     *  @param  outencoding  The encoding that should be used for the output
+     *  @return std::shared_ptr
+     *  @throws RunTimeError
+     */
+    std::shared_ptr<const std::string> output(const std::string &outencoding) const;
+
+    /**
+     *  The output of a template that does not use personalisation data
+     *  @return std::shared_ptr
+     */
+    std::shared_ptr<const std::string> output() const
+    {
+        return output(_encoding);
+    }
+
     /**
      *  Used to retrieve what encoding this template is in, natively
      *  @return std::string
@@ -0,0 +1,148 @@
+/**
+ *  TemplateCache.h
+ *
+ *  Cache of compiled templates. Compiling a template takes a couple of
+ *  milliseconds, so when the same templates are loaded over and over again
+ *  (for example by the worker threads of a server), it is better to compile
+ *  them only once. The cache can be shared between threads: the templates
+ *  that it returns share the compiled code, and can all be processed at the
+ *  same time.
+ *
+ *  Templates are found by the hash of their source, so two files with the
+ *  same content share the compiled code too. Files are in addition also
+ *  remembered by name and modification time, so unchanged files do not even
+ *  have to be read. When the estimated memory usage of the compiled templates
+ *  exceeds the budget, the least recently used templates are removed from
+ *  the cache (the templates that are still in use remain valid).
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Forward declarations
+ */
+namespace Internal {
+    class ExecutorCache;
+}
+
+/**
+ *  Class definition
+ */
+class TemplateCache
+{
+private:
+    /**
+     *  The cached executors
+     *  @var    Internal::ExecutorCache
+     */
+    Internal::ExecutorCache *_cache;
+
+    /**
+     *  Lock to protect the cache
+     *  @var    std::mutex
+     */
+    mutable std::mutex _mutex;
+
+    /**
+     *  Directory with templates that are compiled into shared libraries
+     *  @var    std::string
+     */
+    std::string _directory;
+
+public:
+    /**
+     *  Constructor
+     *  @param  budget      memory budget of the cache, in bytes
+     */
+    TemplateCache(size_t budget = 64 * 1024 * 1024);
+
+    /**
+     *  Deleted copy constructor
+     *  @param  that
+     */
+    TemplateCache(const TemplateCache &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~TemplateCache();
+
+    /**
+     *  Deleted assign operator
+     *  @param  that
+     */
+    TemplateCache& operator=(const TemplateCache &that) = delete;
+
+    /**
+     *  The cache that is shared by the entire process
+     *  @return TemplateCache
+     */
+    static TemplateCache &instance();
+
+    /**
+     *  Get a template from a source, the template is compiled if it is not yet in the cache
+     *  @param  source      the template source
+     *  @return Template
+     *  @throws CompileError
+     */
+    Template get(const Source &source);
+
+    /**
+     *  Get a template from a file (a template file or a shared library)
+     *
+     *  The file is only read and compiled if it is not yet in the cache, or
+     *  if it was modified since it was loaded.
+     *
+     *  @param  filename    name of the file
+     *  @param  version     the tokenizer version
+     *  @return Template
+     *  @throws CompileError, std::runtime_error
+     */
+    Template get(const std::string &filename, size_t version = 1);
+
+    /**
+     *  Use a directory to store the compiled templates in, so that the next
+     *  process does not have to compile them again (see Template)
+     *  @param  directory   the directory, or an empty string to not use one
+     */
+    void directory(const std::string &directory);
+
+    /**
+     *  Change the memory budget
+     *  @param  bytes
+     */
+    void budget(size_t bytes);
+
+    /**
+     *  The memory budget
+     *  @return size_t
+     */
+    size_t budget() const;
+
+    /**
+     *  The estimated memory that is used by the compiled templates
+     *  @return size_t
+     */
+    size_t used() const;
+
+    /**
+     *  Number of compiled templates in the cache
+     *  @return size_t
+     */
+    size_t size() const;
+
+    /**
+     *  Remove all templates from the cache
+     */
+    void clear();
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -19,21 +19,103 @@ class VariantValue : public Value
 {
 private:
     /**
-     *  A regular Value object that we wrapped around
+     *  Strings up to this size are stored inside the variant itself
+     *  @var size_t
+     */
+    static constexpr size_t InlineSize = 22;
+
+    /**
+     *  The type of value that is stored
+     *
+     *  Scalar values and short strings are stored inline, so that they do not
+     *  need a heap allocation and an (atomic) reference counter. All other
+     *  values are held by the shared pointer.
+     */
+    enum class Type : uint8_t {
+        Shared,
+        Null,
+        Boolean,
+        Integer,
+        Double,
+        String
+    };
+
+    /**
+     *  The type of the stored value
+     *  @var Type
+     */
+    Type _type = Type::Null;
+
+    /**
+     *  Size of the inline string
+     *  @var uint8_t
+     */
+    uint8_t _size = 0;
+
+    /**
+     *  Storage for the inline values
+     */
+    union {
+        bool _boolean;
+        integer_t _integer;
+        double _double;
+        char _string[InlineSize];
+    };
+
+    /**
+     *  A regular Value object that we wrapped around (only for Type::Shared)
+     *  @var std::shared_ptr<Value>
      */
     std::shared_ptr<Value> _value;
 
+    /**
+     *  Helper methods to store a value inline
+     *  @param  value       the value to store
+     *  @param  size        size of the string
+     */
+    void store(std::nullptr_t value) { _value.reset(); _type = Type::Null; }
+    void store(bool value) { _value.reset(); _type = Type::Boolean; _boolean = value; }
+    void store(integer_t value) { _value.reset(); _type = Type::Integer; _integer = value; }
+    void store(double value) { _value.reset(); _type = Type::Double; _double = value; }
+    void store(const char *value, size_t size);
+    void store(std::string &&value);
+
+    /**
+     *  Helper method to copy the inline storage of an other variant
+     *  @param  that        the other variant
+     */
+    void copy(const VariantValue &that)
+    {
+        // copy the type and the inline data (this is trivially copyable)
+        _type = that._type;
+        _size = that._size;
+        memcpy(_string, that._string, InlineSize);
+    }
+
+    /**
+     *  Call a function with the stored value as Value object
+     *
+     *  Inline values are temporarily wrapped in their regular Value
+     *  implementation (on the stack), so that all conversions behave
+     *  exactly like the NumericValue, StringValue, etc. classes.
+     *
+     *  @param  callback    the function to call
+     *  @return mixed       return value of the callback
+     */
+    template <typename Result, typename Callback>
+    Result visit(Callback &&callback) const;
+
 public:
     /**
      *  Constructors, one for most scalar types
      */
-    VariantValue();
-    VariantValue(std::nullptr_t value);
-    VariantValue(bool value);
-    VariantValue(int16_t value);
-    VariantValue(int32_t value);
-    VariantValue(int64_t value);
-    VariantValue(double value);
+    VariantValue() { _integer = 0; }
+    VariantValue(std::nullptr_t value) : VariantValue() {}
+    VariantValue(bool value) : _type(Type::Boolean) { _integer = 0; _boolean = value; }
+    VariantValue(int16_t value) : _type(Type::Integer) { _integer = value; }
+    VariantValue(int32_t value) : _type(Type::Integer) { _integer = value; }
+    VariantValue(int64_t value) : _type(Type::Integer) { _integer = value; }
+    VariantValue(double value) : _type(Type::Double) { _double = value; }
     VariantValue(const char* value);
     VariantValue(const char* value, size_t len);
     VariantValue(std::string value);
@@ -47,7 +129,7 @@ public:
     /**
      *  Constructor to wrap around your own Value objects
      */
-    VariantValue(const std::shared_ptr<Value> &value) : _value(value) {};
+    VariantValue(const std::shared_ptr<Value> &value) : _type(value ? Type::Shared : Type::Null), _value(value) { _integer = 0; };
 
     /**
      *  Do not allow us to create this directly from a Value*!
@@ -58,8 +140,8 @@ public:
     /**
      *  Copy and move constructors
      */
-    VariantValue(const VariantValue &that) : _value(that._value) {}
-    VariantValue(VariantValue &&that) : _value(std::move(that._value)) {}
+    VariantValue(const VariantValue &that) : _value(that._value) { copy(that); }
+    VariantValue(VariantValue &&that) : _value(std::move(that._value)) { copy(that); that._type = Type::Null; }
 
     /**
      *  Destructor
@@ -71,78 +153,71 @@ public:
      *  treated as a floating point number, or as a regular integer?
      *  @return bool
      */
-    virtual bool arithmeticFloat() const override { return _value->arithmeticFloat(); }
+    virtual bool arithmeticFloat() const override;
 
     /**
      *  Assignment operators
      */
-    VariantValue& operator=(std::nullptr_t value);
-    VariantValue& operator=(bool value);
-    VariantValue& operator=(int16_t value);
-    VariantValue& operator=(int32_t value);
-    VariantValue& operator=(int64_t value);
-    VariantValue& operator=(double value);
+    VariantValue& operator=(std::nullptr_t value) { store(value); return *this; }
+    VariantValue& operator=(bool value) { store(value); return *this; }
+    VariantValue& operator=(int16_t value) { store(integer_t(value)); return *this; }
+    VariantValue& operator=(int32_t value) { store(integer_t(value)); return *this; }
+    VariantValue& operator=(int64_t value) { store(integer_t(value)); return *this; }
+    VariantValue& operator=(double value) { store(value); return *this; }
     VariantValue& operator=(const char* value);
-    VariantValue& operator=(std::string value);
+    VariantValue& operator=(std::string value) { store(std::move(value)); return *this; }
     VariantValue& operator=(const std::vector<VariantValue>& value);
     VariantValue& operator=(std::vector<VariantValue>&& value);
     VariantValue& operator=(const std::initializer_list<VariantValue>& value);
     VariantValue& operator=(const std::map<std::string, VariantValue>& value);
     VariantValue& operator=(std::map<std::string, VariantValue>&& value);
     VariantValue& operator=(const std::initializer_list<std::map<std::string, VariantValue>::value_type>& value);
-    VariantValue& operator=(const std::shared_ptr<Value> &value) { _value = value; return *this; }
-    VariantValue& operator=(const VariantValue &value) { _value = value._value; return *this; }
-    VariantValue& operator=(VariantValue &&value) { _value = std::move(value._value); value._value = nullptr; return *this; }
+    VariantValue& operator=(const std::shared_ptr<Value> &value) { _value = value; _type = value ? Type::Shared : Type::Null; return *this; }
+    VariantValue& operator=(const VariantValue &value) { _value = value._value; copy(value); return *this; }
+    VariantValue& operator=(VariantValue &&value) { _value = std::move(value._value); copy(value); value._type = Type::Null; return *this; }
 
     /**
      *  Convert the value to a string
      *  @return std::string
      */
-    virtual std::string toString() const override
-    {
-        // return the toString of the underlying Value
-        return _value->toString();
-    }
+    virtual std::string toString() const override;
+
+    /**
+     *  Get access to the buffer of a stored string, without making a copy
+     *
+     *  This only works for strings (inline strings, and wrapped StringValue
+     *  objects), for all other values false is returned and the string has
+     *  to be constructed with toString().
+     *
+     *  @param  data        filled with a pointer to the buffer
+     *  @param  size        filled with the size of the buffer
+     *  @return bool        was the value a string?
+     */
+    bool string(const char *&data, size_t &size) const;
 
     /**
      *  Convert the variable to a numeric value
      *  @return integer_t
      */
-    virtual integer_t toNumeric() const override
-    {
-        // return the toNumeric of the underlying Value
-        return _value->toNumeric();
-    }
+    virtual integer_t toNumeric() const override;
 
     /**
      *  Convert the variable to a boolean value
      *  @return bool
      */
-    virtual bool toBoolean() const override
-    {
-        // return the toBoolean of the underlying Value
-        return _value->toBoolean();
-    }
+    virtual bool toBoolean() const override;
 
     /**
      *  Convert the variable to a floating point value
      *  @return double
      */
-    virtual double toDouble() const override
-    {
-        // return the toDoubleO of the underlying Value
-        return _value->toDouble();
-    }
+    virtual double toDouble() const override;
 
     /**
      *  Get access to the amount of members this value has
      *  @return size_t
      */
-    virtual size_t memberCount() const override
-    {
-        // return the memberCount() of the underlying Value
-        return _value->memberCount();
-    }
+    virtual size_t memberCount() const override;
 
     /**
      *  Get access to a member value
@@ -152,44 +227,28 @@ public:
      *  @return Variant
      *
      */
-    virtual VariantValue member(const char *name, size_t size) const override
-    {
-        // return the member(const char*, size_t) of the underlying Value
-        return _value->member(name, size);
-    }
+    virtual VariantValue member(const char *name, size_t size) const override;
 
     /**
      *  Get access to a member at a certain position
      *  @param  position    Position of the item we want to retrieve
      *  @return Variant
      */
-    virtual VariantValue member(size_t position) const override
-    {
-        // return the member(size_t) of the underlying Value
-        return _value->member(position);
-    }
+    virtual VariantValue member(size_t position) const override;
 
     /**
      *  Get access to a member at a certain position
      *  @param  position    Position of the item we want to retrieve
      *  @return VariantValue
      */
-    virtual VariantValue member(const Value &position) const override
-    {
-        // return the member(Value) of the underlying Value
-        return _value->member(position);
-    }
+    virtual VariantValue member(const Value &position) const override;
 
     /**
      *  Use this value as index of another parent value
      *  @param  value       the value in which to look for this key
      *  @return VariantValue
      */
-    virtual VariantValue lookupIn(const Value &value) const override
-    {
-        // pass on to lookupIn method of underlying value
-        return _value->lookupIn(value);
-    }
+    virtual VariantValue lookupIn(const Value &value) const override;
 
     /**
      *  Create a new iterator that allows you to iterate over the subvalues
@@ -198,16 +257,15 @@ public:
      *
      *  @return Newly allocated Iterator
      */
-    virtual Iterator *iterator() const override
-    {
-        // return the iterator of the underlying Value
-        return _value->iterator();
-    }
+    virtual Iterator *iterator() const override;
 
     /**
      *  Equals and not equals to operators
+     *
+     *  Variants that wrap a shared value are equal when they share the same
+     *  object, inline values are equal when they hold the same value.
      */
-    bool operator==(const VariantValue &that) const { return _value == that._value; }
+    bool operator==(const VariantValue &that) const;
     bool operator!=(const VariantValue &that) const { return !(*this == that); }
 };
 
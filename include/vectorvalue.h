@@ -93,23 +93,11 @@ public:
     virtual VariantValue member(const char *name, size_t size) const override
     {
         // let's see if we can get a number out of the string
-        try
-        {
-            // create string object
-            std::string key(name, size);
-
-            // convert to integer
-            int idx = stoi(key);
+        integer_t index;
+        if (!Number::parse(name, size, index)) return nullptr;
 
-            // use integer key for lookup
-            return member(idx);
-        }
-        catch (...)
-        {
-            // no conversion possible
-            return nullptr;
-        }
-        
+        // use integer key for lookup
+        return member(index);
     }
 
     /**
@@ -156,6 +144,9 @@ public:
      *  feel free to return nullptr if you don't want to be able to iterate
      *  over your type
      *
+     *  The iterator refers to the vector inside this object, so it should not
+     *  outlive this object, and the vector should not be modified while iterating
+     *
      *  @return Newly allocated Iterator
      */
     virtual Iterator *iterator() const override;
@@ -33,8 +33,14 @@
 #include <cstring>
 #include <algorithm>
 #include <set>
+#include <unordered_set>
 #include <ctime>
 #include <vector>
+#include <functional>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <mutex>
 
 #include "smarttpl/source.h"
 #include "smarttpl/file.h"
@@ -43,6 +49,7 @@
 #include "smarttpl/iterator.h"
 
 #include "smarttpl/value.h"
+#include "smarttpl/number.h"
 #include "smarttpl/variantvalue.h"
 #include "smarttpl/nullvalue.h"
 #include "smarttpl/boolvalue.h"
@@ -58,8 +65,16 @@
 #include "smarttpl/modifier.h"
 #include "smarttpl/callback.h"
 #include "smarttpl/state.h"
+#include "smarttpl/hashtable.h"
 #include "smarttpl/data.h"
+#include "smarttpl/sink.h"
+#include "smarttpl/streamsink.h"
+#include "smarttpl/filedescriptorsink.h"
+#include "smarttpl/callbacksink.h"
+#include "smarttpl/rendercontext.h"
+#include "smarttpl/segments.h"
 #include "smarttpl/template.h"
+#include "smarttpl/templatecache.h"
 #include "smarttpl/compileerror.h"
 #include "smarttpl/runtimeerror.h"
 
@@ -0,0 +1,284 @@
+/**
+ *  Arena.h
+ *
+ *  Simple bump allocator for objects that only live as long as a template
+ *  is being processed. Objects are carved out of big memory blocks, and they
+ *  are all destructed in one go when the arena is reset. The memory blocks
+ *  themselves are kept, so that an arena that is reused (for example because
+ *  its handler is part of a RenderContext) no longer has to allocate at all.
+ *
+ *  The arena can also be constructed in heap mode, in which every object is
+ *  allocated on its own. This is only useful to measure what the arena saves.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class Arena
+{
+private:
+    /**
+     *  A single block of memory
+     */
+    struct Block
+    {
+        /**
+         *  The actual memory
+         *  @var    std::unique_ptr<char[]>
+         */
+        std::unique_ptr<char[]> data;
+
+        /**
+         *  Size of the block
+         *  @var    size_t
+         */
+        size_t size;
+
+        /**
+         *  Constructor
+         *  @param  size        size of the block
+         */
+        Block(size_t size) : data(new char[size]), size(size) {}
+    };
+
+    /**
+     *  Signature of a function that destructs an object
+     */
+    using Destructor = void(*)(void *object);
+
+    /**
+     *  All blocks that were allocated
+     *  @var    std::vector<Block>
+     */
+    std::vector<Block> _blocks;
+
+    /**
+     *  Index of the block that is in use
+     *  @var    size_t
+     */
+    size_t _current = 0;
+
+    /**
+     *  Number of bytes that are in use in the current block
+     *  @var    size_t
+     */
+    size_t _used = 0;
+
+    /**
+     *  The objects that have to be destructed when the arena is reset
+     *  @var    std::vector
+     */
+    std::vector<std::pair<void *, Destructor>> _objects;
+
+    /**
+     *  Default size of the blocks
+     *  @var    size_t
+     */
+    const size_t _blocksize;
+
+    /**
+     *  Are the objects allocated on the heap instead of in the blocks?
+     *  @var    bool
+     */
+    const bool _heap;
+
+    /**
+     *  The objects that were allocated on the heap (only used in heap mode)
+     *  @var    std::unordered_set
+     */
+    std::unordered_set<const void *> _allocated;
+
+    /**
+     *  Allocate raw memory
+     *  @param  size        number of bytes
+     *  @param  alignment   required alignment
+     *  @return void*
+     */
+    void *allocate(size_t size, size_t alignment)
+    {
+        // look for a block in which the memory fits
+        while (_current < _blocks.size())
+        {
+            // the block that we're currently using
+            auto &block = _blocks[_current];
+
+            // the aligned offset in the current block
+            size_t offset = (reinterpret_cast<uintptr_t>(block.data.get()) + _used + alignment - 1) / alignment * alignment - reinterpret_cast<uintptr_t>(block.data.get());
+
+            // does it fit?
+            if (offset + size <= block.size)
+            {
+                // remember that this memory is in use
+                _used = offset + size;
+
+                // expose the memory
+                return block.data.get() + offset;
+            }
+
+            // move on to the next block
+            _current += 1;
+            _used = 0;
+        }
+
+        // no more blocks available, we need a new one, every block is twice as
+        // big as the previous one so that the number of blocks (and thus the
+        // cost of contains()) grows only logarithmically with the memory usage
+        _blocks.emplace_back(std::max(_blocksize << std::min(_blocks.size(), size_t(12)), size + alignment));
+
+        // now it certainly fits
+        return allocate(size, alignment);
+    }
+
+public:
+    /**
+     *  A position in the arena, everything that is created after a mark
+     *  can be destructed with rewind()
+     */
+    struct Mark
+    {
+        size_t block;
+        size_t used;
+        size_t objects;
+    };
+
+    /**
+     *  Constructor
+     *  @param  heap        allocate every object on the heap instead of in the blocks
+     *  @param  blocksize   default size of the blocks
+     */
+    Arena(bool heap = false, size_t blocksize = 16384) : _blocksize(blocksize), _heap(heap) {}
+
+    /**
+     *  Deleted copy constructor
+     *  @param  that
+     */
+    Arena(const Arena &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~Arena()
+    {
+        // destruct all objects
+        reset();
+    }
+
+    /**
+     *  Construct an object in the arena
+     *
+     *  The object may not be deleted, it is destructed when the arena is reset.
+     *
+     *  @param  args        constructor arguments
+     *  @return T*
+     */
+    template <typename T, typename ...Args>
+    T *create(Args&&... args)
+    {
+        // in heap mode every object gets an allocation of its own
+        if (_heap)
+        {
+            // allocate the object
+            T *object = new T(std::forward<Args>(args)...);
+
+            // remember that it has to be deleted
+            _objects.emplace_back(object, [](void *object) { delete static_cast<T*>(object); });
+            _allocated.insert(object);
+
+            // done
+            return object;
+        }
+
+        // construct the object in arena memory
+        T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+        // remember how it should be destructed (if that is necessary at all)
+        if (!std::is_trivially_destructible<T>::value) _objects.emplace_back(object, [](void *object) { static_cast<T*>(object)->~T(); });
+
+        // done
+        return object;
+    }
+
+    /**
+     *  Does a pointer point to memory that is managed by the arena?
+     *  @param  pointer     the pointer to check
+     *  @return bool
+     */
+    bool contains(const void *pointer) const
+    {
+        // in heap mode we know all objects
+        if (_heap) return _allocated.find(pointer) != _allocated.end();
+
+        // check all the blocks
+        for (auto &block : _blocks)
+        {
+            // is the pointer inside this block?
+            if (pointer >= block.data.get() && pointer < block.data.get() + block.size) return true;
+        }
+
+        // not found
+        return false;
+    }
+
+    /**
+     *  The current position in the arena
+     *  @return Mark
+     */
+    Mark mark() const
+    {
+        return Mark{ _current, _used, _objects.size() };
+    }
+
+    /**
+     *  Call a function for every object that was created after a mark
+     *  @param  mark        the mark
+     *  @param  callback    function that is called with a pointer to each object
+     */
+    template <typename Callback>
+    void since(const Mark &mark, Callback &&callback) const
+    {
+        // pass all objects after the mark
+        for (size_t i = mark.objects; i < _objects.size(); ++i) callback(_objects[i].first);
+    }
+
+    /**
+     *  Destruct all objects that were created after a mark, and make their
+     *  memory available again
+     *  @param  mark        the mark to go back to
+     */
+    void rewind(const Mark &mark)
+    {
+        // destruct the objects in reverse order of construction
+        for (size_t i = _objects.size(); i > mark.objects; --i) _objects[i - 1].second(_objects[i - 1].first);
+
+        // in heap mode the objects no longer exist
+        if (_heap) for (size_t i = mark.objects; i < _objects.size(); ++i) _allocated.erase(_objects[i].first);
+
+        // forget about the objects, but keep the capacity
+        _objects.resize(mark.objects);
+
+        // continue allocating from the mark
+        _current = mark.block;
+        _used = mark.used;
+    }
+
+    /**
+     *  Destruct all objects, but keep the memory for reuse
+     */
+    void reset()
+    {
+        // go back to the very beginning
+        rewind(Mark{ 0, 0, 0 });
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
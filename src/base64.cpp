@@ -0,0 +1,375 @@
+/**
+ *  Base64.cpp
+ *
+ *  Implementation of the base64 codec. The AVX2 kernels are based on the
+ *  well known algorithms by Wojciech Muła: the bytes are shuffled into
+ *  place, split into 6-bit values with multiplications, and translated
+ *  from/to ascii with a couple of table lookups (pshufb). Whatever is left
+ *  (and everything on processors without AVX2) is done with plain tables.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Dependencies
+ */
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  The base64 alphabet
+ *  @var    char[]
+ */
+static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ *  Special values in the decoding table
+ */
+static const unsigned char whitespace = 64;
+static const unsigned char padding = 65;
+static const unsigned char invalid = 255;
+
+/**
+ *  Table to decode the characters
+ */
+static const struct DecodeTable
+{
+    /**
+     *  The table itself, indexed by the (unsigned) character
+     */
+    unsigned char values[256];
+
+    /**
+     *  Constructor
+     */
+    DecodeTable()
+    {
+        // all characters are invalid, except the ones that we know
+        memset(values, invalid, sizeof(values));
+        for (unsigned char i = 0; i < 64; ++i) values[(unsigned char)alphabet[i]] = i;
+        for (unsigned char c : { ' ', '\t', '\r', '\n' }) values[c] = whitespace;
+        values[(unsigned char)'='] = padding;
+    }
+} table;
+
+/**
+ *  Encode a buffer one group of three bytes at a time
+ *  @param  in          the buffer to encode
+ *  @param  size        size of the buffer
+ *  @param  out         where to write the encoded data
+ *  @return char*       end of the encoded data
+ */
+static char *encodeScalar(const unsigned char *in, size_t size, char *out)
+{
+    // encode all complete groups
+    for (; size >= 3; in += 3, size -= 3)
+    {
+        // the three bytes as one number
+        uint32_t group = (in[0] << 16) | (in[1] << 8) | in[2];
+
+        // turn it into four characters
+        *out++ = alphabet[group >> 18];
+        *out++ = alphabet[(group >> 12) & 63];
+        *out++ = alphabet[(group >> 6) & 63];
+        *out++ = alphabet[group & 63];
+    }
+
+    // are there bytes left?
+    if (size == 0) return out;
+
+    // the remaining one or two bytes, padded with zeros
+    uint32_t group = (in[0] << 16) | (size == 2 ? in[1] << 8 : 0);
+
+    // write them, and add padding characters
+    *out++ = alphabet[group >> 18];
+    *out++ = alphabet[(group >> 12) & 63];
+    *out++ = size == 2 ? alphabet[(group >> 6) & 63] : '=';
+    *out++ = '=';
+
+    // done
+    return out;
+}
+
+#if defined(__SSE2__)
+
+/**
+ *  Is AVX2 available?
+ *  @return bool
+ */
+static bool avx2()
+{
+    // this could run before the static constructors that detect the processor features
+    __builtin_cpu_init();
+
+    // check the processor
+    return __builtin_cpu_supports("avx2");
+}
+
+/**
+ *  Encode a buffer 24 bytes at a time with AVX2, this function is only
+ *  called when the processor supports AVX2
+ *  @param  in          the buffer to encode
+ *  @param  size        size of the buffer
+ *  @param  out         where to write the encoded data
+ *  @return char*       end of the encoded data
+ */
+__attribute__((target("avx2")))
+static char *encodeAvx2(const unsigned char *in, size_t size, char *out)
+{
+    // shuffle mask that puts the three bytes of every group in the right order in a 32 bit word
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+    // offsets that are added to the 6 bit values to turn them into ascii characters
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                             'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    // every iteration reads 28 bytes (of which 24 are encoded)
+    for (; size >= 28; in += 24, size -= 24, out += 32)
+    {
+        // load twelve bytes in each lane
+        __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)in)), _mm_loadu_si128((const __m128i *)(in + 12)), 1);
+
+        // put the bytes of each group in a 32 bit word
+        input = _mm256_shuffle_epi8(input, shuffle);
+
+        // split the words into four 6 bit values
+        __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        __m256i values = _mm256_or_si256(t0, t1);
+
+        // find the offset for each value: values 0..25 map to 13, 26..51 to 0, the rest to 1..12
+        __m256i index = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+        index = _mm256_or_si256(index, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values), _mm256_set1_epi8(13)));
+
+        // add the offsets, and store the characters
+        _mm256_storeu_si256((__m256i *)out, _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, index)));
+    }
+
+    // the rest is done with the tables
+    return encodeScalar(in, size, out);
+}
+
+/**
+ *  Decode a buffer 32 characters at a time with AVX2, this function is only
+ *  called when the processor supports AVX2. It stops at the first block that
+ *  contains something else than base64 characters (whitespace, padding, or
+ *  invalid characters), that block is left for the table based decoder.
+ *  @param  in          the buffer to decode
+ *  @param  size        size of the buffer
+ *  @param  out         where to write the decoded data (32 bytes are written per 24 decoded bytes)
+ *  @return size_t      number of characters that were decoded
+ */
+__attribute__((target("avx2")))
+static size_t decodeAvx2(const unsigned char *in, size_t size, unsigned char *out)
+{
+    // tables that are indexed by the low and high nibbles to check whether a character is valid
+    const __m256i lowtable = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                              0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i hightable = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                               0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+
+    // offsets to turn the characters into 6 bit values, indexed by the high nibble
+    const __m256i offsets = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    // shuffle masks to pack the 24 decoded bytes together
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+    // number of characters that were decoded
+    size_t decoded = 0;
+
+    // process blocks of 32 characters
+    for (; decoded + 32 <= size; decoded += 32, out += 24)
+    {
+        // load the block
+        __m256i input = _mm256_loadu_si256((const __m256i *)(in + decoded));
+
+        // split the characters in nibbles
+        __m256i high = _mm256_and_si256(_mm256_srli_epi32(input, 4), _mm256_set1_epi8(0x0f));
+        __m256i low = _mm256_and_si256(input, _mm256_set1_epi8(0x0f));
+
+        // a character is invalid if its nibbles have a bit in common in the tables
+        if (!_mm256_testz_si256(_mm256_shuffle_epi8(lowtable, low), _mm256_shuffle_epi8(hightable, high))) break;
+
+        // the '/' character is the only one that needs a different offset than the others with the same high nibble
+        __m256i slashes = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+        __m256i values = _mm256_add_epi8(input, _mm256_shuffle_epi8(offsets, _mm256_add_epi8(slashes, high)));
+
+        // merge the 6 bit values into 24 bit groups
+        __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+
+        // pack the groups together, and store them
+        merged = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, shuffle), permute);
+        _mm256_storeu_si256((__m256i *)out, merged);
+    }
+
+    // done
+    return decoded;
+}
+
+#endif
+
+/**
+ *  Encode a buffer
+ *  @param  in          the buffer to encode
+ *  @param  size        size of the buffer
+ *  @param  out         where to write the encoded data
+ *  @return char*       end of the encoded data
+ */
+static char *encodeBuffer(const unsigned char *in, size_t size, char *out)
+{
+#if defined(__SSE2__)
+    // checking the processor features only has to be done once
+    static const bool vectorized = avx2();
+
+    // use the fastest implementation
+    return vectorized ? encodeAvx2(in, size, out) : encodeScalar(in, size, out);
+#else
+    // no vector instructions available
+    return encodeScalar(in, size, out);
+#endif
+}
+
+/**
+ *  Encode a buffer and append the encoded data to an output string
+ *  @param  data        the buffer to encode
+ *  @param  size        size of the buffer
+ *  @param  output      the string to which the encoded data is appended
+ *  @param  line        max length of a line, or zero for no line breaks
+ */
+void Base64::encode(const char *data, size_t size, std::string &output, size_t line)
+{
+    // the input as unsigned characters
+    auto *in = (const unsigned char *)data;
+
+    // number of characters on a line (rounded down to complete groups), and the bytes that they hold
+    line = line == 0 ? 0 : std::max(line / 4 * 4, size_t(4));
+    size_t bytes = line == 0 ? size : line / 4 * 3;
+
+    // the size of the encoded data, and the number of line breaks
+    size_t encoded = (size + 2) / 3 * 4;
+    size_t breaks = line == 0 || encoded == 0 ? 0 : (encoded - 1) / line;
+
+    // make room in the output, we write directly into it
+    size_t start = output.size();
+    output.resize(start + encoded + breaks * 2);
+    char *out = &output[start];
+
+    // encode the lines
+    while (size > bytes)
+    {
+        // encode a line, and add the line break
+        out = encodeBuffer(in, bytes, out);
+        *out++ = '\r';
+        *out++ = '\n';
+
+        // proceed with the next line
+        in += bytes;
+        size -= bytes;
+    }
+
+    // the last line
+    encodeBuffer(in, size, out);
+}
+
+/**
+ *  Decode a buffer and append the decoded data to an output string
+ *  @param  data        the buffer to decode
+ *  @param  size        size of the buffer
+ *  @param  output      the string to which the decoded data is appended
+ *  @return bool        false if the buffer contains invalid characters
+ */
+bool Base64::decode(const char *data, size_t size, std::string &output)
+{
+#if defined(__SSE2__)
+    // checking the processor features only has to be done once
+    static const bool vectorized = avx2();
+#endif
+
+    // the input as unsigned characters
+    auto *in = (const unsigned char *)data;
+
+    // make room in the output, we write directly into it (the vectorized
+    // decoder writes 32 bytes for every 24 bytes that it decodes)
+    size_t start = output.size();
+    output.resize(start + size / 4 * 3 + 32);
+    auto *out = (unsigned char *)&output[start];
+
+    // the 6 bit values of a group that is not yet complete
+    uint32_t group = 0;
+    size_t count = 0;
+
+    // was the input valid?
+    bool valid = true;
+
+    // process the input
+    for (size_t i = 0; i < size; )
+    {
+#if defined(__SSE2__)
+        // complete blocks can be decoded in one go
+        if (vectorized && count == 0 && size - i >= 32)
+        {
+            // decode as many blocks as possible
+            size_t decoded = decodeAvx2(in + i, size - i, out);
+
+            // skip over them
+            i += decoded;
+            out += decoded / 4 * 3;
+
+            // are we done?
+            if (i == size) break;
+        }
+#endif
+
+        // look up the next character
+        unsigned char value = table.values[in[i++]];
+
+        // whitespace is skipped
+        if (value == whitespace) continue;
+
+        // padding marks the end of the data
+        if (value == padding) break;
+
+        // invalid characters end the data too
+        if (value == invalid) { valid = false; break; }
+
+        // add the value to the group
+        group = (group << 6) | value;
+
+        // is the group complete?
+        if (++count < 4) continue;
+
+        // write the bytes
+        *out++ = group >> 16;
+        *out++ = group >> 8;
+        *out++ = group;
+
+        // start a new group
+        group = count = 0;
+    }
+
+    // write the bytes of an incomplete group (a single character does not hold a complete byte)
+    if (count == 2) *out++ = group >> 4;
+    if (count == 3) { *out++ = group >> 10; *out++ = group >> 2; }
+
+    // remove the bytes that were not used
+    output.resize((char *)out - output.data());
+
+    // done
+    return valid;
+}
+
+/**
+ *  End namespace
+ */
+}}
@@ -0,0 +1,55 @@
+/**
+ *  Base64.h
+ *
+ *  Base64 codec that encodes into and decodes into an output buffer. Big
+ *  buffers (images and attachments that are embedded in mime messages)
+ *  are processed 24 bytes at a time with AVX2 if the processor supports
+ *  it, the rest is done with lookup tables.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class Base64
+{
+public:
+    /**
+     *  Encode a buffer and append the encoded data to an output string
+     *
+     *  If a line length is given, a "\r\n" is inserted after every line (as is
+     *  required for mime messages, that normally use lines of 76 characters).
+     *  The line length is rounded down to a multiple of four.
+     *
+     *  @param  data        the buffer to encode
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the encoded data is appended
+     *  @param  line        max length of a line, or zero for no line breaks
+     */
+    static void encode(const char *data, size_t size, std::string &output, size_t line = 0);
+
+    /**
+     *  Decode a buffer and append the decoded data to an output string
+     *
+     *  Whitespace (like the line breaks of mime messages) is skipped, and
+     *  decoding stops at the first padding character.
+     *
+     *  @param  data        the buffer to decode
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the decoded data is appended
+     *  @return bool        false if the buffer contains invalid characters, the
+     *                      data before the invalid character is still appended
+     */
+    static bool decode(const char *data, size_t size, std::string &output);
+};
+
+/**
+ *  End namespace
+ */
+}}
@@ -4,7 +4,7 @@
  *  Built-in "|base64_decode" modifier
  *
  *  @author Toon Schoenmakers <toon.schoenmakers@copernica.com>
- *  @copyright 2014 Copernica BV
+ *  @copyright 2014 - 2019 Copernica BV
  */
 
 /**
@@ -31,14 +31,15 @@ public:
      */
     VariantValue modify(const Value &input, const SmartTpl::Parameters &params) override
     {
-        // Get the base64 encoder
-        const Escaper *escaper = Escaper::get("base64");
-
         // Turn our input into a string
-        std::string output(input.toString());
+        std::string str(input.toString());
+
+        // decode it (line breaks are skipped)
+        std::string output;
+        Base64::decode(str.data(), str.size(), output);
 
-        // Call decode and return the output
-        return escaper->decode(output);
+        // return the output
+        return output;
     }
 };
 
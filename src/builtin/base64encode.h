@@ -1,10 +1,11 @@
 /**
  *  Base64encode.h
  *
- *  Built-in "|base64_encode" modifier
+ *  Built-in "|base64_encode" modifier, an optional parameter sets the length
+ *  of the lines (for example "|base64_encode:76" for mime messages)
  *
  *  @author Toon Schoenmakers <toon.schoenmakers@copernica.com>
- *  @copyright 2014 Copernica BV
+ *  @copyright 2014 - 2019 Copernica BV
  */
 
 /**
@@ -31,14 +32,18 @@ public:
      */
     VariantValue modify(const Value &input, const SmartTpl::Parameters &params) override
     {
-        // Get the base64 encoder
-        const Escaper *escaper = Escaper::get("base64");
+        // the optional line length
+        integer_t line = params.size() >= 1 ? params[0].toInteger() : 0;
 
         // Turn our input into a string
-        std::string output(input.toString());
+        std::string str(input.toString());
 
-        // Call encode and return the output
-        return escaper->encode(output);
+        // encode it
+        std::string output;
+        Base64::encode(str.data(), str.size(), output, line > 0 ? line : 0);
+
+        // return the output
+        return output;
     }
 };
 
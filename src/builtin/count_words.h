@@ -34,19 +34,20 @@ public:
         // Let's just convert our input to a C string
         std::string str(input.toString());
 
-        // Split our input by whitespaces, newlines, etc
-        boost::regex rgx("\\s+");
-        boost::sregex_token_iterator iter(str.begin(), str.end(), rgx, -1);
+        // Split our input by whitespaces, newlines, etc (the regexes are fetched
+        // from the cache only once, we keep them for the lifetime of the process)
+        static const auto rgx = RegexCache::get("\\s+");
+        boost::sregex_token_iterator iter(str.begin(), str.end(), *rgx, -1);
 
         // Init our output value
         integer_t output = 0;
 
         // Count matches that contain alphanumerics
-        boost::regex word("[a-zA-Z0-9\\x80-\\xff]");
+        static const auto word = RegexCache::get("[a-zA-Z0-9\\x80-\\xff]");
         boost::sregex_token_iterator end;
         for (; iter != end; ++iter)
         {
-            if (boost::regex_search(iter->str(), word)) ++output;
+            if (boost::regex_search(iter->first, iter->second, *word)) ++output;
         }
 
         // Return the output
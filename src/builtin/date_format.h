@@ -13,6 +13,7 @@
  */
 #include <ctime>
 #include "parsedtime.h"
+#include "datecache.h"
 
 /**
  *  Set up namespace
@@ -32,8 +33,15 @@ private:
      *  @return VariantValue
      *  @throws bool
      */
-    static VariantValue process(time_t timestamp, const char *format)
+    static VariantValue process(time_t timestamp, const std::string &format)
     {
+        // the cache of this thread
+        auto &cache = DateCache::instance();
+
+        // perhaps this timestamp was formatted before
+        auto *output = cache.find(timestamp, format);
+        if (output) return VariantValue(*output);
+
         // structure in which the time will be loaded
         struct tm timeinfo;
 
@@ -47,13 +55,13 @@ private:
         char buffer[256];
         
         // write the time into the buffer
-        size_t size = strftime(buffer, sizeof(buffer), format, &timeinfo);
+        size_t size = strftime(buffer, sizeof(buffer), format.c_str(), &timeinfo);
         
         // return the original timestamp
         if (size == 0) throw false;
         
-        // expose the buffer
-        return VariantValue(buffer, size);
+        // remember the output, and expose it
+        return VariantValue(cache.store(timestamp, format, buffer, size));
     }
 
     /**
@@ -65,14 +73,14 @@ private:
      */
     static VariantValue process(time_t timestamp, const SmartTpl::Parameters &params)
     {
+        // the default format
+        static const std::string defaultFormat("%b %e, %Y");
+
         // use default format if nothing was specified
-        if (params.size() == 0) return process(timestamp, "%b %e, %Y");
+        if (params.size() == 0) return process(timestamp, defaultFormat);
         
-        // get the format supplied by the user as string
-        std::string format = params[0].toString();
-        
-        // use this format
-        return process(timestamp, format.c_str());
+        // use the format supplied by the user
+        return process(timestamp, params[0].toString());
     }
 
     /**
@@ -83,16 +91,33 @@ private:
      *  @return VariantValue
      *  @throws false
      */
-    static VariantValue process(const char *datetime, const SmartTpl::Parameters &params)
+    static VariantValue process(const std::string &datetime, const SmartTpl::Parameters &params)
     {
-        // parse the time
-        ParsedTime parsed(datetime);
+        // the cache of this thread
+        auto &cache = DateCache::instance();
+
+        // the parsed time
+        time_t timestamp;
+        bool valid;
+
+        // perhaps the same string was parsed before
+        if (!cache.find(datetime, timestamp, valid))
+        {
+            // parse the time
+            ParsedTime parsed(datetime.data(), datetime.size());
+            timestamp = parsed;
+            valid = parsed;
+
+            // remember the result, unless it depends on the current time (invalid
+            // input stays invalid, so that is remembered too)
+            if (parsed.absolute() || !valid) cache.store(datetime, timestamp, valid);
+        }
 
         // If parsing was unsuccessful, throw so that the original string is kept
-        if (!parsed) throw false;
+        if (!valid) throw false;
         
-        // was this a success? if not we use the current time
-        return process(parsed, params);
+        // use the parsed time
+        return process(timestamp, params);
     }
 
     
@@ -126,7 +151,7 @@ public:
                 if (isdigit(value[i])) continue;
                 
                 // we saw a non-digit character, so we have to parse the date that is given as input
-                return process(value.c_str(), params);
+                return process(value, params);
             }
             
             // value only contains numers, so we can treat it as timestamp
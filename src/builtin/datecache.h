@@ -0,0 +1,223 @@
+/**
+ *  DateCache.h
+ *
+ *  Small per-thread memo for the date_format modifier. Templates often format
+ *  the same few dates over and over again, so we remember the timestamps of
+ *  the strings that were recently parsed, and the output of the timestamps
+ *  that were recently formatted. Both tables are direct-mapped: an entry is
+ *  simply overwritten when another input ends up in the same slot.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class DateCache
+{
+private:
+    /**
+     *  Number of slots in each table
+     *  @var size_t
+     */
+    static constexpr size_t slots = 64;
+
+    /**
+     *  A string that was parsed
+     */
+    struct Parsed
+    {
+        /**
+         *  Is the slot in use?
+         *  @var bool
+         */
+        bool used = false;
+
+        /**
+         *  The input string
+         *  @var std::string
+         */
+        std::string input;
+
+        /**
+         *  Could the string be parsed?
+         *  @var bool
+         */
+        bool valid = false;
+
+        /**
+         *  The parsed timestamp
+         *  @var time_t
+         */
+        time_t timestamp = 0;
+    };
+
+    /**
+     *  A timestamp that was formatted
+     */
+    struct Formatted
+    {
+        /**
+         *  Is the slot in use?
+         *  @var bool
+         */
+        bool used = false;
+
+        /**
+         *  The timestamp
+         *  @var time_t
+         */
+        time_t timestamp = 0;
+
+        /**
+         *  The format that was used
+         *  @var std::string
+         */
+        std::string format;
+
+        /**
+         *  The formatted output
+         *  @var std::string
+         */
+        std::string output;
+    };
+
+    /**
+     *  The tables
+     *  @var array
+     */
+    Parsed _parsed[slots];
+    Formatted _formatted[slots];
+
+    /**
+     *  Find the slot for a formatted timestamp
+     *  @param  timestamp
+     *  @param  format
+     *  @return Formatted
+     */
+    Formatted &slot(time_t timestamp, const std::string &format)
+    {
+        // mix the timestamp into the hash of the format
+        auto hash = nameHash(format.data(), format.size()) ^ ((uint64_t)timestamp * 0x9E3779B97F4A7C15ull);
+
+        // use the high bits, because these are the best mixed
+        return _formatted[(hash >> 32) % slots];
+    }
+
+    /**
+     *  Find the slot for a parsed string
+     *  @param  input
+     *  @return Parsed
+     */
+    Parsed &slot(const std::string &input)
+    {
+        return _parsed[nameHash(input.data(), input.size()) % slots];
+    }
+
+public:
+    /**
+     *  The cache of the current thread
+     *  @return DateCache
+     */
+    static DateCache &instance()
+    {
+        // every thread has its own cache, so no locking is needed
+        static thread_local DateCache cache;
+
+        // expose it
+        return cache;
+    }
+
+    /**
+     *  Look up a string that was parsed before
+     *  @param  input       the string to look up
+     *  @param  timestamp   will be filled with the parsed timestamp
+     *  @param  valid       will be filled with whether the string could be parsed
+     *  @return bool        was the string found?
+     */
+    bool find(const std::string &input, time_t &timestamp, bool &valid)
+    {
+        // find the slot
+        auto &parsed = slot(input);
+
+        // check if it holds this input
+        if (!parsed.used || parsed.input != input) return false;
+
+        // expose the result
+        timestamp = parsed.timestamp;
+        valid = parsed.valid;
+
+        // found
+        return true;
+    }
+
+    /**
+     *  Remember a string that was parsed, only do this for strings that give
+     *  the same result at any moment (so not for relative dates like "tomorrow")
+     *  @param  input       the string that was parsed
+     *  @param  timestamp   the parsed timestamp
+     *  @param  valid       could the string be parsed?
+     */
+    void store(const std::string &input, time_t timestamp, bool valid)
+    {
+        // find the slot
+        auto &parsed = slot(input);
+
+        // overwrite it (assigning the string reuses the memory that was already allocated)
+        parsed.used = true;
+        parsed.input.assign(input);
+        parsed.timestamp = timestamp;
+        parsed.valid = valid;
+    }
+
+    /**
+     *  Look up a timestamp that was formatted before
+     *  @param  timestamp   the timestamp
+     *  @param  format      the format
+     *  @return std::string the formatted output, or nullptr if it was not found
+     */
+    const std::string *find(time_t timestamp, const std::string &format)
+    {
+        // find the slot
+        auto &formatted = slot(timestamp, format);
+
+        // check if it holds this timestamp and format
+        if (!formatted.used || formatted.timestamp != timestamp || formatted.format != format) return nullptr;
+
+        // expose the output
+        return &formatted.output;
+    }
+
+    /**
+     *  Remember a formatted timestamp
+     *  @param  timestamp   the timestamp
+     *  @param  format      the format
+     *  @param  data        the formatted output
+     *  @param  size        size of the output
+     *  @return std::string the stored output
+     */
+    const std::string &store(time_t timestamp, const std::string &format, const char *data, size_t size)
+    {
+        // find the slot
+        auto &formatted = slot(timestamp, format);
+
+        // overwrite it
+        formatted.used = true;
+        formatted.timestamp = timestamp;
+        formatted.format.assign(format);
+        formatted.output.assign(data, size);
+
+        // expose the output
+        return formatted.output;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
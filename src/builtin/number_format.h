@@ -7,11 +7,6 @@
  *  @copyright      2019 - 2020 Copernica BV
  */
 
-/**
- *  Dependencies
- */
-#include <locale>
-
 /**
  *  Namespace
  */
@@ -22,25 +17,6 @@ namespace SmartTpl { namespace Internal {
  */
 class NumberFormatModifier : public Modifier
 {
-private:
-    /**
-     *  Struct that works with the std::numpunct facet and can be
-     *  constructed with a char for the decimal and thousands separators 
-     */
-    struct formatter : std::numpunct<char>
-    {
-        // chars for the separators
-        char decimal; char thousand;
-
-        // constructor
-        formatter(char decimal, char thousand) : decimal(decimal), thousand(thousand) {}
-
-        // build in functions for separator formatting
-        char do_thousands_sep()   const { return thousand; } // thousands separator
-        std::string do_grouping() const { return (int) thousand == 0 ? "" : "\3"; } // separate every 3 digits, if we have a separator
-        char do_decimal_point()   const { return decimal; }  // decimal separator
-    };
-
 public:
     /**
      *  Destructor
@@ -84,21 +60,12 @@ public:
             if (param.size() > 0) thousand_separator = param[0]; 
         }
 
-        // create stringstream to store formatted number
-        std::stringstream stream;
-
-        // create custom locale for our formatting options
-        std::locale formatting_locale(stream.getloc(), new NumberFormatModifier::formatter(decimal_separator, thousand_separator));
-
-        // set formatting options
-        stream.precision(decimals);
-        stream.imbue(formatting_locale);
-
-        // stream the value (never in scientific format)
-        stream << std::fixed << input.toDouble();
+        // format the value (never in scientific format)
+        std::string result;
+        Number::append(input.toDouble(), decimals, decimal_separator, thousand_separator, result);
 
         // create object
-        return VariantValue(stream.str());
+        return VariantValue(std::move(result));
     }
 };
 
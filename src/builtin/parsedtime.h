@@ -59,6 +59,20 @@ private:
             timelib_tzinfo_dtor(_info);
         }
 
+        /**
+         *  The utc timezone, it is parsed only once and shared by all threads
+         *  (timelib only reads from it)
+         *  @return Timezone
+         */
+        static const Timezone &utc()
+        {
+            // constructed on first use
+            static const Timezone timezone;
+
+            // expose it
+            return timezone;
+        }
+
         /**
          *  Get the internal representation
          *  @return timelib_tzinfo *
@@ -84,6 +98,12 @@ private:
      */
     timelib_time *_time = nullptr;
 
+    /**
+     *  Does the parsed time not depend on the current time?
+     *  @var bool
+     */
+    bool _absolute = false;
+
     /**
      *  Get the internal representation
      *  @return timelib_time *
@@ -119,6 +139,10 @@ private:
     ParsedTime(const Timezone &timezone, const char *input, size_t size) :
         _time(timelib_strtotime((char *)input, size, &_errors, timelib_builtin_db(), timelib_parse_tzfile))
     {
+        // a full date without relative parts (like "+1 day" or "monday") gives the same result
+        // at any moment (a date without a time means midnight), this is checked before the holes are filled
+        _absolute = _time->have_date && !_time->have_relative && _time->y != TIMELIB_UNSET && _time->m != TIMELIB_UNSET && _time->d != TIMELIB_UNSET;
+
         // we also ask for the current time
         ParsedTime current(timezone);
         
@@ -138,7 +162,7 @@ public:
      *  @param  size            size of the input string
      */
     ParsedTime(const char *input, size_t size) : 
-        ParsedTime(Timezone{}, input, size) {}
+        ParsedTime(Timezone::utc(), input, size) {}
         
     /**
      *  Constructor
@@ -196,6 +220,16 @@ public:
         return _errors->warning_count > 0 || _errors->error_count > 0;
     }
     
+    /**
+     *  Does the parsed time not depend on the current time? This is true for
+     *  absolute dates, and false for relative ones like "tomorrow" or "+1 day"
+     *  @return bool
+     */
+    bool absolute() const
+    {
+        return _absolute;
+    }
+
     /**
      *  Cast to a timestamp 
      *  @return time_t
@@ -35,8 +35,8 @@ public:
         {
             try
             {
-                // initialize our settings based on the provided parameters
-                boost::regex regex(params[0].toString());
+                // get the compiled regex, so that it does not have to be compiled over and over again
+                auto regex = RegexCache::get(params[0].toString());
                 std::string replace_text(params[1].toString());
 
                 // initialize our input string
@@ -45,7 +45,7 @@ public:
                 // Do the actual regex replace into stream
                 std::ostringstream stream;
                 boost::regex_replace(std::ostream_iterator<char>(stream)
-                                    ,input_str.begin(), input_str.end(), regex, replace_text);
+                                    ,input_str.begin(), input_str.end(), *regex, replace_text);
 
                 // Turn stream into a string and return it
                 return stream.str();
@@ -66,9 +66,11 @@ public:
                 // As we are not allowed to break words apply some regex magic
                 // just like smarty does
                 // https://code.google.com/p/smarty-php/source/browse/branches/Smarty2Dev/libs/plugins/modifier.truncate.php
+                // (the regex is compiled only once, and shared by all calls)
+                static const auto regex = RegexCache::get("\\s+?(\\S+)?$");
                 output = output.substr(0, length + 1);
                 std::ostringstream stream;
-                boost::regex_replace(std::ostream_iterator<char>(stream), output.begin(), output.end(), boost::regex("\\s+?(\\S+)?$"), "");
+                boost::regex_replace(std::ostream_iterator<char>(stream), output.begin(), output.end(), *regex, "");
                 output = stream.str();
             }
 
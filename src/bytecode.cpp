@@ -247,6 +247,45 @@ void Bytecode::output(const Filter *filter)
     _callbacks.output(_userdata, var, filter->escape() ? _true : _false);
 }
 
+/**
+ *  Generate the code to forget the cached output of a loop invariant expression
+ *  @param  slot                the cache slot
+ *  @param  root                the variable that the output depends on (may be a nullptr)
+ */
+void Bytecode::cacheReset(size_t slot, const Variable *root)
+{
+    // the slot number and the variable (a null pointer if there is none)
+    auto index = _function.new_constant(slot, jit_type_sys_ulonglong);
+    auto variable = root ? pointer(root) : _function.new_constant((void *)nullptr, jit_type_void_ptr);
+
+    // reset the cache
+    _callbacks.cache_reset(_userdata, index, variable);
+}
+
+/**
+ *  Generate the code to output a loop invariant variable
+ *  @param  slot                the cache slot
+ *  @param  variable            the variable (or filter) to output
+ *  @param  escape              should the output be escaped?
+ */
+void Bytecode::cachedOutput(size_t slot, const Variable *variable, bool escape)
+{
+    // the slot number
+    auto index = _function.new_constant(slot, jit_type_sys_ulonglong);
+
+    // label to jump to when the output was written from the cache
+    jit_label label_done = _function.new_label();
+
+    // write the cached output if there is any, and skip the evaluation in that case
+    _function.insn_branch_if(_callbacks.output_cached(_userdata, index), label_done);
+
+    // evaluate the variable, and write and remember its output
+    _callbacks.output_store(_userdata, index, pointer(variable), escape ? _true : _false);
+
+    // this is where we continue
+    _function.insn_label(label_done);
+}
+
 /**
  *  Generate the code to write an expression as a string
  *  @param  expression          the expression to write as a string
@@ -410,12 +449,11 @@ void Bytecode::varPointer(const Variable *parent, const Expression *expression)
  */
 void Bytecode::varPointer(const std::string &name)
 {
-    // we need a constant of the name, and the name size
-    jit_value namevalue = _function.new_constant((void *)name.data(), jit_type_void_ptr);
-    jit_value namesize = _function.new_constant(name.size(), jit_type_sys_ulonglong);
+    // every name has its own slot, so we only need a constant of the slot index
+    jit_value index = _function.new_constant(_slots.add(name), jit_type_sys_ulonglong);
 
     // push the variable on the stack
-    _stack.push(_callbacks.variable(_userdata, namevalue, namesize));
+    _stack.push(_callbacks.variable_slot(_userdata, index));
 }
 
 /**
@@ -1002,18 +1040,28 @@ void Bytecode::lesserEquals(const Expression *left, const Expression *right)
  */
 void Bytecode::regex(const Expression *left, const Expression *right)
 {
-    // generate the code to turn the expression on the right hand size into a string (this pushes two instructions to the stack)
-    right->toString(this);
-    
-    // pop the last two elements from the stack (the string representation of the expression plus its size)
-    jit_value expressionsize = pop();
-    jit_value expression = pop();
+    // the compiled regex for a literal pattern
+    const boost::regex *compiled = literalRegex(right);
+
+    // if the pattern could be compiled in advance we only have to pass it to the match function
+    jit_value handle = compiled ? _function.new_constant((void *)compiled, jit_type_void_ptr) : jit_value();
+
+    // otherwise it has to be compiled at runtime
+    if (!compiled)
+    {
+        // generate the code to turn the expression on the right hand size into a string (this pushes two instructions to the stack)
+        right->toString(this);
 
-    // now we are going to call the function to turn this into an expression
-    jit_value handle = _callbacks.regex_compile(_userdata, expression, expressionsize);
+        // pop the last two elements from the stack (the string representation of the expression plus its size)
+        jit_value expressionsize = pop();
+        jit_value expression = pop();
 
-    // we insert a jump to go to the error handler if the regex compilation fails
-    _function.insn_branch_if_not(handle, _invalid_regex.label());
+        // now we are going to call the function to turn this into an expression
+        handle = _callbacks.regex_compile(_userdata, expression, expressionsize);
+
+        // we insert a jump to go to the error handler if the regex compilation fails
+        _function.insn_branch_if_not(handle, _invalid_regex.label());
+    }
 
     // right hand side indeed contains a valid regex, now create the code that turns the left hand size in a string
     left->toString(this);
@@ -1025,13 +1073,47 @@ void Bytecode::regex(const Expression *left, const Expression *right)
     // call the regex match function and push the result to the stack
     jit_value result = _callbacks.regex_match(_userdata, handle, message, messagesize);
 
-    // and finally we call a method to destruct regex resources
-    _callbacks.regex_release(_userdata, handle);
+    // and finally we call a method to destruct regex resources (a precompiled regex is owned by us)
+    if (!compiled) _callbacks.regex_release(_userdata, handle);
     
     // push the result to the stack
     _stack.emplace(result != _false);
 }
 
+/**
+ *  Get the precompiled regular expression for a pattern
+ *  @param  pattern         expression holding the pattern
+ *  @return boost::regex    the compiled regex, or nullptr if the pattern is not a valid literal
+ */
+const boost::regex *Bytecode::literalRegex(const Expression *pattern)
+{
+    // only literal strings can be compiled in advance
+    auto *literal = dynamic_cast<const LiteralString *>(pattern);
+    if (!literal) return nullptr;
+
+    // perhaps the same pattern was already compiled
+    auto iter = _regexes.find(literal->value());
+    if (iter != _regexes.end()) return iter->second.get();
+
+    // prevent exceptions
+    try
+    {
+        // compile the pattern
+        auto *compiled = new boost::regex(literal->value());
+
+        // we own it from now on
+        _regexes[literal->value()].reset(compiled);
+
+        // expose it
+        return compiled;
+    }
+    catch (const std::runtime_error &error)
+    {
+        // invalid patterns are reported when the template is processed
+        return nullptr;
+    }
+}
+
 /**
  *  Boolean operator
  *  @param  left
@@ -1078,17 +1160,11 @@ void Bytecode::modifiers(const Modifiers *modifiers, const Variable *variable)
     // loop through all the modifiers
     for (const auto &modifier : *modifiers)
     {
-        // Push the token of the modifier (so the name of it) to the stack
-        stringValue(modifier.get()->token());
-
-        // the stack currently contains { size, buffer, variable }
-
-        // pop the buffer and size from the stack (in reverse order) to get the modifier name
-        auto size = pop();
-        auto buffer = pop();
+        // every modifier name has its own slot, which is resolved once before the template runs
+        auto index = _function.new_constant(_modifiers.add(modifier->token()), jit_type_sys_ulonglong);
 
         // call the native function to save the modifier to the variable on the stack
-        _stack.push(_callbacks.modifier(_userdata, buffer, size));
+        _stack.push(_callbacks.modifier_slot(_userdata, index));
 
         // the stack currently contains { modifier, variable }
 
@@ -1247,6 +1323,10 @@ void Bytecode::foreach(const Variable *variable, const std::string &key, const s
     // if the output of the callback is 0 (false) we jump to label_after_while
     _function.insn_branch_if_not(valid, label_after_while);
 
+    // every iteration gets its own value scope, so that the temporary values
+    // of an iteration are destructed before the next iteration starts
+    _callbacks.enter_scope(_userdata);
+
     // do we have a key?
     if (!key.empty())
     {
@@ -1280,6 +1360,9 @@ void Bytecode::foreach(const Variable *variable, const std::string &key, const s
     // generate the actual statements
     statements->generate(this);
 
+    // destruct the temporaries of this iteration
+    _callbacks.leave_scope(_userdata);
+
     // proceed with iterator
     _callbacks.iterator_next(_userdata, iterator);
 
@@ -1339,6 +1422,9 @@ void Bytecode::assign(const std::string &key, const Expression *expression)
  */
 void Bytecode::process(Handler &handler)
 {
+    // bind the variables and modifiers to the data
+    handler.bind(_slots, _modifiers);
+
     // do we have a C function?
     if (_closure)
     {
@@ -92,6 +92,20 @@ private:
      *  @var    std::stack
      */
     std::stack<jit_value> _stack;
+
+    /**
+     *  The slot indices of the variables and modifiers that are used in the template
+     *  @var    Slots
+     */
+    Slots _slots;
+    Slots _modifiers;
+
+    /**
+     *  Regular expressions with a literal pattern, these are compiled once
+     *  when the template is compiled, and not every time they are evaluated
+     *  @var    std::map
+     */
+    std::map<std::string, std::unique_ptr<boost::regex>> _regexes;
     
     /**
      *  Internal method to generate the code for an error-label
@@ -99,6 +113,13 @@ private:
      */
     void add(ErrorLabel &label);
 
+    /**
+     *  Helper method to get the precompiled regex for a literal pattern
+     *  @param  pattern
+     *  @return boost::regex
+     */
+    const boost::regex *literalRegex(const Expression *pattern);
+
     /**
      *  Helper method to pop a value from the stack
      *  @return jit_value
@@ -158,6 +179,21 @@ private:
      */
     virtual void output(const Filter *filter) override;
 
+    /**
+     *  Generate the code to forget the cached output of a loop invariant expression
+     *  @param  slot                the cache slot
+     *  @param  root                the variable that the output depends on (may be a nullptr)
+     */
+    virtual void cacheReset(size_t slot, const Variable *root) override;
+
+    /**
+     *  Generate the code to output a loop invariant variable
+     *  @param  slot                the cache slot
+     *  @param  variable            the variable (or filter) to output
+     *  @param  escape              should the output be escaped?
+     */
+    virtual void cachedOutput(size_t slot, const Variable *variable, bool escape) override;
+
     /**
      *  Generate the code to write an expression as a string
      *  @param  expression          the expression to write as a string
@@ -328,6 +364,16 @@ public:
         return _tree.personalized();
     }
 
+    /**
+     *  Is the output of the template always the same?
+     *  @return bool
+     */
+    bool constant() const override
+    {
+        // this is the case without variables and modifiers
+        return !_tree.personalized() && _modifiers.size() == 0;
+    }
+
     /**
      *  Compile the template into C code
      *  @return std::string
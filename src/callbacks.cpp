@@ -21,6 +21,9 @@ SignatureCallback Callbacks::_output({ jit_type_void_ptr, jit_type_void_ptr, jit
 SignatureCallback Callbacks::_output_integer({ jit_type_void_ptr, jit_type_sys_longlong });
 SignatureCallback Callbacks::_output_boolean({ jit_type_void_ptr, jit_type_sys_longlong });
 SignatureCallback Callbacks::_output_double({ jit_type_void_ptr, jit_type_sys_double });
+SignatureCallback Callbacks::_cache_reset({ jit_type_void_ptr, jit_type_sys_ulonglong, jit_type_void_ptr });
+SignatureCallback Callbacks::_output_cached({ jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_sys_bool);
+SignatureCallback Callbacks::_output_store({ jit_type_void_ptr, jit_type_sys_ulonglong, jit_type_void_ptr, jit_type_sys_bool });
 SignatureCallback Callbacks::_member({ jit_type_void_ptr, jit_type_void_ptr, jit_type_void_ptr, jit_type_sys_longlong }, jit_type_void_ptr);
 SignatureCallback Callbacks::_member_at({ jit_type_void_ptr, jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_void_ptr);
 SignatureCallback Callbacks::_member_at_value({ jit_type_void_ptr, jit_type_void_ptr, jit_type_void_ptr }, jit_type_void_ptr);
@@ -38,13 +41,17 @@ SignatureCallback Callbacks::_valid_iterator({ jit_type_void_ptr, jit_type_void_
 SignatureCallback Callbacks::_iterator_key({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_void_ptr);
 SignatureCallback Callbacks::_iterator_value({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_void_ptr);
 SignatureCallback Callbacks::_iterator_next({ jit_type_void_ptr, jit_type_void_ptr });
+SignatureCallback Callbacks::_enter_scope({ jit_type_void_ptr });
+SignatureCallback Callbacks::_leave_scope({ jit_type_void_ptr });
 SignatureCallback Callbacks::_variable({ jit_type_void_ptr, jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_void_ptr);
+SignatureCallback Callbacks::_variable_slot({ jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_void_ptr);
 SignatureCallback Callbacks::_toString({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_void_ptr);
 SignatureCallback Callbacks::_toInteger({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_sys_longlong);
 SignatureCallback Callbacks::_toDouble({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_float64);
 SignatureCallback Callbacks::_toBoolean({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_sys_bool);
 SignatureCallback Callbacks::_size({ jit_type_void_ptr, jit_type_void_ptr }, jit_type_sys_ulonglong);
 SignatureCallback Callbacks::_modifier({ jit_type_void_ptr, jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_void_ptr);
+SignatureCallback Callbacks::_modifier_slot({ jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_void_ptr);
 SignatureCallback Callbacks::_modify_variable({ jit_type_void_ptr, jit_type_void_ptr, jit_type_void_ptr, jit_type_void_ptr }, jit_type_void_ptr);
 SignatureCallback Callbacks::_create_params({ jit_type_void_ptr, jit_type_sys_ulonglong }, jit_type_void_ptr);
 SignatureCallback Callbacks::_params_append_integer({ jit_type_void_ptr, jit_type_void_ptr, jit_type_sys_longlong });
@@ -142,6 +149,52 @@ void smart_tpl_output_double(void *userdata, double number)
     handler->outputDouble(number);
 }
 
+/**
+ *  Forget the cached output of a loop invariant expression
+ *  @param  userdata       pointer to user-supplied data
+ *  @param  slot           the cache slot
+ *  @param  variable       the variable that the output depends on (may be a nullptr)
+ */
+void smart_tpl_cache_reset(void *userdata, size_t slot, const void *variable)
+{
+    // convert the userdata to a handler object
+    auto *handler = (Handler *)userdata;
+
+    // reset the slot
+    handler->resetCache(slot, (const Value *)variable);
+}
+
+/**
+ *  Output the cached output of a loop invariant expression
+ *  @param  userdata       pointer to user-supplied data
+ *  @param  slot           the cache slot
+ *  @return int            was there cached output?
+ */
+int smart_tpl_output_cached(void *userdata, size_t slot)
+{
+    // convert the userdata to a handler object
+    auto *handler = (Handler *)userdata;
+
+    // write the cached output
+    return handler->outputCached(slot);
+}
+
+/**
+ *  Output a variable, and remember the output for the next iterations
+ *  @param  userdata       pointer to user-supplied data
+ *  @param  slot           the cache slot
+ *  @param  variable       pointer to the variable
+ *  @param  escape         should the output be escaped?
+ */
+void smart_tpl_output_store(void *userdata, size_t slot, const void *variable, int escape)
+{
+    // convert the userdata to a handler object
+    auto *handler = (Handler *)userdata;
+
+    // output the variable and remember it
+    handler->outputStore(slot, (const Value *)variable, escape != 0);
+}
+
 /**
  *  Retrieve a pointer to a member
  *  @param  userdata        pointer to user-supplied data
@@ -158,12 +211,9 @@ const void *smart_tpl_member(void *userdata, const void *variable, const char *n
     // fetch the member
     auto member = var->member(name, size);
 
-    // Allocate it on the heap so we can return the pointer to it
-    auto *output = new VariantValue(member);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary(std::move(member));
 
     // return the output
     return output;
@@ -184,12 +234,9 @@ const void* smart_tpl_member_at(void* userdata, const void* variable, size_t pos
     // fetch the member
     auto member = var->member(position);
 
-    // Allocate it on the heap so we can return the pointer to it
-    auto *output = new VariantValue(member);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary(std::move(member));
 
     // return the output
     return output;
@@ -211,12 +258,9 @@ const void* smart_tpl_member_at_value(void *userdata, const void *parent, const
     // fetch the member
     auto member = var->member(*idx);
       
-    // Allocate it on the heap so we can return the pointer to it
-    auto *output = new VariantValue(member);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary(std::move(member));
 
     // return the output
     return output;
@@ -230,12 +274,9 @@ const void* smart_tpl_member_at_value(void *userdata, const void *parent, const
  */
 const void *smart_tpl_transfer_integer(void *userdata, integer_t data)
 {
-    // Allocate on the heap
-    auto *output = new VariantValue(data);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary(data);
 
     // return the output
     return output;
@@ -249,12 +290,9 @@ const void *smart_tpl_transfer_integer(void *userdata, integer_t data)
  */
 const void *smart_tpl_transfer_double(void *userdata, double data)
 {
-    // Allocate on the heap
-    auto *output = new VariantValue(data);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary(data);
 
     // return the output
     return output;
@@ -269,12 +307,9 @@ const void *smart_tpl_transfer_double(void *userdata, double data)
  */
 const void *smart_tpl_transfer_string(void *userdata, const char *buffer, size_t length)
 {
-    // Allocate on the heap
-    auto *output = new VariantValue(buffer, length);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary(buffer, length);
 
     // return the output
     return output;
@@ -288,12 +323,9 @@ const void *smart_tpl_transfer_string(void *userdata, const char *buffer, size_t
  */
 const void *smart_tpl_transfer_boolean(void *userdata, int value)
 {
-    // Allocate on the heap
-    auto *output = new VariantValue((bool) value);
-
-    // Give the pointer to our handler so he can manage the Variant pointer
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
     auto *handler = (Handler *) userdata;
-    handler->manageValue(output);
+    auto *output = handler->temporary((bool) value);
 
     // return the output
     return output;
@@ -316,14 +348,11 @@ const void *smart_tpl_plus(void *userdata, const void *variable1, const void *va
     auto *value2 = (const Value *) variable2;
 
     // This will be a pointer to our new value
-    VariantValue *output;
+    const VariantValue *output;
 
     // Should we apply floating point logic?
-    if (value1->arithmeticFloat() || value2->arithmeticFloat()) output = new VariantValue(value1->toDouble() + value2->toDouble());
-    else output = new VariantValue(value1->toInteger() + value2->toInteger());
-
-    // Let the handler manage the new object
-    handler->manageValue(output);
+    if (value1->arithmeticFloat() || value2->arithmeticFloat()) output = handler->temporary(value1->toDouble() + value2->toDouble());
+    else output = handler->temporary(value1->toInteger() + value2->toInteger());
 
     // Return pointer to the result
     return output;
@@ -346,14 +375,11 @@ const void *smart_tpl_minus(void *userdata, const void *variable1, const void *v
     auto *value2 = (const Value *) variable2;
 
     // This will be a pointer to our new value
-    VariantValue *output;
+    const VariantValue *output;
 
     // Should we apply floating point logic?
-    if (value1->arithmeticFloat() || value2->arithmeticFloat()) output = new VariantValue(value1->toDouble() - value2->toDouble());
-    else output = new VariantValue(value1->toInteger() - value2->toInteger());
-
-    // Let the handler manage the new object
-    handler->manageValue(output);
+    if (value1->arithmeticFloat() || value2->arithmeticFloat()) output = handler->temporary(value1->toDouble() - value2->toDouble());
+    else output = handler->temporary(value1->toInteger() - value2->toInteger());
 
     // Return pointer to the result
     return output;
@@ -376,14 +402,11 @@ const void *smart_tpl_multiply(void *userdata, const void *variable1, const void
     auto *value2 = (const Value *) variable2;
 
     // This will be a pointer to our new value
-    VariantValue *output;
+    const VariantValue *output;
 
     // Should we apply floating point logic?
-    if (value1->arithmeticFloat() || value2->arithmeticFloat()) output = new VariantValue(value1->toDouble() * value2->toDouble());
-    else output = new VariantValue(value1->toInteger() * value2->toInteger());
-
-    // Let the handler manage the new object
-    handler->manageValue(output);
+    if (value1->arithmeticFloat() || value2->arithmeticFloat()) output = handler->temporary(value1->toDouble() * value2->toDouble());
+    else output = handler->temporary(value1->toInteger() * value2->toInteger());
 
     // Return pointer to the result
     return output;
@@ -406,7 +429,7 @@ const void *smart_tpl_divide(void *userdata, const void *variable1, const void *
     auto *value2 = (const Value *) variable2;
 
     // This will be a pointer to our new value
-    VariantValue *output;
+    const VariantValue *output;
 
     // Should we apply floating point logic?
     if (value1->arithmeticFloat() || value2->arithmeticFloat())
@@ -415,7 +438,7 @@ const void *smart_tpl_divide(void *userdata, const void *variable1, const void *
         if (value2->toDouble() == 0.0) return nullptr;
         
         // Calculate result
-        output = new VariantValue(value1->toDouble() / value2->toDouble());
+        output = handler->temporary(value1->toDouble() / value2->toDouble());
     }
 
     // Otherwise, apply interger logic
@@ -425,12 +448,9 @@ const void *smart_tpl_divide(void *userdata, const void *variable1, const void *
         if (value2->toNumeric() == 0) return nullptr;
 
         // Calculate result
-        output = new VariantValue(value1->toNumeric() / value2->toNumeric());
+        output = handler->temporary(value1->toNumeric() / value2->toNumeric());
     }
 
-    // Let the handler manage the new object
-    handler->manageValue(output);
-
     // Return pointer to the result
     return output;
 }
@@ -452,13 +472,10 @@ const void *smart_tpl_modulo(void *userdata, const void *variable1, const void *
     auto *value2 = (const Value *) variable2;
 
     // This will be a pointer to our new value
-    VariantValue *output;
+    const VariantValue *output;
 
     // For modulo we (currently) only support numeric operations
-    output = new VariantValue(value1->toNumeric() % value2->toNumeric());
-
-    // Let the handler manage the new object
-    handler->manageValue(output);
+    output = handler->temporary(value1->toNumeric() % value2->toNumeric());
 
     // Return pointer to the result
     return output;
@@ -516,8 +533,9 @@ const void *smart_tpl_iterator_key(void *userdata, void *iterator)
     // Ask the iterator
     auto key = iter->key();
 
-    // Allocate it on the heap so we can return the pointer to it
-    auto *output = new VariantValue(key);
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
+    auto *handler = (Handler *) userdata;
+    auto *output = handler->temporary(std::move(key));
 
     // Return the pointer
     return output;
@@ -534,11 +552,17 @@ const void *smart_tpl_iterator_value(void *userdata, void *iterator)
     // cast to iterator
     auto *iter = (Iterator *)iterator;
 
+    // the source value is kept alive by the iterator, so if the iterator gives
+    // access to the member itself, there is no need to copy it
+    auto *current = iter->current();
+    if (current) return current;
+
     // fetch the value from the iterator
     auto value = iter->value();
 
-    // Allocate it on the heap so we can return the pointer to it
-    auto *output = new VariantValue(value);
+    // Allocate it in the arena of the handler, so that it lives until the end of the run
+    auto *handler = (Handler *) userdata;
+    auto *output = handler->temporary(std::move(value));
 
     // return the output
     return output;
@@ -558,6 +582,32 @@ void smart_tpl_iterator_next(void *userdata, void *iterator)
     iter->next();
 }
 
+/**
+ *  Enter a new value scope
+ *  @param  userdata        pointer to user-supplied data
+ */
+void smart_tpl_enter_scope(void *userdata)
+{
+    // cast to handler
+    auto *handler = (Handler *)userdata;
+
+    // tell the handler
+    handler->enterScope();
+}
+
+/**
+ *  Leave the current value scope, and destruct all temporary values created in it
+ *  @param  userdata        pointer to user-supplied data
+ */
+void smart_tpl_leave_scope(void *userdata)
+{
+    // cast to handler
+    auto *handler = (Handler *)userdata;
+
+    // tell the handler
+    handler->leaveScope();
+}
+
 /**
  *  Retrieve a pointer to a variable
  *  @param  userdata        pointer to user-supplied data
@@ -577,6 +627,24 @@ const void *smart_tpl_variable(void *userdata, const char *name, size_t size)
     return result ? result : &_empty;
 }
 
+/**
+ *  Retrieve a pointer to a variable by its slot index
+ *  @param  userdata        pointer to user-supplied data
+ *  @param  index           slot index of the variable
+ *  @return                 pointer to the variable
+ */
+const void *smart_tpl_variable_slot(void *userdata, size_t index)
+{
+    // convert the userdata to a handler object
+    auto *handler = (Handler *)userdata;
+
+    // convert to a variable
+    auto *result = handler->variable(index);
+
+    // ensure that we always return an object
+    return result ? result : &_empty;
+}
+
 /**
  *  Retrieve the string representation of a variable
  *  @param  userdata        pointer to user-supplied data
@@ -674,6 +742,22 @@ void* smart_tpl_modifier(void *userdata, const char *name, size_t size)
     return handler->modifier(name, size);
 }
 
+/**
+ *  Retrieve the modifier by its slot index, the modifiers are resolved
+ *  once before the template is run
+ *  @param userdata       pointer to user-supplied data
+ *  @param index          slot index of the modifier
+ *  @return               A pointer to the modifier, or a nullptr if it wasn't found
+ */
+void* smart_tpl_modifier_slot(void *userdata, size_t index)
+{
+    // convert to Handler
+    auto *handler = (Handler *) userdata;
+
+    // Return the resolved modifier
+    return handler->modifier(index);
+}
+
 /**
  *  Apply a modifier from smart_tpl_modifier on a value
  *  @param userdata       pointer to user-supplied data
@@ -695,8 +779,11 @@ const void* smart_tpl_modify_variable(void *userdata, const void *variable, void
     // convert to Parameters object
     auto *params_ptr = (SmartTpl::Parameters *) parameters;
 
-    // If params_ptr is valid use that one, create an empty one on the stack otherwise
-    SmartTpl::Parameters params = (params_ptr) ? *params_ptr : SmartTpl::Parameters();
+    // the parameters to use if none were passed
+    static const SmartTpl::Parameters empty;
+
+    // If params_ptr is valid use that one, use the empty parameters otherwise (no copy required)
+    const SmartTpl::Parameters &params = (params_ptr) ? *params_ptr : empty;
 
     // the modify method of the modifier could throw a NoModification exception
     try
@@ -704,12 +791,10 @@ const void* smart_tpl_modify_variable(void *userdata, const void *variable, void
         // Actually modify the value
         auto variant = modifier->modify(*value, params);
 
-        // Convert the variant to a pointer so we can actually return it from C
-        auto *output = new VariantValue(variant);
-
-        // Give it to our handler so he can manage the Variant pointer
+        // Convert the variant to a pointer so we can actually return it from C,
+        // it is allocated in the arena of the handler so it lives until the end of the run
         auto *handler = (Handler *) userdata;
-        handler->manageValue(output);
+        auto *output = handler->temporary(std::move(variant));
 
         // and return the output
         return output;
@@ -893,6 +978,64 @@ void smart_tpl_regex_release(void *userdata, void *handle)
     delete regex;
 }
 
+/**
+ *  Get a regex that is compiled only once, and that is stored in a static
+ *  variable in the compiled template
+ *  @param  userdata        Pointer to user-supplied data
+ *  @param  handle          Pointer to the variable that holds the compiled regex
+ *  @param  regex           Regular expression
+ *  @param  size            Size of the regular expression
+ *  @return Pointer         Handle to the regular expression
+ */
+void *smart_tpl_regex_cached(void *userdata, void **handle, const char *regex, size_t size)
+{
+    // the regex could already be compiled by an earlier call
+    void *current = __atomic_load_n(handle, __ATOMIC_ACQUIRE);
+    if (current) return current;
+
+    // compile the regex
+    void *compiled = smart_tpl_regex_compile(userdata, regex, size);
+
+    // an invalid regex is reported to the caller
+    if (!compiled) throw RunTimeError("Invalid regular expression");
+
+    // store it, unless another thread was faster, in that case we use their regex
+    if (__atomic_compare_exchange_n(handle, &current, compiled, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return compiled;
+
+    // we no longer need our own regex
+    smart_tpl_regex_release(userdata, compiled);
+
+    // use the one from the other thread
+    return current;
+}
+
+/**
+ *  Check whether a message matches a regex that is only known at runtime
+ *  @param  userdata        Pointer to user-supplied data
+ *  @param  regex           Regular expression
+ *  @param  regex_size      Size of the regular expression
+ *  @param  message         The message to search for
+ *  @param  size            Size of the message
+ *  @return int             Return value
+ */
+int smart_tpl_regex_search(void *userdata, const char *regex, size_t regex_size, const char *message, size_t size)
+{
+    // compile the regex
+    void *handle = smart_tpl_regex_compile(userdata, regex, regex_size);
+
+    // an invalid regex is reported to the caller
+    if (!handle) throw RunTimeError("Invalid regular expression");
+
+    // check for a match
+    int result = smart_tpl_regex_match(userdata, handle, message, size);
+
+    // release the regex again
+    smart_tpl_regex_release(userdata, handle);
+
+    // done
+    return result;
+}
+
 /**
  *  Create a Parameters object
  *  @param  userdata         Pointer to user-supplied data
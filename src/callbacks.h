@@ -22,6 +22,9 @@ void        smart_tpl_output                (void *userdata, const void *variabl
 void        smart_tpl_output_integer        (void *userdata, integer_t number);
 void        smart_tpl_output_boolean        (void *userdata, int value);
 void        smart_tpl_output_double         (void *userdata, double value);
+void        smart_tpl_cache_reset           (void *userdata, size_t slot, const void *variable);
+int         smart_tpl_output_cached         (void *userdata, size_t slot);
+void        smart_tpl_output_store          (void *userdata, size_t slot, const void *variable, int escape);
 const void *smart_tpl_member                (void *userdata, const void *variable, const char *name, size_t size);
 const void *smart_tpl_member_at             (void *userdata, const void *variable, size_t position);
 const void *smart_tpl_member_at_value       (void *userdata, const void *parent, const void *index);
@@ -39,13 +42,17 @@ int         smart_tpl_valid_iterator        (void *userdata, void *iterator);
 const void *smart_tpl_iterator_key          (void *userdata, void *iterator);
 const void *smart_tpl_iterator_value        (void *userdata, void *iterator);
 void        smart_tpl_iterator_next         (void *userdata, void *iterator);
+void        smart_tpl_enter_scope           (void *userdata);
+void        smart_tpl_leave_scope           (void *userdata);
 const void *smart_tpl_variable              (void *userdata, const char *name, size_t size);
+const void *smart_tpl_variable_slot         (void *userdata, size_t index);
 const char *smart_tpl_to_string             (void *userdata, const void *variable);
 integer_t   smart_tpl_to_integer            (void *userdata, const void *variable);
 double      smart_tpl_to_double             (void *userdata, const void *variable);
 int         smart_tpl_to_boolean            (void *userdata, const void *variable);
 size_t      smart_tpl_size                  (void *userdata, const void *variable);
 void       *smart_tpl_modifier              (void *userdata, const char *name, size_t size);
+void       *smart_tpl_modifier_slot         (void *userdata, size_t index);
 const void *smart_tpl_modify_variable       (void *userdata, const void *variable, void *modifier, const void *parameters);
 void        smart_tpl_assign_integer        (void *userdata, const char *key, size_t keysize, integer_t value);
 void        smart_tpl_assign_boolean        (void *userdata, const char *key, size_t keysize, int boolean);
@@ -56,6 +63,8 @@ int         smart_tpl_strcmp                (void *userdata, const char *a, size
 void       *smart_tpl_regex_compile         (void *userdata, const char *regex, size_t size);
 int         smart_tpl_regex_match           (void *userdata, void *handle, const char *message, size_t size);
 void        smart_tpl_regex_release         (void *userdata, void *handle);
+void       *smart_tpl_regex_cached          (void *userdata, void **handle, const char *regex, size_t size);
+int         smart_tpl_regex_search          (void *userdata, const char *regex, size_t regex_size, const char *message, size_t size);
 const void *smart_tpl_create_params         (void *userdata, size_t parameters_count);
 const void *smart_tpl_params_append_integer (void *userdata, const void *parameters, integer_t value);
 const void *smart_tpl_params_append_double  (void *userdata, const void *parameters, double value);
@@ -101,6 +110,21 @@ private:
      */
     static SignatureCallback _output_double;
 
+    /**
+     *  Signature of the cache reset callback
+     */
+    static SignatureCallback _cache_reset;
+
+    /**
+     *  Signature of the output cached callback
+     */
+    static SignatureCallback _output_cached;
+
+    /**
+     *  Signature of the output store callback
+     */
+    static SignatureCallback _output_store;
+
     /**
      *  Signatures to access an array
      */
@@ -150,10 +174,17 @@ private:
      */
     static SignatureCallback _iterator_next;
 
+    /**
+     *  Signatures of the callbacks to enter and leave a value scope
+     */
+    static SignatureCallback _enter_scope;
+    static SignatureCallback _leave_scope;
+
     /**
      *  Signature of the variable callback
      */
     static SignatureCallback _variable;
+    static SignatureCallback _variable_slot;
 
     /**
      *  Signature of the function to convert a variable to a string
@@ -184,6 +215,7 @@ private:
      *  Signature of the function to retrieve the modifier
      */
     static SignatureCallback _modifier;
+    static SignatureCallback _modifier_slot;
 
     /**
      *  Signature of the function to modify a variable
@@ -362,6 +394,67 @@ public:
         _function->insn_call_native("smart_tpl_output_double", (void *)smart_tpl_output_double, _output_double.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
     }
 
+    /**
+     *  Call the cache reset function
+     *  @param  userdata        Pointer to user supplied data
+     *  @param  slot            The cache slot
+     *  @param  variable        Pointer to the variable the output depends on (may be a nullptr)
+     *  @see    smart_tpl_cache_reset
+     */
+    void cache_reset(const jit_value &userdata, const jit_value &slot, const jit_value &variable)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw(),
+            slot.raw(),
+            variable.raw()
+        };
+
+        // create the instruction
+        _function->insn_call_native("smart_tpl_cache_reset", (void *)smart_tpl_cache_reset, _cache_reset.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
+    /**
+     *  Call the output cached function
+     *  @param  userdata        Pointer to user supplied data
+     *  @param  slot            The cache slot
+     *  @return jit_value       Boolean, was the cached output written?
+     *  @see    smart_tpl_output_cached
+     */
+    jit_value output_cached(const jit_value &userdata, const jit_value &slot)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw(),
+            slot.raw()
+        };
+
+        // create the instruction
+        return _function->insn_call_native("smart_tpl_output_cached", (void *)smart_tpl_output_cached, _output_cached.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
+    /**
+     *  Call the output store function
+     *  @param  userdata        Pointer to user supplied data
+     *  @param  slot            The cache slot
+     *  @param  variable        Pointer to the variable to output
+     *  @param  escape          Boolean whether we should escape the output or not
+     *  @see    smart_tpl_output_store
+     */
+    void output_store(const jit_value &userdata, const jit_value &slot, const jit_value &variable, const jit_value &escape)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw(),
+            slot.raw(),
+            variable.raw(),
+            escape.raw()
+        };
+
+        // create the instruction
+        _function->insn_call_native("smart_tpl_output_store", (void *)smart_tpl_output_store, _output_store.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
     /**
      *  Call the member function
      *  @param  userdata        Pointer to user-supplied data
@@ -704,6 +797,38 @@ public:
         _function->insn_call_native("smart_tpl_iterator_next", (void *)smart_tpl_iterator_next, _iterator_next.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
     }
 
+    /**
+     *  Call the enter_scope function
+     *  @param  userdata    Pointer to user supplied data
+     *  @see    smart_tpl_enter_scope
+     */
+    void enter_scope(const jit_value &userdata)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw()
+        };
+
+        // create the instruction
+        _function->insn_call_native("smart_tpl_enter_scope", (void *)smart_tpl_enter_scope, _enter_scope.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
+    /**
+     *  Call the leave_scope function
+     *  @param  userdata    Pointer to user supplied data
+     *  @see    smart_tpl_leave_scope
+     */
+    void leave_scope(const jit_value &userdata)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw()
+        };
+
+        // create the instruction
+        _function->insn_call_native("smart_tpl_leave_scope", (void *)smart_tpl_leave_scope, _leave_scope.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
     /**
      *  Call the variable function
      *  @param  userdata        Pointer to user-supplied data
@@ -725,6 +850,25 @@ public:
         return _function->insn_call_native("smart_tpl_variable", (void *)smart_tpl_variable, _variable.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
     }
 
+    /**
+     *  Call the variable_slot function
+     *  @param  userdata        Pointer to user-supplied data
+     *  @param  index           Slot index of the variable
+     *  @return jit_value       The variable pointer
+     *  @see    smart_tpl_variable_slot
+     */
+    jit_value variable_slot(const jit_value &userdata, const jit_value &index)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw(),
+            index.raw()
+        };
+
+        // create the instruction
+        return _function->insn_call_native("smart_tpl_variable_slot", (void *)smart_tpl_variable_slot, _variable_slot.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
     /**
      *  Call the to_integer function
      *  @param  userdata        Pointer to user-supplied data
@@ -941,6 +1085,25 @@ public:
         return _function->insn_call_native("smart_tpl_modifier", (void *)smart_tpl_modifier, _modifier.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
     }
 
+    /**
+     *  Call the modifier_slot function
+     *  @param  userdata      Pointer to user-supplied data
+     *  @param  index         Slot index of the modifier
+     *  @return jit_value     Pointer to the modifier object
+     *  @see    smart_tpl_modifier_slot
+     */
+    jit_value modifier_slot(const jit_value &userdata, const jit_value &index)
+    {
+        // construct the arguments
+        jit_value_t args[] = {
+            userdata.raw(),
+            index.raw()
+        };
+
+        // create the instruction
+        return _function->insn_call_native("smart_tpl_modifier_slot", (void *)smart_tpl_modifier_slot, _modifier_slot.signature(), args, sizeof(args)/sizeof(jit_value_t), 0);
+    }
+
     /**
      *  Call the modify_variable function
      *  @param  userdata    Pointer to user-supplied data
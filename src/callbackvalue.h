@@ -71,6 +71,15 @@ public:
      */
     virtual ~CallbackValue() {}
 
+    /**
+     *  Does the value stay the same, or is the callback called every time?
+     *  @return bool
+     */
+    bool cacheable() const
+    {
+        return _cacheable;
+    }
+
     /**
      *  Convert the value to a string
      *  @return const char *
@@ -19,14 +19,24 @@ namespace SmartTpl { namespace Internal {
  */
 CCode::CCode(const SyntaxTree &tree)
 {
+    // generate the statements first, because only then we know which regexes they use
+    tree.generate(this);
+
+    // take them out of the stream, they are written after the declarations
+    std::string statements = _out.str();
+    _out.str("");
+
     // include headers
     _out << "#include <smarttpl/callbacks.h>" << std::endl;
 
+    // the regexes with a literal pattern are only compiled once, the first time they are used
+    if (_regexes.size() > 0) _out << "static void *regexes[" << _regexes.size() << "];" << std::endl;
+
     // create function header
     _out << "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {" << std::endl;
 
-    // generate the statements
-    tree.generate(this);
+    // the statements
+    _out << statements;
 
     // end of the function
     _out << '}' << std::endl;
@@ -42,6 +52,16 @@ CCode::CCode(const SyntaxTree &tree)
 
     // And write the string from mode() after the const char *mode declaration
     _out << '\"' << quoted << "\";" << std::endl;
+
+    // the names of the variables, ordered by slot index and terminated by a null pointer
+    _out << "const char *variables[] = {";
+    for (const auto &name : _slots.names()) _out << '\"' << QuotedString(name) << "\",";
+    _out << "0};" << std::endl;
+
+    // the same for the names of the modifiers
+    _out << "const char *modifiers[] = {";
+    for (const auto &name : _modifiers.names()) _out << '\"' << QuotedString(name) << "\",";
+    _out << "0};" << std::endl;
 }
 
 CCode::CCode(const Source &source) : 
@@ -98,6 +118,42 @@ void CCode::output(const Filter *filter)
     _out << ");" << std::endl;
 }
 
+/**
+ *  Generate the code to forget the cached output of a loop invariant expression
+ *  @param  slot                the cache slot
+ *  @param  root                the variable that the output depends on (may be a nullptr)
+ */
+void CCode::cacheReset(size_t slot, const Variable *root)
+{
+    // call the cache reset function
+    _out << "callbacks->cache_reset(userdata," << slot << ",";
+
+    // pass the variable the output depends on, if there is one
+    if (root) root->pointer(this);
+    else _out << "NULL";
+
+    // end of the function
+    _out << ");" << std::endl;
+}
+
+/**
+ *  Generate the code to output a loop invariant variable
+ *  @param  slot                the cache slot
+ *  @param  variable            the variable (or filter) to output
+ *  @param  escape              should the output be escaped?
+ */
+void CCode::cachedOutput(size_t slot, const Variable *variable, bool escape)
+{
+    // only if the output is not yet cached, the variable is evaluated
+    _out << "if (!callbacks->output_cached(userdata," << slot << ")) callbacks->output_store(userdata," << slot << ",";
+
+    // convert the variable to the pointer of it
+    variable->pointer(this);
+
+    // write the escape flag, and end the function
+    _out << ',' << (escape ? 1 : 0) << ");" << std::endl;
+}
+
 /**
  *  Generate the code to write an expression as a string
  *  @param  expression          the expression to write as a string
@@ -189,12 +245,9 @@ void CCode::condition(const Expression *expression, const Statements *ifstatemen
  */
 void CCode::varPointer(const std::string &name)
 {
-    // quote newlines, null characters, etc in the string so that it can
-    // be picked up by the compiler
-    QuotedString quoted(name);
-
-    // call the callback to get the variable
-    _out << "callbacks->variable(userdata,\"" << quoted << "\"," << name.size() << ')';
+    // call the callback to get the variable by its slot, the names of the
+    // slots are written at the end of the code
+    _out << "callbacks->variable_slot(userdata," << _slots.add(name) << ')';
 }
 
 /**
@@ -303,6 +356,13 @@ void CCode::stringValue(const std::string &value)
  */
 void CCode::integerValue(integer_t value)
 {
+    // the smallest number has no literal in c, because the literal without the minus is too big
+    if (value == std::numeric_limits<integer_t>::min()) return (void)(_out << "(-9223372036854775807LL-1)");
+
+    // negative numbers (which can be the result of constant folding) are put
+    // in parentheses, otherwise "1 - -5" would become the decrement "1--5"
+    if (value < 0) return (void)(_out << '(' << value << ')');
+
     // output number
     _out << value;
 }
@@ -313,9 +373,19 @@ void CCode::integerValue(integer_t value)
  */
 void CCode::doubleValue(double value)
 {
-    // output number
-    _out.precision(std::numeric_limits<double>::digits10);
-    _out << std::fixed << value;
+    // infinity and nan have no literal in c, so we let the compiler calculate them
+    if (std::isnan(value)) return (void)(_out << "(0.0/0.0)");
+    if (std::isinf(value)) return (void)(_out << (value < 0 ? "(-1.0/0.0)" : "(1.0/0.0)"));
+
+    // output the number as hex float, which is exact, so that the shared
+    // library outputs exactly the same as the jit compiled template
+    char buffer[32];
+    size_t size = snprintf(buffer, sizeof(buffer), "%a", value);
+
+    // negative numbers are put in parentheses, just like negative integers
+    if (std::signbit(value)) _out << '(';
+    _out.write(buffer, size);
+    if (std::signbit(value)) _out << ')';
 }
 
 /**
@@ -948,7 +1018,23 @@ void CCode::lesserEquals(const Expression *left, const Expression *right)
  */
 void CCode::regex(const Expression *left, const Expression *right)
 {
-    _out << "callbacks->regex(userdata,"; left->toString(this); _out << ','; right->toString(this); _out << ") == 0";
+    // only literal patterns can be compiled once
+    auto *literal = dynamic_cast<const LiteralString *>(right);
+
+    // other patterns have to be compiled every time the expression is evaluated
+    if (!literal)
+    {
+        // compile the pattern and match the string on the left hand side
+        _out << "callbacks->regex_search(userdata,"; right->toString(this); _out << ','; left->toString(this); _out << ')';
+    }
+    else
+    {
+        // the static variable that holds the compiled pattern
+        auto index = _regexes.add(literal->value());
+
+        // compile the pattern if it was not yet compiled, and match the string on the left hand side
+        _out << "callbacks->regex_match(userdata,callbacks->regex_cached(userdata,&regexes[" << index << "],"; right->toString(this); _out << "),"; left->toString(this); _out << ')';
+    }
 }
 
 /**
@@ -966,25 +1052,17 @@ void CCode::booleanOr(const Expression *left, const Expression *right)  { left->
  */
 void CCode::modifiers(const Modifiers *modifiers, const Variable *variable)
 {
-    // get some iterators
-    const auto begin = modifiers->begin();
-    const auto end = modifiers->end();
-    const auto last = --(modifiers->end());
-
     // write out all the modify_variable calls first
     for (std::size_t i = 0; i < modifiers->size(); ++i) _out << "callbacks->modify_variable(userdata,";
 
     // then write the pointer to the variable
     variable->pointer(this);
-    _out << ',';
 
-    // finish writing the actual statements by retrieving all the actual modifiers
-    for (auto iter = begin; iter != end; ++iter)
+    // finish writing the actual statements by retrieving all the actual modifiers (the
+    // list may be empty, if all modifiers were already applied at compile time)
+    for (const auto &modifier : *modifiers)
     {
-        const auto &modifier = *iter;
-        _out << "callbacks->modifier(userdata,";
-        stringValue(modifier->token());
-        _out << "),";
+        _out << ",callbacks->modifier_slot(userdata," << _modifiers.add(modifier->token()) << "),";
 
         const Parameters *params = modifier->parameters();
 
@@ -994,9 +1072,6 @@ void CCode::modifiers(const Modifiers *modifiers, const Variable *variable)
         else params->generate(this);
 
         _out << ')';
-
-        // all of them need this comma, except for the last one
-        if (iter != last) _out << ',';
     }
 }
 
@@ -1150,6 +1225,9 @@ void CCode::foreach(const Variable *variable, const std::string &key, const std:
     // construct the loop
     _out << "while (callbacks->valid_iterator(userdata,iterator)) {" << std::endl;
 
+    // every iteration gets its own value scope
+    _out << "callbacks->enter_scope(userdata);" << std::endl;
+
     // assign the key and value
     if (!key.empty()) { _out << "callbacks->assign(userdata,"; stringValue(key); _out << ",callbacks->iterator_key(userdata,iterator));" << std::endl; }
     if (!value.empty()) { _out << "callbacks->assign(userdata,"; stringValue(value); _out << ",callbacks->iterator_value(userdata,iterator));" << std::endl; }
@@ -1157,7 +1235,8 @@ void CCode::foreach(const Variable *variable, const std::string &key, const std:
     // generate the actual statements
     statements->generate(this);
 
-    // proceed the iterator
+    // destruct the temporaries of this iteration, and proceed the iterator
+    _out << "callbacks->leave_scope(userdata);" << std::endl;
     _out << "callbacks->iterator_next(userdata,iterator);" << std::endl;
 
     // end of the while loop
@@ -28,6 +28,20 @@ private:
      */
     std::ostringstream _out;
 
+    /**
+     *  The slot indices of the variables and modifiers that are used in the template
+     *  @var    Slots
+     */
+    Slots _slots;
+    Slots _modifiers;
+
+    /**
+     *  The literal regex patterns, each one gets a static variable in which
+     *  it is stored after it is compiled
+     *  @var    Slots
+     */
+    Slots _regexes;
+
     /**
      *  Output raw data
      *  @param  data        buffer to output
@@ -46,6 +60,21 @@ private:
      */
     virtual void output(const Filter *filter) override;
 
+    /**
+     *  Generate the code to forget the cached output of a loop invariant expression
+     *  @param  slot                the cache slot
+     *  @param  root                the variable that the output depends on (may be a nullptr)
+     */
+    virtual void cacheReset(size_t slot, const Variable *root) override;
+
+    /**
+     *  Generate the code to output a loop invariant variable
+     *  @param  slot                the cache slot
+     *  @param  variable            the variable (or filter) to output
+     *  @param  escape              should the output be escaped?
+     */
+    virtual void cachedOutput(size_t slot, const Variable *variable, bool escape) override;
+
     /**
      *  Generate the code to write an expression as a string
      *  @param  expression          the expression to write as a string
@@ -90,6 +90,8 @@ Data::Data()
               {"jsondecode",       &jsondecode},
               {"urlencode",        &urlencode},
               {"urldecode",        &urldecode},
+              {"base64_encode",    &base64_encode},
+              {"base64_decode",    &base64_decode},
               {"range",            &range_modifier}}) // register built-in modifiers
 {
     // in case the openssl library is valid we are loading all the modifiers that use it
@@ -98,13 +100,11 @@ Data::Data()
         _modifiers.insert({{"md5",              &md5},
                            {"sha1",             &sha1},
                            {"sha256",           &sha256},
-                           {"sha512",           &sha512},
-                           {"base64_encode",    &base64_encode},
-                           {"base64_decode",    &base64_decode}});
+                           {"sha512",           &sha512}});
     }
     
     // assign the state, so that variables like "smarty.now" are available
-    _variables.emplace(std::piecewise_construct, std::forward_as_tuple("smarty"), std::forward_as_tuple(&_state));
+    store("smarty", &_state);
 }
 
 /**
@@ -112,9 +112,42 @@ Data::Data()
  */
 Data::Data(Data&& that)
 : _variables(std::move(that._variables)),
+  _values(std::move(that._values)),
   _managed_values(std::move(that._managed_values)),
   _modifiers(std::move(that._modifiers))
 {
+    // the state of the other object is not ours
+    store("smarty", &_state);
+}
+
+/**
+ *  Store a value in _variables (and keep _values in sync)
+ *  @param  name        name of the variable
+ *  @param  value       the value to store
+ */
+void Data::store(const std::string &name, const Value *value)
+{
+    // look for the current value
+    auto *current = _variables.find(name);
+
+    // is this a new variable?
+    if (current == nullptr)
+    {
+        // add it
+        _variables.insert(name, value);
+    }
+    else
+    {
+        // the old value is no longer held under this name
+        auto old = _values.find(*current);
+        if (old != _values.end()) _values.erase(old);
+
+        // overwrite the value
+        *current = value;
+    }
+
+    // remember that we hold the value
+    _values.insert(value);
 }
 
 /**
@@ -150,7 +183,7 @@ Data &Data::assign(const std::string &name, VariantValue &&value)
 Data &Data::assignValue(const std::string &name, Value *value)
 {
     // append value
-    _variables[name] = value;
+    store(name, value);
 
     // allow chaining
     return *this;
@@ -168,7 +201,7 @@ Data &Data::assignManaged(const std::string &name, Value *value)
     if (!value) return *this;
 
     // append variable
-    _variables[name] = value;
+    store(name, value);
 
     // make it managed
     _managed_values.emplace_back(value);
@@ -189,7 +222,7 @@ Data &Data::assignManaged(const std::string &name, std::shared_ptr<Value> &value
     if (!value) return *this;
 
     // append variable
-    _variables[name] = value.get();
+    store(name, value.get());
 
     // make it managed
     _managed_values.emplace_back(value);
@@ -214,7 +247,7 @@ Data &Data::callback(const std::string &name, const Callback &callback, bool cac
     _managed_values.emplace_back(v);
 
     // and store in the list of variables
-    _variables[name] = v;
+    store(name, v);
 
     // allow chaining
     return *this;
@@ -229,7 +262,7 @@ Data &Data::callback(const std::string &name, const Callback &callback, bool cac
 Data &Data::modifier(const std::string &name, Modifier* modifier)
 {
     // assign variable
-    _modifiers[name] = modifier;
+    _modifiers.insert(name, modifier);
 
     // allow chaining
     return *this;
@@ -244,11 +277,41 @@ Data &Data::modifier(const std::string &name, Modifier* modifier)
 const Value *Data::value(const char *name, size_t size) const
 {
     // look it up in _variables
-    auto iter = _variables.find(name);
-    if (iter != _variables.end()) return iter->second;
+    auto *result = _variables.find(name, size);
+
+    // return nullptr if we found nothing
+    return result ? *result : nullptr;
+}
+
+/**
+ *  Retrieve a variable pointer by name and a precomputed hash
+ *  @param  name        the name
+ *  @param  size        size of the name
+ *  @param  hash        hash of the name
+ *  @return Value
+ */
+const Value *Data::value(const char *name, size_t size, uint64_t hash) const
+{
+    // look it up in _variables
+    auto *result = _variables.find(name, size, hash);
 
     // return nullptr if we found nothing
-    return nullptr;
+    return result ? *result : nullptr;
+}
+
+/**
+ *  Retrieve the values of a number of variables at once
+ *  @param  names       the names of the variables
+ *  @param  hashes      the hashes of the names
+ *  @param  values      filled with the values (nullptr for unknown variables)
+ */
+void Data::bind(const std::vector<std::string> &names, const std::vector<uint64_t> &hashes, std::vector<const Value*> &values) const
+{
+    // one value for each name
+    values.resize(names.size());
+
+    // look up all names
+    for (size_t i = 0; i < names.size(); ++i) values[i] = value(names[i].data(), names[i].size(), hashes[i]);
 }
 
 /**
@@ -260,11 +323,26 @@ const Value *Data::value(const char *name, size_t size) const
 Modifier *Data::modifier(const char* name, size_t size) const
 {
     // check if the modifier is listed
-    auto iter = _modifiers.find(name);
-    if (iter == _modifiers.end()) return nullptr;
+    auto *result = _modifiers.find(name, size);
 
     // get the pointer
-    return iter->second;
+    return result ? *result : nullptr;
+}
+
+/**
+ *  Retrieve a pointer to a modifier by name and a precomputed hash
+ *  @param  name        Name of the modifier
+ *  @param  size        Length of the name
+ *  @param  hash        Hash of the name
+ *  @return Modifier*
+ */
+Modifier *Data::modifier(const char* name, size_t size, uint64_t hash) const
+{
+    // check if the modifier is listed
+    auto *result = _modifiers.find(name, size, hash);
+
+    // get the pointer
+    return result ? *result : nullptr;
 }
 
 /**
@@ -274,15 +352,8 @@ Modifier *Data::modifier(const char* name, size_t size) const
  */
 bool Data::contains(const Value *value) const
 {
-    // iterate over all values
-    for (const auto &variable :_variables)
-    {
-        // if pointers are identical it is in the data object
-        if (variable.second == value) return true;
-    }
-    
-    // the value was not found
-    return false;
+    // look it up in the set of values
+    return _values.find(value) != _values.end();
 }
 
 
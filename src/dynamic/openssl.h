@@ -6,7 +6,7 @@
  *
  *  @author Toon Schoenmakers<toon.schoenmakers@copernica.com>
  *  @author Michael van der Werve <michael.vanderwerve@mailerq.com>
- *  @copyright 2015 - 2017 Copernica BV
+ *  @copyright 2015 - 2019 Copernica BV
  */
 
 /**
@@ -19,7 +19,6 @@
  */
 #include "library.h"
 #include "function.h"
-#include <openssl/bio.h>
 
 /**
  *  Namespace
@@ -136,18 +135,7 @@ private:
         MD5(_lib, "MD5"),
         SHA1(_lib, "SHA1"),
         SHA256(_lib, "SHA256"),
-        SHA512(_lib, "SHA512"),
-        BIO_new(_lib, "BIO_new"),
-        BIO_new_mem_buf(_lib, "BIO_new_mem_buf"),
-        BIO_f_base64(_lib, "BIO_f_base64"),
-        BIO_s_mem(_lib, "BIO_s_mem"),
-        BIO_set_flags(_lib, "BIO_set_flags"),
-        BIO_push(_lib, "BIO_push"),
-        BIO_write(_lib, "BIO_write"),
-        BIO_read(_lib, "BIO_read"),
-        BIO_test_flags(_lib, "BIO_test_flags"),
-        BIO_free_all(_lib, "BIO_free_all"),
-        BIO_ctrl(_lib, "BIO_ctrl")
+        SHA512(_lib, "SHA512")
     {
     };
 
@@ -183,19 +171,6 @@ public:
     const Dynamic::Function<unsigned char*(const unsigned char *d, size_t n, unsigned char *md)> SHA1;
     const Dynamic::Function<unsigned char*(const unsigned char *d, size_t n, unsigned char *md)> SHA256;
     const Dynamic::Function<unsigned char*(const unsigned char *d, size_t n, unsigned char *md)> SHA512;
-
-    // BIO related methods
-    const Dynamic::Function<BIO*(BIO_METHOD *type)> BIO_new;
-    const Dynamic::Function<BIO*(void *buf, int len)> BIO_new_mem_buf;
-    const Dynamic::Function<BIO_METHOD*()> BIO_f_base64;
-    const Dynamic::Function<BIO_METHOD*()> BIO_s_mem;
-    const Dynamic::Function<void(BIO *bio, int flags)> BIO_set_flags;
-    const Dynamic::Function<BIO*(BIO *bio, BIO *append)> BIO_push;
-    const Dynamic::Function<int(BIO *bio, const void *buf, int len)> BIO_write;
-    const Dynamic::Function<int(BIO *bio, void *buf, int len)> BIO_read;
-    const Dynamic::Function<int(BIO *bio, int flags)> BIO_test_flags;
-    const Dynamic::Function<void(BIO *bio)> BIO_free_all;
-    const Dynamic::Function<int(BIO *bio, int cmd, long larg, void *parg)> BIO_ctrl;
 };
 
 /**
@@ -68,6 +68,26 @@ public:
      */
     virtual std::string &encode(std::string &input) const = 0;
 
+    /**
+     *  Encode a buffer and append the encoded data to an output string
+     *
+     *  The default implementation copies the buffer and encodes the copy,
+     *  escapers that are used for the output of variables should override
+     *  it to encode directly into the output.
+     *
+     *  @param  data        the buffer to encode
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the encoded data is appended
+     */
+    virtual void append(const char *data, size_t size, std::string &output) const
+    {
+        // encode a copy of the data
+        std::string work(data, size);
+
+        // and append it
+        output.append(encode(work));
+    }
+
     /**
      *  Decode the given input
      *  It is probably a good idea to directly modify the input instead of making
@@ -4,7 +4,7 @@
  *  A html en/decoder
  *
  *  @author Toon Schoenmakers <toon.schoenmakers@copernica.com>
- *  @copyright 2014 Copernica BV
+ *  @copyright 2014 - 2019 Copernica BV
  */
 
 /**
@@ -27,6 +27,14 @@ public:
      */
     virtual ~HtmlEscaper() {}
 
+    /**
+     *  Find the first character in a buffer that has to be escaped
+     *  @param  data        the buffer
+     *  @param  size        size of the buffer
+     *  @return size_t      position of the character, or size if there is none
+     */
+    static size_t scan(const char *data, size_t size);
+
     /**
      *  Encode the given input
      *  It is probably a good idea to directly modify the input instead of making
@@ -35,27 +43,53 @@ public:
      */
     std::string &encode(std::string &input) const override
     {
-        // Replace the <, >, " and & with their escaped versions
-        // We do this by looping through the input and looking for the characters that need to be escaped at the same time
-        for (std::string::size_type pos = 0; pos != std::string::npos;) {
+        // most strings do not contain any special characters at all
+        if (scan(input.data(), input.size()) == input.size()) return input;
 
-            pos = input.find_first_of("\"\'&<>", pos);
+        // encode into a new string, and swap it with the input
+        std::string output;
+        append(input.data(), input.size(), output);
+        input.swap(output);
 
-            if (pos == std::string::npos) break;
-            // In case we found one of them we simply replace it in place with the escaped version
-            switch (input[pos])
+        // Return the modified input
+        return input;
+    }
+
+    /**
+     *  Encode a buffer and append the encoded data to an output string
+     *  @param  data        the buffer to encode
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the encoded data is appended
+     */
+    void append(const char *data, size_t size, std::string &output) const override
+    {
+        // process the input in runs of characters that do not have to be escaped
+        while (true)
+        {
+            // find the next character that should be escaped
+            size_t pos = scan(data, size);
+
+            // append everything that comes before it
+            output.append(data, pos);
+
+            // are we at the end of the input?
+            if (pos == size) return;
+
+            // append the escaped version of the character
+            switch (data[pos])
             {
-                case '\"': input.replace(pos, 1, "&quot;"); pos += 6; break;
-                case '\'': input.replace(pos, 1, "&apos;"); pos += 6; break;
-                case '<' : input.replace(pos, 1, "&lt;");   pos += 4; break;
-                case '>' : input.replace(pos, 1, "&gt;");   pos += 4; break;
-                case '&' : input.replace(pos, 1, "&amp;");  pos += 5; break;
+                case '\"': output.append("&quot;", 6); break;
+                case '\'': output.append("&apos;", 6); break;
+                case '<' : output.append("&lt;", 4);   break;
+                case '>' : output.append("&gt;", 4);   break;
+                case '&' : output.append("&amp;", 5);  break;
                 default: break;
             }
-        }
 
-        // Return the modified input
-        return input;
+            // continue after the character
+            data += pos + 1;
+            size -= pos + 1;
+        }
     }
 
     /**
@@ -56,6 +56,14 @@ public:
      */
     virtual ~JsonEscaper() {}
 
+    /**
+     *  Find the first character in a buffer that has to be escaped
+     *  @param  data        the buffer
+     *  @param  size        size of the buffer
+     *  @return size_t      position of the character, or size if there is none
+     */
+    static size_t scan(const char *data, size_t size);
+
     /**
      *  Encode the given input
      *  It is probably a good idea to directly modify the input instead of making
@@ -64,37 +72,17 @@ public:
      */
     virtual std::string &encode(std::string &input) const override
     {
+        // most strings do not contain any special characters at all
+        if (scan(input.data(), input.size()) == input.size()) return input;
+
         // we need to make a copy, because there's no 1-1 transformation on characters
         std::string output;
 
         // reserve at least enough bytes
         output.reserve(input.size());
 
-        // iterate over the characters
-        for (const char &c : input)
-        {
-            // in the first 32 bits we always have to escape
-            if (c < 32 || c == '"' || c == '\\')
-            {
-                switch(c) {
-                case '\b':  output.append("\\b"); break;
-                case '\n':  output.append("\\n"); break;
-                case '\r':  output.append("\\r"); break;
-                case '\t':  output.append("\\t"); break;
-                case '\f':  output.append("\\f"); break;
-                case '"':   output.append("\\\""); break;
-                case '\\':  output.append("\\\\"); break;
-                default:    
-                    // write a byte in hex
-                    output.append("\\x");
-                    output.push_back(hex[c >> 4]);
-                    output.push_back(hex[c & 0xf]);
-                }
-            }
-		    
-            // append character normally
-            else output.push_back(c);
-        }
+        // encode into the copy
+        append(input.data(), input.size(), output);
 
         // swap the output and the input
         std::swap(output, input);
@@ -103,6 +91,48 @@ public:
         return input;
     }
 
+    /**
+     *  Encode a buffer and append the encoded data to an output string
+     *  @param  data        the buffer to encode
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the encoded data is appended
+     */
+    virtual void append(const char *data, size_t size, std::string &output) const override
+    {
+        // process the input in runs of characters that do not have to be escaped
+        while (true)
+        {
+            // find the next character that should be escaped
+            size_t pos = scan(data, size);
+
+            // append everything that comes before it
+            output.append(data, pos);
+
+            // are we at the end of the input?
+            if (pos == size) return;
+
+            // the character to escape (control characters, quotes and backslashes)
+            unsigned char c = data[pos];
+            switch(c) {
+            case '\b':  output.append("\\b", 2); break;
+            case '\n':  output.append("\\n", 2); break;
+            case '\r':  output.append("\\r", 2); break;
+            case '\t':  output.append("\\t", 2); break;
+            case '\f':  output.append("\\f", 2); break;
+            case '"':   output.append("\\\"", 2); break;
+            case '\\':  output.append("\\\\", 2); break;
+            default:
+                // write a byte in hex
+                const char encoded[] = { '\\', 'x', hex[c >> 4], hex[c & 0xf] };
+                output.append(encoded, sizeof(encoded));
+            }
+
+            // continue after the character
+            data += pos + 1;
+            size -= pos + 1;
+        }
+    }
+
     /**
      *  Decode the given input
      *  It is probably a good idea to directly modify the input instead of making
@@ -49,6 +49,17 @@ public:
         return input;
     }
 
+    /**
+     *  Append a buffer to an output string, without encoding it
+     *  @param  data        the buffer
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the data is appended
+     */
+    void append(const char *data, size_t size, std::string &output) const override
+    {
+        output.append(data, size);
+    }
+
 };
 
 /**
@@ -4,7 +4,7 @@
  *  An url en/decoder
  *
  *  @author Toon Schoenmakers <toon.schoenmakers@copernica.com>
- *  @copyright 2014 Copernica BV
+ *  @copyright 2014 - 2019 Copernica BV
  */
 
 /**
@@ -27,6 +27,14 @@ public:
      */
     virtual ~UrlEscaper() {}
 
+    /**
+     *  Find the first character in a buffer that has to be encoded
+     *  @param  data        the buffer
+     *  @param  size        size of the buffer
+     *  @return size_t      position of the character, or size if there is none
+     */
+    static size_t scan(const char *data, size_t size);
+
     /**
      *  Encode the given input
      *  It is probably a good idea to directly modify the input instead of making
@@ -34,42 +42,70 @@ public:
      *  @param input
      */
     std::string &encode(std::string &input) const override
+    {
+        // most strings do not contain any special characters at all
+        if (scan(input.data(), input.size()) == input.size()) return input;
+
+        // encode into a new string, and swap it with the input
+        std::string output;
+        output.reserve(input.size() + input.size() / 2);
+        append(input.data(), input.size(), output);
+        input.swap(output);
+
+        // Return the modified input
+        return input;
+    }
+
+    /**
+     *  Encode a buffer and append the encoded data to an output string
+     *  @param  data        the buffer to encode
+     *  @param  size        size of the buffer
+     *  @param  output      the string to which the encoded data is appended
+     */
+    void append(const char *data, size_t size, std::string &output) const override
     {
         // Declare a simple hex table
         const char hex[] = "0123456789ABCDEF";
 
-        // Start looping through the input string
-        for (size_t i = 0; i < input.length(); ++i)
+        // the encoded data is collected in a small buffer, so that we do not have
+        // to call the (relatively expensive) append method for every character
+        char buffer[256];
+        size_t used = 0;
+
+        // process the input in runs of characters that do not have to be encoded
+        while (true)
         {
-            // Grab a reference to the current character so that we can easily overwrite it
-            char &ch = input[i];
+            // find the next character that should be encoded
+            size_t pos = scan(data, size);
+
+            // append everything that comes before it (long runs go straight to the output)
+            if (used + pos > sizeof(buffer) - 3) { output.append(buffer, used); used = 0; }
+            if (pos > sizeof(buffer) - 3) output.append(data, pos);
+            else { memcpy(buffer + used, data, pos); used += pos; }
 
-            // Everything that passes this first test doesn't have to be encoded
-            if (std::isalnum(ch) || ch == '_' || ch == '.' || ch == '-') continue;
+            // are we at the end of the input?
+            if (pos == size) break;
+
+            // the character to encode
+            unsigned char ch = data[pos];
 
             // Spaces become '+'
-            if (ch == ' ') ch = '+';
+            if (ch == ' ') buffer[used++] = '+';
             else
             {
                 // Everything else has to be hex encoded, this is where our hex table comes in
-                // This is mostly some bit magic to look up the correct values from our hex table
-                const char encoded[] = { hex[ch >> 4], hex[ch & 0x0F] };
-
-                // Set the character at our current position to % as required by url encoding
-                ch = '%';
-
-                // Insert the hex encoded value just after the just placed '%'
-                input.insert(i + 1, encoded, sizeof(encoded));
-
-                // And increase our counter by 2 so we jump over our just inserted data that we don't want to overwrite
-                // Although that should not happen as all the hex characters don't pass the first
-                // if statement aka they don't have to be encoded
-                i += 2;
+                buffer[used++] = '%';
+                buffer[used++] = hex[ch >> 4];
+                buffer[used++] = hex[ch & 0x0F];
             }
+
+            // continue after the character
+            data += pos + 1;
+            size -= pos + 1;
         }
 
-        // Return the modified input
-        return input;
+        // append what is left in the buffer
+        output.append(buffer, used);
     }
 
     /**
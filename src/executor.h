@@ -19,6 +19,19 @@ namespace SmartTpl { namespace Internal {
  */
 class Executor
 {
+private:
+    /**
+     *  Lock for the outputs
+     *  @var    std::mutex
+     */
+    std::mutex _mutex;
+
+    /**
+     *  The outputs of a template that is not personalised, by escaper
+     *  @var    std::map
+     */
+    std::map<const Escaper *, std::shared_ptr<const std::string>> _outputs;
+
 protected:
     /**
      *  Protected constructor
@@ -60,6 +73,60 @@ public:
         return true;
     }
 
+    /**
+     *  Is the output of the template always the same? This is the case for
+     *  templates that do not use personalisation data, nor modifiers (which
+     *  come from the data too)
+     *  @return bool
+     */
+    virtual bool constant() const
+    {
+        // we assume it is not
+        return false;
+    }
+
+    /**
+     *  The output of a template that is always the same, it is generated
+     *  the first time that it is needed for an encoding, and shared after that
+     *  @param  encoding    the output encoding
+     *  @return std::shared_ptr
+     *  @throws RunTimeError
+     */
+    std::shared_ptr<const std::string> rendered(const std::string &encoding)
+    {
+        // the escaper for the encoding (unknown encodings share the same one)
+        auto *escaper = Escaper::get(encoding);
+
+        {
+            // other threads could be doing the same
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // perhaps the output is already known
+            auto iter = _outputs.find(escaper);
+            if (iter != _outputs.end()) return iter->second;
+        }
+
+        // the template does not use data, but the handler expects a data object
+        static const Data empty;
+
+        // process the template, without holding the lock, so that other
+        // encodings (and the outputs that are already known) do not have to wait
+        Handler handler(&empty, escaper);
+        process(handler);
+
+        // errors are not remembered, so that they are thrown every time
+        if (handler.failed()) throw RunTimeError(handler.error());
+
+        // the output that we generated
+        auto output = std::make_shared<const std::string>(std::move(handler.output()));
+
+        // other threads could be doing the same
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // if another thread was faster, we use their output, so that everybody shares the same
+        return _outputs.emplace(escaper, std::move(output)).first->second;
+    }
+
 };
 
 /**
@@ -0,0 +1,481 @@
+/**
+ *  ExecutorCache.h
+ *
+ *  The storage behind the TemplateCache class. Compiled executors are stored
+ *  by the hash of the template source (and the tokenizer version), and are
+ *  evicted in least-recently-used order when the memory budget is exceeded.
+ *  Templates that were loaded from a file are also remembered by filename,
+ *  together with the modification time of the file, so that unchanged files
+ *  do not even have to be read again.
+ *
+ *  This class is not thread-safe by itself, the TemplateCache locks it.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class ExecutorCache
+{
+public:
+    /**
+     *  The key of a compiled template
+     */
+    struct Key
+    {
+        /**
+         *  Hash of the template source
+         *  @var uint64_t
+         */
+        uint64_t hash;
+
+        /**
+         *  The tokenizer version
+         *  @var size_t
+         */
+        size_t version;
+
+        /**
+         *  Compare keys
+         *  @param  that
+         *  @return bool
+         */
+        bool operator==(const Key &that) const { return hash == that.hash && version == that.version; }
+    };
+
+    /**
+     *  The state of a file when it was loaded
+     */
+    struct Stamp
+    {
+        /**
+         *  Modification time, in nanoseconds
+         *  @var int64_t
+         */
+        int64_t mtime;
+
+        /**
+         *  Size of the file
+         *  @var int64_t
+         */
+        int64_t size;
+
+        /**
+         *  Compare stamps
+         *  @param  that
+         *  @return bool
+         */
+        bool operator==(const Stamp &that) const { return mtime == that.mtime && size == that.size; }
+    };
+
+private:
+    /**
+     *  Hasher for the keys
+     */
+    struct Hasher
+    {
+        /**
+         *  Calculate the hash
+         *  @param  key
+         *  @return size_t
+         */
+        size_t operator()(const Key &key) const { return key.hash ^ key.version; }
+    };
+
+    /**
+     *  A compiled template
+     */
+    struct Entry
+    {
+        /**
+         *  The key
+         *  @var Key
+         */
+        Key key;
+
+        /**
+         *  The template source, so that hash collisions can be detected (this
+         *  is empty for shared libraries, those are only found by filename)
+         *  @var std::string
+         */
+        std::string source;
+
+        /**
+         *  The compiled template
+         *  @var std::shared_ptr<Executor>
+         */
+        std::shared_ptr<Executor> executor;
+
+        /**
+         *  Estimated memory usage
+         *  @var size_t
+         */
+        size_t cost;
+
+        /**
+         *  The files (names and tokenizer versions) that refer to the entry
+         *  @var std::vector
+         */
+        std::vector<std::pair<std::string,size_t>> files;
+    };
+
+    /**
+     *  A file that was loaded
+     */
+    struct File
+    {
+        /**
+         *  The state of the file when it was loaded
+         *  @var Stamp
+         */
+        Stamp stamp;
+
+        /**
+         *  The entry with the compiled template
+         *  @var std::list<Entry>::iterator
+         */
+        std::list<Entry>::iterator entry;
+    };
+
+    /**
+     *  The entries, the most recently used entry comes first
+     *  @var std::list<Entry>
+     */
+    std::list<Entry> _entries;
+
+    /**
+     *  The entries by key
+     *  @var std::unordered_map
+     */
+    std::unordered_map<Key, std::list<Entry>::iterator, Hasher> _keys;
+
+    /**
+     *  The files by name and tokenizer version
+     *  @var std::map
+     */
+    std::map<std::pair<std::string,size_t>, File> _files;
+
+    /**
+     *  The memory budget
+     *  @var size_t
+     */
+    size_t _budget;
+
+    /**
+     *  The estimated memory that is in use
+     *  @var size_t
+     */
+    size_t _used = 0;
+
+    /**
+     *  Mark an entry as the most recently used one
+     *  @param  iter
+     */
+    void touch(std::list<Entry>::iterator iter)
+    {
+        _entries.splice(_entries.begin(), _entries, iter);
+    }
+
+    /**
+     *  Remove an entry
+     *  @param  iter
+     */
+    void remove(std::list<Entry>::iterator iter)
+    {
+        // forget the files that refer to the entry
+        for (const auto &name : iter->files) _files.erase(name);
+
+        // forget the key (entries of shared libraries are not stored by key)
+        auto key = _keys.find(iter->key);
+        if (key != _keys.end() && key->second == iter) _keys.erase(key);
+
+        // the memory is released (templates that still use the executor keep it alive)
+        _used -= iter->cost;
+        _entries.erase(iter);
+    }
+
+    /**
+     *  Remove an entry if it can no longer be found
+     *
+     *  Entries of shared libraries are only found by filename, so they have
+     *  to be removed when the file no longer refers to them. Otherwise they
+     *  would take up the budget until they are evicted.
+     *
+     *  @param  iter
+     */
+    void orphan(std::list<Entry>::iterator iter)
+    {
+        // entries that can be found by key are still useful
+        auto key = _keys.find(iter->key);
+        if (key != _keys.end() && key->second == iter) return;
+
+        // and so are entries that are used by a file
+        if (!iter->files.empty()) return;
+
+        // nobody can find the entry anymore
+        remove(iter);
+    }
+
+    /**
+     *  Forget that a file refers to an entry
+     *  @param  iter        the entry
+     *  @param  name        the filename and tokenizer version
+     */
+    void detach(std::list<Entry>::iterator iter, const std::pair<std::string,size_t> &name)
+    {
+        // remove the name from the entry
+        auto &files = iter->files;
+        files.erase(std::find(files.begin(), files.end(), name));
+    }
+
+    /**
+     *  Remember the entry that holds the template of a file
+     *  @param  name        the filename and tokenizer version
+     *  @param  file        the state of the file and the entry
+     */
+    void assign(const std::pair<std::string,size_t> &name, const File &file)
+    {
+        // is the file already known?
+        auto iter = _files.find(name);
+        if (iter == _files.end())
+        {
+            // the entry knows about the file too
+            file.entry->files.push_back(name);
+            return (void)_files.emplace(name, file);
+        }
+
+        // replace the entry that the file refers to
+        auto previous = iter->second.entry;
+        iter->second = file;
+
+        // nothing else changes if the file still refers to the same entry
+        if (previous == file.entry) return;
+
+        // move the file to the other entry
+        detach(previous, name);
+        file.entry->files.push_back(name);
+
+        // the previous entry may now be unreachable
+        orphan(previous);
+    }
+
+    /**
+     *  Remove the least recently used entries until we are within budget
+     */
+    void evict()
+    {
+        // the most recently used entry is never removed, even if it is too big on its own
+        while (_used > _budget && _entries.size() > 1) remove(std::prev(_entries.end()));
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  budget      the memory budget, in bytes
+     */
+    ExecutorCache(size_t budget) : _budget(budget) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~ExecutorCache() = default;
+
+    /**
+     *  Estimate the memory that is used by a compiled template
+     *  @param  size        size of the template source
+     *  @return size_t
+     */
+    static size_t estimate(size_t size)
+    {
+        // the source is kept for comparison, and the syntax tree and the
+        // generated code take a couple of times the size of the source
+        return size * 4 + 16384;
+    }
+
+    /**
+     *  Find a compiled template by its source
+     *  @param  key         the key
+     *  @param  data        the template source
+     *  @param  size        size of the source
+     *  @return std::shared_ptr<Executor>
+     */
+    std::shared_ptr<Executor> find(const Key &key, const char *data, size_t size)
+    {
+        // look up the key
+        auto iter = _keys.find(key);
+        if (iter == _keys.end()) return nullptr;
+
+        // check if the source is really the same (and not just the hash)
+        auto &source = iter->second->source;
+        if (source.size() != size || memcmp(source.data(), data, size) != 0) return nullptr;
+
+        // this is now the most recently used template
+        touch(iter->second);
+
+        // expose the executor
+        return iter->second->executor;
+    }
+
+    /**
+     *  Find a compiled template by its filename
+     *  @param  name        the filename
+     *  @param  version     the tokenizer version
+     *  @param  stamp       the current state of the file
+     *  @return std::shared_ptr<Executor>
+     */
+    std::shared_ptr<Executor> find(const std::string &name, size_t version, const Stamp &stamp)
+    {
+        // look up the file
+        auto iter = _files.find(std::make_pair(name, version));
+        if (iter == _files.end()) return nullptr;
+
+        // if the file was changed, the entry might still be in use for another file with the same content
+        if (!(iter->second.stamp == stamp))
+        {
+            // forget the file, and the entry if nothing else uses it
+            auto entry = iter->second.entry;
+            detach(entry, iter->first);
+            _files.erase(iter);
+            orphan(entry);
+
+            // not found
+            return nullptr;
+        }
+
+        // this is now the most recently used template
+        touch(iter->second.entry);
+
+        // expose the executor
+        return iter->second.entry->executor;
+    }
+
+    /**
+     *  Store a compiled template
+     *
+     *  If another thread stored the same template in the meantime, that
+     *  executor is returned instead, so that only one executor remains in use.
+     *
+     *  @param  key         the key
+     *  @param  source      the template source
+     *  @param  executor    the compiled template
+     *  @return std::shared_ptr<Executor>
+     */
+    std::shared_ptr<Executor> store(const Key &key, std::string &&source, const std::shared_ptr<Executor> &executor)
+    {
+        // is there already an entry with this key?
+        auto iter = _keys.find(key);
+        if (iter != _keys.end())
+        {
+            // if this is the same template, we use the one that is already there
+            auto &existing = iter->second->source;
+            if (existing == source) { touch(iter->second); return iter->second->executor; }
+
+            // a hash collision, the new template is simply not cached
+            return executor;
+        }
+
+        // add the entry in front
+        size_t cost = estimate(source.size());
+        _entries.push_front(Entry{ key, std::move(source), executor, cost, {} });
+        _keys[key] = _entries.begin();
+        _used += cost;
+
+        // stay within the budget
+        evict();
+
+        // expose the executor
+        return executor;
+    }
+
+    /**
+     *  Store a compiled shared library, these can only be found by filename
+     *  @param  name        the filename
+     *  @param  version     the tokenizer version
+     *  @param  stamp       the state of the file
+     *  @param  executor    the loaded library
+     */
+    void store(const std::string &name, size_t version, const Stamp &stamp, const std::shared_ptr<Executor> &executor)
+    {
+        // add the entry in front, the code is in the library, so it does not count for much
+        _entries.push_front(Entry{ Key{ 0, 0 }, std::string(), executor, estimate(0), {} });
+        _used += _entries.front().cost;
+
+        // remember the file (a library that was loaded before is replaced)
+        assign(std::make_pair(name, version), File{ stamp, _entries.begin() });
+
+        // stay within the budget
+        evict();
+    }
+
+    /**
+     *  Remember that a file holds the template that was stored with a certain key
+     *  @param  name        the filename
+     *  @param  version     the tokenizer version
+     *  @param  stamp       the state of the file
+     *  @param  key         the key of the template
+     *  @param  executor    the compiled template of the file
+     */
+    void link(const std::string &name, size_t version, const Stamp &stamp, const Key &key, const std::shared_ptr<Executor> &executor)
+    {
+        // the template must be (still) stored, and it must not be another template
+        // with the same key (because of a hash collision the file may not be cached)
+        auto iter = _keys.find(key);
+        if (iter == _keys.end() || iter->second->executor != executor) return;
+
+        // remember the file
+        assign(std::make_pair(name, version), File{ stamp, iter->second });
+    }
+
+    /**
+     *  Change the memory budget
+     *  @param  budget
+     */
+    void budget(size_t budget)
+    {
+        // store the budget
+        _budget = budget;
+
+        // and stay within it
+        evict();
+    }
+
+    /**
+     *  The memory budget
+     *  @return size_t
+     */
+    size_t budget() const { return _budget; }
+
+    /**
+     *  The estimated memory in use
+     *  @return size_t
+     */
+    size_t used() const { return _used; }
+
+    /**
+     *  Number of compiled templates
+     *  @return size_t
+     */
+    size_t size() const { return _entries.size(); }
+
+    /**
+     *  Remove all templates
+     */
+    void clear()
+    {
+        _files.clear();
+        _keys.clear();
+        _entries.clear();
+        _used = 0;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
@@ -44,6 +44,12 @@ public:
      */
     virtual Type type() const override { return Type::String; }
 
+    /**
+     *  The literal that is wrapped
+     *  @return Literal
+     */
+    const Literal &literal() const { return *_value; }
+
      /**
      *  Generate the output that leaves a pointer to the variable
      *  @param  generator
@@ -53,6 +59,17 @@ public:
         // generate the code to get a variable pointer to a string
         generator->pointerString(_value.get());
     }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // the literal does not depend on anything
+        return true;
+    }
 };
 
 /**
@@ -51,6 +51,31 @@ public:
         // create an inverted generator
         generator->negateBoolean(_expression.get());
     }
+
+    /**
+     *  Optimize the expression before code is generated for it
+     *  @return Expression
+     */
+    virtual Expression *optimize() override
+    {
+        // optimize the expression that is inverted
+        Expression::optimize(_expression);
+
+        // if that is a literal, we can invert it right away
+        auto *literal = dynamic_cast<Literal*>(_expression.get());
+        return literal ? new LiteralBoolean(!literal->booleanValue()) : nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // we depend on the expression that is inverted
+        return _expression->variables(names);
+    }
 };
 
 /**
@@ -113,6 +113,43 @@ public:
     {
         generator->write(this);
     }
+
+    /**
+     *  Optimize the expression before code is generated for it
+     *
+     *  Expressions that can be evaluated at compile time (because they only
+     *  work on literals) return a new expression (normally a literal) that
+     *  should replace them. Expressions that can not be simplified return a
+     *  nullptr, but they may still have optimized their sub-expressions.
+     *
+     *  @return Expression      the replacement, or nullptr to keep this expression
+     */
+    virtual Expression *optimize() { return nullptr; }
+
+    /**
+     *  Optimize an expression, and replace it if it could be simplified
+     *  @param  expression
+     */
+    static void optimize(std::unique_ptr<Expression> &expression)
+    {
+        // ask the expression for a replacement
+        auto *replacement = expression->optimize();
+
+        // replace it if there is one
+        if (replacement) expression.reset(replacement);
+    }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *
+     *  This is used to find out if an expression gives the same result on
+     *  every iteration of a loop. Expressions that may also depend on something
+     *  else (like the modifiers that are registered by the user) return false.
+     *
+     *  @param  names           set that is filled with the variable names
+     *  @return bool            can the result be derived from these variables only?
+     */
+    virtual bool variables(std::set<std::string> &names) const { return false; }
 };
 
 /**
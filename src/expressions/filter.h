@@ -22,13 +22,64 @@ private:
      *  The base expression
      *  @var    Variable
      */
-    std::unique_ptr<const Variable> _variable;
+    std::unique_ptr<Variable> _variable;
 
     /**
      *  The modifiers that should be applied
      *  @var    Modifiers
      */
-    std::unique_ptr<const Modifiers> _modifiers;
+    std::unique_ptr<Modifiers> _modifiers;
+
+    /**
+     *  Find a built-in modifier that has no side effects, and that always
+     *  returns the same string for the same input and parameters, so that it
+     *  can already be applied at compile time (or just once per loop)
+     *  @param  name
+     *  @return Modifier    nullptr if the modifier can only be applied at runtime
+     */
+    static Modifier *pure(const std::string &name)
+    {
+        // the modifiers that may be applied at compile time
+        static const std::set<std::string> names({
+            "toupper", "upper", "tolower", "lower", "capitalize", "ucfirst",
+            "trim", "nl2br", "spacify", "indent", "replace", "cat", "truncate",
+            "substr", "regex_replace", "number_format", "urlencode", "base64_encode",
+            "escape"
+        });
+
+        // the object that holds the built-in modifiers
+        static const Data builtins;
+
+        // look up the modifier
+        return names.count(name) ? builtins.modifier(name.data(), name.size()) : nullptr;
+    }
+
+    /**
+     *  Build the parameters for a modifier at compile time, the same way as
+     *  the generated code would do it at runtime
+     *  @param  expression  the modifier expression
+     *  @param  result      the parameters to fill
+     */
+    static void parameters(const ModifierExpression &expression, SmartTpl::Parameters &result)
+    {
+        // skip if there are no parameters
+        if (!expression.parameters()) return;
+
+        // loop through the parameters (the parser only accepts literals here)
+        for (const auto &parameter : *expression.parameters())
+        {
+            // the literal value
+            auto *literal = static_cast<const Literal*>(parameter.get());
+
+            // add it with its own type
+            switch (literal->type()) {
+            case Type::Boolean: result.emplace_back(literal->booleanValue()); break;
+            case Type::Integer: result.emplace_back(literal->integerValue()); break;
+            case Type::Double:  result.emplace_back(literal->doubleValue()); break;
+            default:            result.emplace_back(literal->stringValue()); break;
+            }
+        }
+    }
 
 public:
     /**
@@ -36,7 +87,7 @@ public:
      *  @param  expression
      *  @param  modifiers
      */
-    Filter(const Variable *variable, const Modifiers *modifiers) :
+    Filter(Variable *variable, Modifiers *modifiers) :
         _variable(variable), _modifiers(modifiers) {}
 
     /**
@@ -120,6 +171,95 @@ public:
     {
         generator->output(this);
     }
+
+    /**
+     *  Optimize the expression before code is generated for it
+     *
+     *  If the filter is applied to a literal, the leading modifiers that are
+     *  built-in and pure are applied right away. We stay a filter though (even
+     *  when no modifiers are left), because that keeps the type and the
+     *  escaping of the output the same.
+     *
+     *  @return Expression
+     */
+    virtual Expression *optimize() override
+    {
+        // optimize the variable, which is never replaced
+        _variable->optimize();
+
+        // modifiers can only be applied at compile time to literals
+        auto *anonymous = dynamic_cast<const AnonymousVariable*>(_variable.get());
+        if (anonymous == nullptr) return nullptr;
+
+        // the value, just like it is created at runtime
+        VariantValue value(anonymous->literal().stringValue());
+
+        // number of modifiers that were applied
+        size_t applied = 0;
+
+        // apply the modifiers one by one
+        for (const auto &expression : *_modifiers)
+        {
+            // stop at the first modifier that has to run at runtime
+            auto *modifier = pure(expression->token());
+            if (modifier == nullptr) break;
+
+            // construct the parameters
+            SmartTpl::Parameters params;
+            parameters(*expression, params);
+
+            try
+            {
+                // apply the modifier
+                value = modifier->modify(value, params);
+            }
+            catch (const Modifier::NoModification &)
+            {
+                // the value stays the same
+            }
+            catch (...)
+            {
+                // leave this modifier (and the error it gives) to the runtime
+                break;
+            }
+
+            // one more modifier was applied
+            applied += 1;
+        }
+
+        // leave the filter alone if nothing could be applied
+        if (applied == 0) return nullptr;
+
+        // get the result (null characters can not be stored in a literal)
+        auto result = value.toString();
+        if (result.find('\0') != std::string::npos) return nullptr;
+
+        // remove the modifiers that were applied, and use the result as input for the others
+        _modifiers->remove(applied);
+        _variable.reset(new AnonymousVariable(new LiteralString(std::move(result))));
+
+        // we stay a filter
+        return nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // every modifier should be pure (the parameters are always literals),
+        // the "raw" modifier only affects the escaping, so that one is fine too
+        for (const auto &expression : *_modifiers)
+        {
+            // check the modifier
+            if (expression->token() != "raw" && pure(expression->token()) == nullptr) return false;
+        }
+
+        // we depend on the variable that is modified
+        return _variable->variables(names);
+    }
 };
 
 /**
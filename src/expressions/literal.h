@@ -29,6 +29,28 @@ public:
      *  Destructor
      */
     virtual ~Literal() {}
+
+    /**
+     *  The value of the literal, converted to the different types in exactly
+     *  the same way as the generated code would do it. These are used for
+     *  evaluating expressions at compile time.
+     *  @return mixed
+     */
+    virtual integer_t integerValue() const = 0;
+    virtual double doubleValue() const = 0;
+    virtual bool booleanValue() const = 0;
+    virtual std::string stringValue() const = 0;
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // a literal does not depend on anything
+        return true;
+    }
 };
 
 /**
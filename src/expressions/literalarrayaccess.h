@@ -55,6 +55,30 @@ public:
         // generate the code to access a member
         generator->varPointer(_var.get(), *_key);
     }
+
+    /**
+     *  Optimize the expression before code is generated for it
+     *  @return Expression
+     */
+    virtual Expression *optimize() override
+    {
+        // optimize the variable, which is never replaced
+        _var->optimize();
+
+        // we stay a variable
+        return nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // the key is a literal, so only the variable counts
+        return _var->variables(names);
+    }
 };
 
 /**
@@ -42,6 +42,15 @@ public:
      */
     Type type() const override { return Type::Boolean; }
 
+    /**
+     *  The value of the literal, converted to the different types
+     *  @return mixed
+     */
+    integer_t integerValue() const override { return _value ? 1 : 0; }
+    double doubleValue() const override { return _value ? 1 : 0; }
+    bool booleanValue() const override { return _value; }
+    std::string stringValue() const override { return std::string(); }
+
     /**
      *  Generate the code to get the const char * to the expression
      *  @param  generator
@@ -38,6 +38,13 @@ public:
     LiteralDouble(Token *token)
     : _value(std::strtod(token->c_str(), nullptr)), _token(token) {}
 
+    /**
+     *  Constructor for a value that was calculated at compile time
+     *  @param  value
+     */
+    LiteralDouble(double value)
+    : _value(value), _token(new Token(Number::toString(value))) {}
+
     /**
      *  Destructor
      */
@@ -49,6 +56,15 @@ public:
      */
     Type type() const override { return Type::Double; }
 
+    /**
+     *  The value of the literal, converted to the different types
+     *  @return mixed
+     */
+    integer_t integerValue() const override { return (integer_t)_value; }
+    double doubleValue() const override { return _value; }
+    bool booleanValue() const override { return _value != 0; }
+    std::string stringValue() const override { return *_token; }
+
     /**
      *  Generate the code to get the const char * to the expression
      *  @param  generator
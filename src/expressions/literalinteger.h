@@ -38,6 +38,13 @@ public:
     LiteralInteger(Token *token)
     : _value(std::strtoll(token->c_str(), nullptr, 10)), _token(token) {}
 
+    /**
+     *  Constructor for a value that was calculated at compile time
+     *  @param  value
+     */
+    LiteralInteger(integer_t value)
+    : _value(value), _token(new Token(Number::toString(value))) {}
+
     /**
      *  Destructor
      */
@@ -49,6 +56,15 @@ public:
      */
     Type type() const override { return Type::Integer; }
 
+    /**
+     *  The value of the literal, converted to the different types
+     *  @return mixed
+     */
+    integer_t integerValue() const override { return _value; }
+    double doubleValue() const override { return _value; }
+    bool booleanValue() const override { return _value != 0; }
+    std::string stringValue() const override { return *_token; }
+
     /**
      *  Generate the code to get the const char * to the expression
      *  @param  generator
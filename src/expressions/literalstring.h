@@ -31,17 +31,38 @@ public:
      */
     LiteralString(Token *value) : _value(value) {}
 
+    /**
+     *  Constructor for a value that was calculated at compile time
+     *  @param  value
+     */
+    LiteralString(std::string value) : _value(new Token(std::move(value))) {}
+
     /**
      *  Destructor
      */
     virtual ~LiteralString() {}
 
+    /**
+     *  The actual value
+     *  @return std::string
+     */
+    const std::string &value() const { return *_value; }
+
     /**
      *  The return type of the expression
      *  @return Type
      */
     Type type() const override { return Type::String; }
 
+    /**
+     *  The value of the literal, converted to the different types
+     *  @return mixed
+     */
+    integer_t integerValue() const override { return std::strtoll(_value->c_str(), nullptr, 10); }
+    double doubleValue() const override { return std::strtod(_value->c_str(), nullptr); }
+    bool booleanValue() const override { return !_value->empty(); }
+    std::string stringValue() const override { return *_value; }
+
     /**
      *  Generate the code to get the const char * to the expression
      *  @param  generator
@@ -53,6 +53,17 @@ public:
         generator->varPointer(*_name);
     }
 
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // we only depend on ourselves
+        names.insert(*_name);
+        return true;
+    }
 };
 
 /**
@@ -54,6 +54,31 @@ public:
     {
         generator->varPointer(_var.get(), _key.get());
     }
+
+    /**
+     *  Optimize the expression before code is generated for it
+     *  @return Expression
+     */
+    virtual Expression *optimize() override
+    {
+        // optimize the variable and the key, the variable itself is never replaced
+        _var->optimize();
+        Expression::optimize(_key);
+
+        // we stay a variable
+        return nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // we depend on both the variable and the key
+        return _var->variables(names) && _key->variables(names);
+    }
 };
 
 /**
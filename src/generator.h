@@ -63,6 +63,22 @@ public:
      */
     virtual void output(const Filter *filter) = 0;
 
+    /**
+     *  Generate the code to forget the cached output of a loop invariant expression
+     *  @param  slot                the cache slot
+     *  @param  root                the variable that the output depends on (may be a nullptr)
+     */
+    virtual void cacheReset(size_t slot, const Variable *root) = 0;
+
+    /**
+     *  Generate the code to output a loop invariant variable, the output is
+     *  generated once, and written from the cache slot from then on
+     *  @param  slot                the cache slot
+     *  @param  variable            the variable (or filter) to output
+     *  @param  escape              should the output be escaped?
+     */
+    virtual void cachedOutput(size_t slot, const Variable *variable, bool escape) = 0;
+
     /**
      *  Generate the code to write an expression as a string
      *  @param  expression          the expression to write as a string
@@ -25,6 +25,18 @@ private:
      */
     std::string _buffer;
 
+    /**
+     *  Optional sink to which the output is flushed when the buffer is full
+     *  @var    Sink
+     */
+    Sink *_sink = nullptr;
+
+    /**
+     *  Size of the buffer at which it is flushed to the sink
+     *  @var    size_t
+     */
+    size_t _chunksize = 0;
+
     /**
      *  The underlying data
      *  @var    Data
@@ -37,6 +49,13 @@ private:
      */
     const Escaper *_encoder;
 
+    /**
+     *  Arena for the temporary values that are created during the run
+     *  @see temporary
+     *  @var    Arena
+     */
+    Arena _arena;
+
     /**
      *  Compare functor necessary for the map
      */
@@ -54,12 +73,32 @@ private:
         }
     };
 
+    /**
+     *  A local variable
+     */
+    struct Local
+    {
+        /**
+         *  The current value, this points to the variant below, or to a value
+         *  that is held by the data object (or managed by the handler)
+         *  @var    Value
+         */
+        const Value *value = nullptr;
+
+        /**
+         *  Copy of the assigned variant, so that the local variable does not
+         *  depend on the lifetime of a temporary value
+         *  @var    VariantValue
+         */
+        VariantValue variant;
+    };
+
     /**
      *  This map will contain values assigned during runtime, these can be
      *  assigned using "assign .. to ..", or the magic values inside
      *  foreach loops
      */
-    std::map<const char *, const Value*, cmp_str> _local_values;
+    std::map<const char *, Local, cmp_str> _local_values;
 
     /**
      *  Will contain the local values that were created just here and should
@@ -68,19 +107,110 @@ private:
      *  Can also contain externally created Values that were made managed using manageValue(Value*)
      *  @see manageValue
      */
-    std::list<std::unique_ptr<const Value>> _managed_local_values;
+    std::vector<std::unique_ptr<const Value>> _managed_local_values;
+
+    /**
+     *  The same values as in _managed_local_values, but in a set so that we
+     *  can check in constant time whether we already manage a value
+     *  @see manageValue
+     */
+    std::unordered_set<const Value*> _owned_values;
 
     /**
      *  List of iterators that we are managing
      *  @see manageIterator
      */
-    std::list<std::unique_ptr<Iterator>> _managed_iterators;
+    std::vector<std::unique_ptr<Iterator>> _managed_iterators;
+
+    /**
+     *  List of parameters that we are managing, these objects are recycled
+     *  when the handler is reused, only the first _parameters_used are in use
+     *  @see newParameters
+     */
+    std::vector<std::unique_ptr<SmartTpl::Parameters>> _managed_parameters;
+
+    /**
+     *  Number of parameter objects that are in use
+     *  @var size_t
+     */
+    size_t _parameters_used = 0;
+
+    /**
+     *  The slots of the template that is being run
+     *  @see bind
+     *  @var    Slots
+     */
+    const Slots *_slots = nullptr;
+
+    /**
+     *  The values of the slots in the data object, and the local variables
+     *  that override them (nullptr if there is no such local variable)
+     *  @var    std::vector
+     */
+    std::vector<const Value*> _slot_values;
+    std::vector<Local*> _slot_locals;
 
     /**
-     *  List of parameters that we are managing
-     *  @see manageParameters
+     *  The modifiers of the template that is being run, ordered by slot index
+     *  @var    std::vector
      */
-    std::list<std::unique_ptr<SmartTpl::Parameters>> _managed_parameters;
+    std::vector<Modifier*> _slot_modifiers;
+
+    /**
+     *  Find or create a local variable
+     *  @param  key         name of the variable
+     *  @param  size        size of the name
+     *  @return Local
+     */
+    Local &local(const char *key, size_t size)
+    {
+        // do we already have this local variable?
+        auto iter = _local_values.find(key);
+        if (iter != _local_values.end()) return iter->second;
+
+        // create it
+        auto &local = _local_values[key];
+
+        // if the variable is also accessed via a slot, the slot should use
+        // the local variable from now on
+        auto index = _slots ? _slots->find(key, size) : Slots::npos;
+        if (index != Slots::npos) _slot_locals[index] = &local;
+
+        // done
+        return local;
+    }
+
+    /**
+     *  A value scope, everything that is created inside a scope is
+     *  destructed when the scope is left
+     *  @see enterScope
+     */
+    struct Scope
+    {
+        /**
+         *  Position in the arena when the scope was entered
+         *  @var    Arena::Mark
+         */
+        Arena::Mark mark;
+
+        /**
+         *  Number of managed iterators when the scope was entered
+         *  @var    size_t
+         */
+        size_t iterators;
+
+        /**
+         *  Number of parameter objects in use when the scope was entered
+         *  @var    size_t
+         */
+        size_t parameters;
+    };
+
+    /**
+     *  Stack of scopes that are currently active
+     *  @var    std::vector<Scope>
+     */
+    std::vector<Scope> _scopes;
 
     /**
      *  A list of strings that are meant to kept in scope so their buffers remain valid
@@ -95,32 +225,351 @@ private:
      */
     std::string _error;
 
+    /**
+     *  The output of a loop invariant expression, that is remembered while the
+     *  loop is running (see CachedOutputStatement)
+     */
+    struct Cache
+    {
+        /**
+         *  Was the output already generated?
+         *  @var bool
+         */
+        bool filled = false;
+
+        /**
+         *  Should the output be generated every time? This is the case for
+         *  callbacks that are not cacheable
+         *  @var bool
+         */
+        bool disabled = false;
+
+        /**
+         *  The escaped output
+         *  @var std::string
+         */
+        std::string data;
+    };
+
+    /**
+     *  The caches, indexed by the slot numbers that were assigned at compile time
+     *  @var std::vector<Cache>
+     */
+    std::vector<Cache> _caches;
+
+    /**
+     *  A segment of the output, in segmented mode
+     */
+    struct Segment
+    {
+        /**
+         *  Pointer to static text, or nullptr if the segment is stored in the buffer
+         *  @var const char *
+         */
+        const char *data;
+
+        /**
+         *  Offset in the buffer (only for segments that are stored in the buffer)
+         *  @var size_t
+         */
+        size_t offset;
+
+        /**
+         *  Size of the segment
+         *  @var size_t
+         */
+        size_t size;
+    };
+
+    /**
+     *  Should the static text be referred to instead of copied?
+     *  @var bool
+     */
+    bool _segmented = false;
+
+    /**
+     *  The segments that were completed so far
+     *  @var std::vector<Segment>
+     */
+    std::vector<Segment> _segments;
+
+    /**
+     *  Offset in the buffer where the output starts that is not yet part of a segment
+     *  @var size_t
+     */
+    size_t _pending = 0;
+
+    /**
+     *  Turn the output in the buffer that is not yet part of a segment into a segment
+     */
+    void closeSegment()
+    {
+        // add the segment if there is output
+        if (_buffer.size() > _pending) _segments.push_back(Segment{ nullptr, _pending, _buffer.size() - _pending });
+
+        // the next segment starts here
+        _pending = _buffer.size();
+    }
+
+    /**
+     *  Get access to the buffer of a value that holds a string
+     *  @param  value       the value
+     *  @param  data        filled with a pointer to the buffer
+     *  @param  size        filled with the size of the buffer
+     *  @return bool        false if the value is not a string (or a derived class that could override toString())
+     */
+    static bool stringBuffer(const Value *value, const char *&data, size_t &size)
+    {
+        // most values are variants, these know whether they hold a string
+        if (typeid(*value) == typeid(VariantValue)) return static_cast<const VariantValue *>(value)->string(data, size);
+
+        // the values from the data object may be regular strings
+        if (typeid(*value) != typeid(StringValue)) return false;
+
+        // expose the buffer of the string
+        auto &string = static_cast<const StringValue *>(value)->value();
+        data = string.data();
+        size = string.size();
+        return true;
+    }
+
+    /**
+     *  Is a value a callback that has to be called every time?
+     *  @param  value
+     *  @return bool
+     */
+    static bool changing(const Value *value)
+    {
+        // only callbacks can change while the template runs
+        auto *callback = dynamic_cast<const CallbackValue*>(value);
+        return callback != nullptr && !callback->cacheable();
+    }
+
+    /**
+     *  Flush the buffer to the sink if it has grown beyond the chunk size
+     */
+    void check()
+    {
+        // nothing to do if we're not streaming or if the buffer is not yet full
+        if (_sink == nullptr || _buffer.size() < _chunksize) return;
+
+        // pass the buffer to the sink
+        flush();
+    }
+
 public:
     /**
      *  Constructor
      *  @param  data        pointer to the data
      *  @param  escaper     the escaper to use for the printed variables
+     *  @param  heap        allocate the temporary values on the heap instead of in the arena
      */
-    Handler(const Data *data, const Escaper *escaper) : _data(data), _encoder(escaper)
+    Handler(const Data *data, const Escaper *escaper, bool heap = false) : _data(data), _encoder(escaper), _arena(heap)
     {
         // we reserve some space in the output buffer, so that it is not
         // necessary to reallocate all the time (which is slow)
         _buffer.reserve(4096);
     }
 
+    /**
+     *  Constructor for streaming output
+     *  @param  data        pointer to the data
+     *  @param  escaper     the escaper to use for the printed variables
+     *  @param  sink        the sink to which the output is flushed in chunks
+     */
+    Handler(const Data *data, const Escaper *escaper, Sink *sink) :
+        _sink(sink), _chunksize(std::max(sink->chunksize(), size_t(1))), _data(data), _encoder(escaper)
+    {
+        // the buffer never grows much beyond the chunk size
+        _buffer.reserve(_chunksize);
+    }
+
     /**
      *  Destructor
      */
     virtual ~Handler() {}
 
     /**
-     *  Write data to the buffer
+     *  Prepare the handler for a new run
+     *
+     *  All state of the previous run is cleared, but the buffer and the
+     *  containers keep their capacity, so that reusing a handler does not
+     *  have to allocate all that memory again.
+     *
+     *  @param  data        pointer to the data
+     *  @param  escaper     the escaper to use for the printed variables
+     *  @param  segmented   should the output be collected as segments?
+     */
+    void reset(const Data *data, const Escaper *escaper, bool segmented = false)
+    {
+        // forget about the previous run
+        cleanup();
+
+        // start with an empty buffer
+        _buffer.clear();
+
+        // we're not streaming
+        _sink = nullptr;
+
+        // there are no segments yet
+        _segmented = segmented;
+        _segments.clear();
+        _pending = 0;
+
+        // use the new data and escaper
+        _data = data;
+        _encoder = escaper;
+
+        // no errors yet
+        _error.clear();
+    }
+
+    /**
+     *  Release all values that were created during the run
+     *
+     *  The output buffer is left alone, so that it can still be accessed.
+     */
+    void cleanup()
+    {
+        // the local values refer to the managed values, so they go first
+        _slots = nullptr;
+        _slot_values.clear();
+        _slot_locals.clear();
+        _slot_modifiers.clear();
+        _local_values.clear();
+        _managed_strings.clear();
+
+        // destruct the values, but keep the capacity of the containers
+        _owned_values.clear();
+        _managed_local_values.clear();
+        _managed_iterators.clear();
+
+        // destruct the temporary values, but keep the memory
+        _arena.reset();
+
+        // the parameter objects themselves are kept for the next run
+        for (size_t i = 0; i < _parameters_used; ++i) _managed_parameters[i]->clear();
+        _parameters_used = 0;
+
+        // scopes that were not left (because of an error) are gone too
+        _scopes.clear();
+    }
+
+    /**
+     *  Bind the slots of a template to the data
+     *
+     *  This should be called right before the template is run, the slots
+     *  of the variables must stay valid for the rest of the run
+     *
+     *  @param  slots       the variables that are used by the template
+     *  @param  modifiers   the modifiers that are used by the template
+     */
+    void bind(const Slots &slots, const Slots &modifiers)
+    {
+        // remember the slots
+        _slots = &slots;
+
+        // look up all variables in the data
+        if (_data) _data->bind(slots.names(), slots.hashes(), _slot_values);
+        else _slot_values.assign(slots.size(), nullptr);
+
+        // there are no local variables yet
+        _slot_locals.assign(slots.size(), nullptr);
+
+        // resolve all modifiers
+        _slot_modifiers.resize(modifiers.size());
+        for (size_t i = 0; i < modifiers.size(); ++i)
+        {
+            // get the name, and look it up in the data
+            const auto &name = modifiers.name(i);
+            _slot_modifiers[i] = _data ? _data->modifier(name.data(), name.size(), modifiers.hashes()[i]) : nullptr;
+        }
+    }
+
+    /**
+     *  Enter a new value scope
+     *
+     *  All temporary values, iterators and parameters that are created after
+     *  this call are destructed when leaveScope() is called. This is used for
+     *  every iteration of a foreach loop, so that the memory usage does not
+     *  grow with the number of iterations. Local variables are not affected,
+     *  they hold their own copy of the assigned values.
+     */
+    void enterScope()
+    {
+        // remember the current positions
+        _scopes.push_back(Scope{ _arena.mark(), _managed_iterators.size(), _parameters_used });
+    }
+
+    /**
+     *  Leave the most recently entered value scope
+     */
+    void leaveScope()
+    {
+        // there should be a scope
+        if (_scopes.empty()) return;
+
+        // the scope that we're leaving
+        auto scope = _scopes.back();
+        _scopes.pop_back();
+
+        // the cached strings of the temporaries that are about to be destructed must be
+        // removed, otherwise a new temporary at the same address would find them
+        if (!_managed_strings.empty()) _arena.since(scope.mark, [this](void *value) {
+            _managed_strings.erase(static_cast<const Value *>(value));
+        });
+
+        // destruct the temporaries
+        _arena.rewind(scope.mark);
+
+        // destruct the iterators that were created in the scope
+        _managed_iterators.erase(_managed_iterators.begin() + scope.iterators, _managed_iterators.end());
+
+        // the parameter objects can be recycled
+        for (size_t i = scope.parameters; i < _parameters_used; ++i) _managed_parameters[i]->clear();
+        _parameters_used = scope.parameters;
+    }
+
+    /**
+     *  Write static text of the template to the buffer
+     *
+     *  The data comes from the compiled template, and stays valid as long as
+     *  the template exists. In segmented mode, longer pieces of text are
+     *  therefore not copied, but referred to in a segment of their own.
+     *
      *  @param  buffer
      *  @param  size
      */
     void write(const char *buffer, size_t size)
     {
-        _buffer.append(buffer, size);
+        // short pieces of text are cheaper to copy than to keep in a segment
+        if (_segmented && size >= 64)
+        {
+            // the output before the text becomes a segment, followed by the text itself
+            closeSegment();
+            _segments.push_back(Segment{ buffer, 0, size });
+        }
+        else
+        {
+            // copy the data
+            _buffer.append(buffer, size);
+            check();
+        }
+    }
+
+    /**
+     *  The segments of the output, this should only be called when the
+     *  processing is done, and the segments are only valid until the
+     *  handler is reset
+     *  @return std::vector<Segment>
+     */
+    const std::vector<Segment> &segments()
+    {
+        // the remaining output becomes the last segment
+        closeSegment();
+
+        // expose the segments
+        return _segments;
     }
 
     /**
@@ -130,14 +579,93 @@ public:
      */
     void output(const Value *value, bool escape)
     {
-        // Turn the value into a string
+        // strings can be appended straight from their own buffer
+        const char *data;
+        size_t size;
+        if (stringBuffer(value, data, size))
+        {
+            // the escaper encodes it directly into our buffer
+            if (escape) _encoder->append(data, size, _buffer);
+            else _buffer.append(data, size);
+        }
+        else
+        {
+            // Turn the value into a string
+            std::string work = value->toString();
+
+            // Append it to our buffer, the escaper encodes it directly into the buffer
+            if (escape) _encoder->append(work.data(), work.size(), _buffer);
+            else _buffer.append(work);
+        }
+
+        // flush if the buffer is full
+        check();
+    }
+
+    /**
+     *  Forget the cached output in a slot, this is called right before the loop
+     *  in which the output is invariant starts
+     *  @param  slot        the cache slot
+     *  @param  root        the variable that the output depends on (or nullptr)
+     */
+    void resetCache(size_t slot, const Value *root)
+    {
+        // make sure the slot exists (the memory of the slots is reused between runs)
+        if (slot >= _caches.size()) _caches.resize(slot + 1);
+
+        // the output is generated on first use
+        auto &cache = _caches[slot];
+        cache.filled = false;
+
+        // callbacks that are not cacheable may return something else every time
+        cache.disabled = root != nullptr && changing(root);
+    }
+
+    /**
+     *  Output the cached output of a slot
+     *  @param  slot        the cache slot
+     *  @return bool        was there cached output?
+     */
+    bool outputCached(size_t slot)
+    {
+        // is the output known?
+        if (slot >= _caches.size() || !_caches[slot].filled) return false;
+
+        // copy it (the cached data may change when the loop starts again, so we can not refer to it)
+        _buffer.append(_caches[slot].data);
+        check();
+
+        // done
+        return true;
+    }
+
+    /**
+     *  Output a value, and remember the output in a cache slot
+     *  @param  slot        the cache slot
+     *  @param  value       the value to output
+     *  @param  escape      should the value be escaped?
+     */
+    void outputStore(size_t slot, const Value *value, bool escape)
+    {
+        // remember where the output starts
+        size_t start = _buffer.size();
+
+        // turn the value into a string, and append it just like output() does
         std::string work = value->toString();
+        if (escape) _encoder->append(work.data(), work.size(), _buffer);
+        else _buffer.append(work);
 
-        // Should we escape the value?
-        if (escape) work = _encoder->encode(work);
+        // remember the output (this must happen before the buffer is flushed)
+        if (slot < _caches.size() && !_caches[slot].disabled && !changing(value))
+        {
+            // copy the escaped data
+            auto &cache = _caches[slot];
+            cache.data.assign(_buffer, start, std::string::npos);
+            cache.filled = true;
+        }
 
-        // Append it to our buffer
-        _buffer.append(work);
+        // flush if the buffer is full
+        check();
     }
 
     /**
@@ -146,7 +674,11 @@ public:
      */
     void outputInteger(integer_t number)
     {
-        _buffer.append(std::to_string(number));
+        // format the number straight into the buffer
+        Number::append(number, _buffer);
+
+        // flush if the buffer is full
+        check();
     }
 
     /**
@@ -156,6 +688,7 @@ public:
     void outputBoolean(bool value)
     {
         _buffer.append(value ? "true" : "false");
+        check();
     }
 
     /**
@@ -164,20 +697,11 @@ public:
      */
     void outputDouble(double number)
     {
-        // create buffer
-        char buffer[512];
-
-        // format string
-        size_t written = snprintf(buffer, 512, "%.5f", number);
+        // format the number straight into the buffer
+        Number::append(number, _buffer);
 
-        // Remove trailing zeroes
-        while (buffer[written - 1] == '0') written--;
-
-        // Round number?
-        if (buffer[written - 1] == '.') written--;
-
-        // Add to total buffer
-        _buffer.append(buffer, written);
+        // flush if the buffer is full
+        check();
     }
 
     /**
@@ -190,7 +714,7 @@ public:
     {
         // look through our local values first
         auto iter = _local_values.find(name);
-        if (iter != _local_values.end()) return iter->second;
+        if (iter != _local_values.end()) return iter->second.value;
 
         // didn't find it? get the variable from the data object
         auto *result = _data->value(name, size);
@@ -198,11 +722,27 @@ public:
         
         // construct a new empty value, and remember it (this situation is especially
         // needed for {$x = $y} assignments, when $y does not yet exist
-        auto *newvar = new VariantValue();
-        assign(name, size, newvar);
-        
-        // done
-        return newvar;
+        return assign(name, size, VariantValue());
+    }
+
+    /**
+     *  Retrieve a variable pointer by its slot index
+     *  @param  index       the slot index
+     *  @return Value
+     */
+    const Value *variable(size_t index)
+    {
+        // local variables override the data
+        auto *local = _slot_locals[index];
+        if (local) return local->value;
+
+        // get the variable from the data object
+        auto *result = _slot_values[index];
+        if (result) return result;
+
+        // construct a new empty value, just like variable() does for names
+        auto &name = _slots->name(index);
+        return assign(name.data(), name.size(), VariantValue());
     }
 
     /**
@@ -214,6 +754,40 @@ public:
         return _buffer;
     }
 
+    /**
+     *  Return the generated output, so that it can be moved out of the handler
+     *  @return std::string
+     */
+    std::string &output()
+    {
+        return _buffer;
+    }
+
+    /**
+     *  Pass all buffered output to the sink (if there is one)
+     */
+    void flush()
+    {
+        // nothing to flush
+        if (_sink == nullptr || _buffer.empty()) return;
+
+        // exceptions can not be thrown through the generated code, so errors
+        // from the sink put the handler in failed mode instead
+        if (!failed()) try
+        {
+            // pass the buffer to the sink
+            _sink->write(_buffer.data(), _buffer.size());
+        }
+        catch (const std::exception &exception)
+        {
+            // remember the error, further output will be discarded
+            markFailed(exception.what());
+        }
+
+        // the buffer can be reused (this keeps the capacity)
+        _buffer.clear();
+    }
+
     /**
      *  Return a modifier by name
      *  @param name
@@ -225,29 +799,68 @@ public:
         return _data->modifier(name, size);
     }
 
+    /**
+     *  Return a modifier by its slot index
+     *  @param index
+     *  @return Modifier
+     */
+    Modifier* modifier(size_t index)
+    {
+        return _slot_modifiers[index];
+    }
+
     /**
      *  Assign an existing value to a local variable
      *
      *  @param value       The value we would like to assign
      *  @param key         The name for our local variable
      *  @param key_size    The size of key
+     *  @return Value      Pointer to the value of the local variable
      */
-    void assign(const char *key, size_t key_size, VariantValue value)
+    const Value *assign(const char *key, size_t key_size, VariantValue value)
     {
-        assign(key, key_size, new VariantValue(std::move(value)));
+        // find or create the local variable
+        auto &local = this->local(key, key_size);
+
+        // the cached string of the old value is no longer valid
+        if (!_managed_strings.empty()) _managed_strings.erase(&local.variant);
+
+        // store the variant in the local variable
+        local.variant = std::move(value);
+
+        // expose the value
+        return local.value = &local.variant;
     }
 
     /**
-     *  Assign a just allocated Value to a specify key
+     *  Assign a Value to a specify key
+     *
+     *  Variants (like all temporary values) are copied into the local variable,
+     *  which is cheap because the copy shares the underlying value. Other values
+     *  are expected to be held by the data object, or they become managed.
      *
      *  @param  key         The name of our local variable
      *  @param  key_size    The size of key
-     *  @param  value       The newly allocated value we would like to assign
+     *  @param  value       The value we would like to assign
+     *  @return Value       Pointer to the value of the local variable
      */
-    void assign(const char *key, size_t key_size, const Value *value)
+    const Value *assign(const char *key, size_t key_size, const Value *value)
     {
+        // is this a variant? then we store a copy
+        auto *variant = dynamic_cast<const VariantValue *>(value);
+        if (variant) return assign(key, key_size, *variant);
+
+        // make sure the value stays alive
         manageValue(value);
-        _local_values[key] = value;
+
+        // find or create the local variable
+        auto &local = this->local(key, key_size);
+
+        // the cached string of the old value is no longer valid
+        if (!_managed_strings.empty()) _managed_strings.erase(&local.variant);
+
+        // point to the value
+        return local.value = value;
     }
 
     /**
@@ -301,23 +914,38 @@ public:
      */
     bool manageValue(const Value *value)
     {
-        // Check if someone is already managing value or not
-        for (auto &v : _managed_local_values)
-        {
-            // In case we found it that means that we are already managed
-            if (v.get() == value) return false;
-        }
+        // temporary values are already managed by the arena
+        if (_arena.contains(value)) return false;
+
+        // Check if we are already managing value or not
+        if (_owned_values.find(value) != _owned_values.end()) return false;
 
         // if it is already hold by the data object we also do not have to manage it
         if (_data->contains(value)) return false;
 
         // If they are not we start managing it
         _managed_local_values.emplace_back(value);
+        _owned_values.insert(value);
 
         // Return true to indicate that we are now managing value
         return true;
     }
 
+    /**
+     *  Create a temporary value
+     *
+     *  The value is allocated in the arena of the handler, and is destructed
+     *  when the handler is cleaned up. It should therefore not be deleted.
+     *
+     *  @param  args        constructor arguments for the VariantValue
+     *  @return VariantValue
+     */
+    template <typename ...Args>
+    const VariantValue *temporary(Args&&... args)
+    {
+        return _arena.create<VariantValue>(std::forward<Args>(args)...);
+    }
+
     /**
      *  Make the following iterator managed
      *  @param iter The iterator to make managed
@@ -333,14 +961,17 @@ public:
      */
     SmartTpl::Parameters* newParameters(size_t parameters_count)
     {
-        // use emplace to place our new parameters object directly in place
-        auto iter = _managed_parameters.emplace(_managed_parameters.begin(), new SmartTpl::Parameters());
+        // create a new parameters object if there is no unused one left
+        if (_parameters_used == _managed_parameters.size()) _managed_parameters.emplace_back(new SmartTpl::Parameters());
+
+        // take the next (empty) parameters object
+        auto *parameters = _managed_parameters[_parameters_used++].get();
 
         // reserve the parameters_count
-        (*iter)->reserve(parameters_count);
+        parameters->reserve(parameters_count);
 
         // return the raw pointer to our parameters
-        return iter->get();
+        return parameters;
     }
 
     /**
@@ -0,0 +1,225 @@
+/**
+ *  HtmlEscaper.cpp
+ *
+ *  Implementation of the scanner that finds the characters that have to be
+ *  escaped in html. Most of the output of a template does not contain any
+ *  of these characters, so on x86 processors we check 16 bytes at a time
+ *  with SSE2, or 32 bytes at a time with AVX2 when the processor supports
+ *  it. The implementation is picked once, when the library is loaded.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Dependencies
+ */
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Table with the characters that have to be escaped
+ */
+static const struct SpecialTable
+{
+    /**
+     *  The table itself, indexed by the (unsigned) character
+     */
+    bool special[256] = {};
+
+    /**
+     *  Constructor
+     */
+    SpecialTable()
+    {
+        // mark the special characters
+        for (unsigned char c : { '\"', '\'', '&', '<', '>' }) special[c] = true;
+    }
+} table;
+
+/**
+ *  Does a character have to be escaped?
+ *  @param  c
+ *  @return bool
+ */
+static inline bool special(char c)
+{
+    return table.special[(unsigned char)c];
+}
+
+/**
+ *  Scan a buffer one character at a time
+ *  @param  data        the buffer
+ *  @param  size        size of the buffer
+ *  @return size_t      position of the first special character, or size
+ */
+static size_t scanScalar(const char *data, size_t size)
+{
+    // check all characters
+    for (size_t i = 0; i < size; ++i) if (special(data[i])) return i;
+
+    // nothing found
+    return size;
+}
+
+#if defined(__SSE2__)
+
+/**
+ *  Scan a buffer 16 characters at a time
+ *  @param  data        the buffer
+ *  @param  size        size of the buffer
+ *  @return size_t      position of the first special character, or size
+ */
+static size_t scanSse2(const char *data, size_t size)
+{
+    // the characters that we look for
+    const __m128i quot = _mm_set1_epi8('\"');
+    const __m128i apos = _mm_set1_epi8('\'');
+    const __m128i amp  = _mm_set1_epi8('&');
+    const __m128i lt   = _mm_set1_epi8('<');
+    const __m128i gt   = _mm_set1_epi8('>');
+
+    // process blocks of 16 bytes
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        // load the block, and compare it with all special characters
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quot), _mm_cmpeq_epi8(block, apos)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, amp), _mm_cmpeq_epi8(block, lt)), _mm_cmpeq_epi8(block, gt))
+        );
+
+        // turn the result into a bitmask, the lowest bit is the first character
+        int mask = _mm_movemask_epi8(found);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    // nothing left to check?
+    if (i == size) return size;
+
+    // if the buffer is big enough, the tail is checked by loading the last 16 bytes (this
+    // overlaps with the previous block, so we ignore the bits for the bytes that we already had)
+    if (size >= 16)
+    {
+        // load the last block, and compare it with all special characters
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + size - 16));
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quot), _mm_cmpeq_epi8(block, apos)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, amp), _mm_cmpeq_epi8(block, lt)), _mm_cmpeq_epi8(block, gt))
+        );
+
+        // remove the bytes that were already checked
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(found) >> (16 - (size - i));
+        return mask ? i + __builtin_ctz(mask) : size;
+    }
+
+    // short buffers are checked one character at a time
+    return i + scanScalar(data + i, size - i);
+}
+
+/**
+ *  Scan a buffer 32 characters at a time, this function is only
+ *  called when the processor supports AVX2
+ *  @param  data        the buffer
+ *  @param  size        size of the buffer
+ *  @return size_t      position of the first special character, or size
+ */
+__attribute__((target("avx2")))
+static size_t scanAvx2(const char *data, size_t size)
+{
+    // the characters that we look for
+    const __m256i quot = _mm256_set1_epi8('\"');
+    const __m256i apos = _mm256_set1_epi8('\'');
+    const __m256i amp  = _mm256_set1_epi8('&');
+    const __m256i lt   = _mm256_set1_epi8('<');
+    const __m256i gt   = _mm256_set1_epi8('>');
+
+    // process blocks of 32 bytes
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        // load the block, and compare it with all special characters
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quot), _mm256_cmpeq_epi8(block, apos)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, amp), _mm256_cmpeq_epi8(block, lt)), _mm256_cmpeq_epi8(block, gt))
+        );
+
+        // turn the result into a bitmask, the lowest bit is the first character
+        unsigned int mask = _mm256_movemask_epi8(found);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    // nothing left to check?
+    if (i == size) return size;
+
+    // if the buffer is big enough, the tail is checked by loading the last 32 bytes (this
+    // overlaps with the previous block, so we ignore the bits for the bytes that we already had)
+    if (size >= 32)
+    {
+        // load the last block, and compare it with all special characters
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + size - 32));
+        __m256i found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quot), _mm256_cmpeq_epi8(block, apos)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, amp), _mm256_cmpeq_epi8(block, lt)), _mm256_cmpeq_epi8(block, gt))
+        );
+
+        // remove the bytes that were already checked
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(found) >> (32 - (size - i));
+        return mask ? i + __builtin_ctz(mask) : size;
+    }
+
+    // short buffers are checked one character at a time
+    for (; i < size; ++i) if (special(data[i])) return i;
+
+    // nothing found
+    return size;
+}
+
+#endif
+
+/**
+ *  Pick the best implementation for the processor that we run on
+ *  @return function
+ */
+static size_t (*selectScan())(const char *, size_t)
+{
+#if defined(__SSE2__)
+    // this could run before the static constructors that detect the processor features
+    __builtin_cpu_init();
+
+    // use avx2 if the processor supports it, sse2 is always available
+    return __builtin_cpu_supports("avx2") ? scanAvx2 : scanSse2;
+#else
+    // no vector instructions available
+    return scanScalar;
+#endif
+}
+
+/**
+ *  Find the first character in a buffer that has to be escaped
+ *  @param  data        the buffer
+ *  @param  size        size of the buffer
+ *  @return size_t      position of the character, or size if there is none
+ */
+size_t HtmlEscaper::scan(const char *data, size_t size)
+{
+    // the implementation is selected the first time we are called (escapers are static
+    // objects too, so we can not rely on the order in which static variables are initialized)
+    static size_t (*const implementation)(const char *, size_t) = selectScan();
+
+    // run it
+    return implementation(data, size);
+}
+
+/**
+ *  End namespace
+ */
+}}
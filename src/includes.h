@@ -25,12 +25,28 @@
 #include <cstring>
 #include <algorithm>
 #include <set>
+#include <unordered_set>
 #include <ctime>
 #include <boost/regex.hpp>
 #include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include <cmath>
+#include <limits>
+#include <typeinfo>
+#include <functional>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 #include <openssl/md5.h>
 #include <openssl/sha.h>
-#include <openssl/bio.h>
 #include <openssl/evp.h>
 #include <timelib.h>
 
@@ -45,6 +61,7 @@
 #include "include/iterator.h"
 
 #include "include/value.h"
+#include "include/number.h"
 #include "include/variantvalue.h"
 #include "include/nullvalue.h"
 #include "include/boolvalue.h"
@@ -60,8 +77,17 @@
 #include "include/parameters.h"
 #include "include/modifier.h"
 #include "include/state.h"
+#include "include/hashtable.h"
 #include "include/data.h"
+#include "include/sink.h"
+#include "include/streamsink.h"
+#include "include/filedescriptorsink.h"
+#include "include/callbacksink.h"
+#include "include/rendercontext.h"
+#include "include/segments.h"
+#include "include/regexcache.h"
 #include "include/template.h"
+#include "include/templatecache.h"
 #include "include/compileerror.h"
 #include "include/runtimeerror.h"
 
@@ -77,7 +103,9 @@
 #include "quotedstring.h"
 #include "generator.h"
 #include "escaper.h"
+#include "base64.h"
 #include "callbackvalue.h"
+#include "inlinestringvalue.h"
 #include "dynamic/openssl.h"
 #include "escapers/null.h"
 #include "escapers/html.h"
@@ -136,9 +164,11 @@
 #include "expressions/anonymousvariable.h"
 #include "expressions/filter.h"
 #include "expressions/booleaninverter.h"
+#include "statements/loop.h"
 #include "statements/statement.h"
 #include "statements/statements.h"
 #include "statements/raw.h"
+#include "statements/cachedoutput.h"
 #include "statements/expression.h"
 #include "statements/if.h"
 #include "statements/foreach.h"
@@ -168,14 +198,20 @@
 #include "tokenizer_v1.h"
 #include "tokenizer_v2.h"
 #include "syntaxtree.h"
+#include "slots.h"
 #include "ccode.h"
 #include "callbacks.h"
 #include "iterator.h"
+#include "arena.h"
 #include "handler.h"
 #include "executor.h"
 #include "jit_exception.h"
 #include "errorlabel.h"
 #include "bytecode.h"
+#include "interpreter.h"
 #include "library.h"
+#include "executorcache.h"
+#include "librarycache.h"
+#include "tiered.h"
 #include "vector_iterator.h"
 #include "map_iterator.h"
@@ -0,0 +1,107 @@
+/**
+ *  InlineStringValue.h
+ *
+ *  A string that is stored inside a VariantValue, wrapped without copying
+ *  it. It behaves exactly like a StringValue, but it does not allocate, so
+ *  that converting an inline string is cheap.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class InlineStringValue : public Value
+{
+private:
+    /**
+     *  The buffer of the string (owned by the variant)
+     *  @var    const char *
+     */
+    const char *_data;
+
+    /**
+     *  Size of the string
+     *  @var    size_t
+     */
+    size_t _size;
+
+public:
+    /**
+     *  Constructor
+     *  @param  data        the buffer
+     *  @param  size        size of the buffer
+     */
+    InlineStringValue(const char *data, size_t size) : _data(data), _size(size) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~InlineStringValue() {}
+
+    /**
+     *  Convert the value to a string
+     *  @return std::string
+     */
+    virtual std::string toString() const override
+    {
+        return std::string(_data, _size);
+    }
+
+    /**
+     *  Convert the variable to a numeric value
+     *  @return integer_t
+     */
+    virtual integer_t toNumeric() const override
+    {
+        // parse the number (this gives zero if the string is not numeric)
+        integer_t result;
+        Number::parse(_data, _size, result);
+        return result;
+    }
+
+    /**
+     *  Convert the variable to a boolean value
+     *  @return bool
+     */
+    virtual bool toBoolean() const override
+    {
+        // just like in php an empty string and a string containing "0" are false
+        if (_size == 0) return false;
+        else if (_size == 1 && _data[0] == '0') return false;
+        else return true;
+    }
+
+    /**
+     *  Convert the variable to a floating point value
+     *  @return double
+     */
+    virtual double toDouble() const override
+    {
+        // parse the number (this gives zero if the string is not numeric)
+        double result;
+        Number::parse(_data, _size, result);
+        return result;
+    }
+
+    /**
+     *  Use this value as index of another parent value
+     *  @param  value       the value in which to look for this key
+     *  @return VariantValue
+     */
+    virtual VariantValue lookupIn(const Value &value) const override
+    {
+        // the buffer can be used as key right away
+        return value.member(_data, _size);
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
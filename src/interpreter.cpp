@@ -0,0 +1,1319 @@
+/**
+ *  Interpreter.cpp
+ *
+ *  Implementation of the generator that turns a template into a list of
+ *  instructions, and of the loop that runs these instructions.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Constructor
+ *  @param  source       The source that holds the template
+ *  @throws CompileError If the template could not be parsed
+ */
+Interpreter::Interpreter(const Source &source) :
+    _tree(source.version(), source.data(), source.size())
+{
+    // the register with the null pointer, that is used for optional operands
+    _null = pointerConstant(nullptr);
+
+    // generate the instructions
+    _tree.generate(this);
+}
+
+/**
+ *  Add a register that is initially zero
+ *  @return size_t
+ */
+size_t Interpreter::allocate()
+{
+    // all members of the union have the same size, so this clears all of them
+    Register reg;
+    reg.integer = 0;
+
+    // add the register
+    _registers.push_back(reg);
+
+    // expose its number
+    return _registers.size() - 1;
+}
+
+/**
+ *  Add a register with an integer constant
+ *  @param  value
+ *  @return size_t
+ */
+size_t Interpreter::integerConstant(integer_t value)
+{
+    // add a register, and store the value in it
+    auto result = allocate();
+    _registers[result].integer = value;
+    return result;
+}
+
+/**
+ *  Add a register with a floating point constant
+ *  @param  value
+ *  @return size_t
+ */
+size_t Interpreter::doubleConstant(double value)
+{
+    // add a register, and store the value in it
+    auto result = allocate();
+    _registers[result].number = value;
+    return result;
+}
+
+/**
+ *  Add a register with a size constant
+ *  @param  value
+ *  @return size_t
+ */
+size_t Interpreter::sizeConstant(size_t value)
+{
+    // add a register, and store the value in it
+    auto result = allocate();
+    _registers[result].size = value;
+    return result;
+}
+
+/**
+ *  Add a register with a pointer constant
+ *  @param  value
+ *  @return size_t
+ */
+size_t Interpreter::pointerConstant(const void *value)
+{
+    // add a register, and store the value in it
+    auto result = allocate();
+    _registers[result].pointer = value;
+    return result;
+}
+
+/**
+ *  Add an instruction
+ *  @param  opcode      the instruction
+ *  @param  a, b, c, d  the operands
+ *  @return size_t      the register that receives the result
+ */
+size_t Interpreter::emit(Opcode opcode, size_t a, size_t b, size_t c, size_t d)
+{
+    // every instruction gets its own result register (even if it does not produce
+    // a value), this wastes a couple of bytes, but keeps the instructions simple
+    auto result = allocate();
+
+    // add the instruction
+    _instructions.push_back(Instruction{ opcode, result, a, b, c, d });
+
+    // expose the result register
+    return result;
+}
+
+/**
+ *  Add a branch instruction
+ *  @param  opcode      Branch, BranchIf or BranchIfNot
+ *  @param  condition   register with the condition
+ *  @param  target      the instruction to jump to
+ *  @return size_t      position of the branch instruction
+ */
+size_t Interpreter::branch(Opcode opcode, size_t condition, size_t target)
+{
+    // add the instruction, the target is stored in the first operand
+    _instructions.push_back(Instruction{ opcode, 0, target, condition, 0, 0 });
+
+    // expose the position
+    return _instructions.size() - 1;
+}
+
+/**
+ *  Make a forward branch jump to the next instruction that is added
+ *  @param  position    position of the branch instruction
+ */
+void Interpreter::land(size_t position)
+{
+    // the next instruction is the target
+    _instructions[position].a = _instructions.size();
+}
+
+/**
+ *  Helper method to pop a register from the stack
+ *  @return size_t
+ *  @throws RunTimeError if the internal stack is empty
+ */
+size_t Interpreter::pop()
+{
+    // this should never ever happen, unless working on the library itself
+    if (_stack.empty()) throw RunTimeError("Internal stack is empty");
+
+    // get the register from the stack
+    auto result = _stack.top();
+
+    // remove it from the stack
+    _stack.pop();
+
+    // done
+    return result;
+}
+
+/**
+ *  Construct a pointer to a variable
+ *  @param  variable
+ *  @return size_t
+ */
+size_t Interpreter::pointer(const Variable *variable)
+{
+    // create the pointer on the stack
+    variable->pointer(this);
+
+    // return it from the stack
+    return pop();
+}
+
+/**
+ *  Retrieve the integer representation of an expression
+ *  @param  expression
+ *  @return size_t
+ */
+size_t Interpreter::integerExpression(const Expression *expression)
+{
+    // create on the stack
+    expression->toInteger(this);
+
+    // remove it from the stack
+    return pop();
+}
+
+/**
+ *  Retrieve the boolean representation (1 or 0) of an expression
+ *  @param  expression
+ *  @return size_t
+ */
+size_t Interpreter::booleanExpression(const Expression *expression)
+{
+    // create on the stack
+    expression->toBoolean(this);
+
+    // remove it from the stack
+    return pop();
+}
+
+/**
+ *  Retrieve the floating point representation of an expression
+ *  @param  expression
+ *  @return size_t
+ */
+size_t Interpreter::doubleExpression(const Expression *expression)
+{
+    // create on the stack
+    expression->toDouble(this);
+
+    // remove it from the stack
+    return pop();
+}
+
+/**
+ *  Retrieve the pointer to the variable that holds the result of an expression
+ *  @param  expression
+ *  @return size_t
+ */
+size_t Interpreter::pointerExpression(const Expression *expression)
+{
+    // create on the stack
+    expression->toPointer(this);
+
+    // remove it from the stack
+    return pop();
+}
+
+/**
+ *  Generate code to output raw data
+ *  @param  data                data to output
+ */
+void Interpreter::raw(const std::string &data)
+{
+    // the data is owned by the syntax tree, so we can refer to it
+    emit(Opcode::Write, pointerConstant(data.data()), sizeConstant(data.size()));
+}
+
+/**
+ *  Generate the code to output a variable
+ *  @param  variable           The variable to output
+ */
+void Interpreter::output(const Variable *variable)
+{
+    // output the variable, and escape it
+    emit(Opcode::Output, pointer(variable), true);
+}
+
+/**
+ *  Generate the code to output the output of a filter
+ *  @param  filter             The filter to eventually output
+ */
+void Interpreter::output(const Filter *filter)
+{
+    // get the pointer to the filtered variable
+    filter->pointer(this);
+
+    // output it
+    emit(Opcode::Output, pop(), filter->escape());
+}
+
+/**
+ *  Generate the code to forget the cached output of a loop invariant expression
+ *  @param  slot                the cache slot
+ *  @param  root                the variable that the output depends on (may be a nullptr)
+ */
+void Interpreter::cacheReset(size_t slot, const Variable *root)
+{
+    // reset the cache
+    emit(Opcode::CacheReset, slot, root ? pointer(root) : _null);
+}
+
+/**
+ *  Generate the code to output a loop invariant variable
+ *  @param  slot                the cache slot
+ *  @param  variable            the variable (or filter) to output
+ *  @param  escape              should the output be escaped?
+ */
+void Interpreter::cachedOutput(size_t slot, const Variable *variable, bool escape)
+{
+    // write the cached output if there is any, and skip the evaluation in that case
+    auto done = branch(Opcode::BranchIf, emit(Opcode::OutputCached, slot));
+
+    // evaluate the variable, and write and remember its output
+    emit(Opcode::OutputStore, slot, pointer(variable), escape);
+
+    // this is where we continue
+    land(done);
+}
+
+/**
+ *  Generate the code to write an expression as a string
+ *  @param  expression          the expression to write as a string
+ */
+void Interpreter::write(const Expression *expression)
+{
+    // check the type
+    switch (expression->type()) {
+    case Expression::Type::Integer:
+        // output the numeric value
+        emit(Opcode::OutputInteger, integerExpression(expression));
+        break;
+
+    case Expression::Type::Boolean:
+        // output the boolean value
+        emit(Opcode::OutputBoolean, booleanExpression(expression));
+        break;
+
+    case Expression::Type::Double:
+        // output the floating point value
+        emit(Opcode::OutputDouble, doubleExpression(expression));
+        break;
+
+    case Expression::Type::Value:
+        // output the variable
+        emit(Opcode::Output, pointerExpression(expression), true);
+        break;
+
+    default:
+        // convert the expression to a string (this pushes two registers on the stack)
+        expression->toString(this);
+
+        // pop the buffer and size from the stack (in reverse order)
+        auto size = pop();
+        auto buffer = pop();
+
+        // write the string
+        emit(Opcode::Write, buffer, size);
+        break;
+    }
+}
+
+/**
+ *  Generate a conditional statement
+ *  @param  expression          the expression to evaluate
+ *  @param  ifstatements        the statements in the 'if' part
+ *  @param  elsestatements      the statements in the 'else' part
+ */
+void Interpreter::condition(const Expression *expression, const Statements *ifstatements, const Statements *elsestatements)
+{
+    // skip the 'if' part if the expression is false
+    auto skip = branch(Opcode::BranchIfNot, booleanExpression(expression));
+
+    // the 'if' part
+    ifstatements->generate(this);
+
+    // without an 'else' part we're ready
+    if (!elsestatements) return land(skip);
+
+    // jump over the 'else' part
+    auto end = branch(Opcode::Branch);
+
+    // the 'else' part starts here
+    land(skip);
+    elsestatements->generate(this);
+
+    // this is where we continue
+    land(end);
+}
+
+/**
+ *  Generate the code to get a pointer to a variable, given a index by name
+ *  @param  parent              parent variable from which the var is retrieved
+ *  @param  name                name of the variable
+ *  @note   +1 on the stack
+ */
+void Interpreter::varPointer(const Variable *parent, const std::string &name)
+{
+    // retrieve the member of the variable
+    _stack.push(emit(Opcode::Member, pointer(parent), pointerConstant(name.data()), sizeConstant(name.size())));
+}
+
+/**
+ *  Generate the code to get a pointer to a variable, given by an expression
+ *  @param  parent              parent variable from which the var is retrieved
+ *  @param  expression          Expression that evaluates to a var name
+ *  @note   +1 on the stack
+ */
+void Interpreter::varPointer(const Variable *parent, const Expression *expression)
+{
+    // if the expression is an integer, we get the member at that position
+    if (expression->type() == Expression::Type::Integer)
+    {
+        // retrieve the member at the position
+        _stack.push(emit(Opcode::MemberAt, pointer(parent), integerExpression(expression)));
+    }
+
+    // if the expression is of unknown type, the type is determined at runtime
+    else if (expression->type() == Expression::Type::Value)
+    {
+        // get the pointer to the index
+        auto index = pointerExpression(expression);
+
+        // retrieve the member
+        _stack.push(emit(Opcode::MemberAtValue, pointer(parent), index));
+    }
+
+    // otherwise the expression is treated as a string
+    else
+    {
+        // convert the expression to a string (this pushes two registers on the stack)
+        expression->toString(this);
+
+        // pop the buffer and size from the stack (in reverse order)
+        auto size = pop();
+        auto buffer = pop();
+
+        // retrieve the member
+        _stack.push(emit(Opcode::Member, pointer(parent), buffer, size));
+    }
+}
+
+/**
+ *  Generate the code to get a pointer to a variable given a literal name
+ *  @param  name                name of the variable
+ *  @note   +1 on the stack
+ */
+void Interpreter::varPointer(const std::string &name)
+{
+    // every name has its own slot
+    _stack.push(emit(Opcode::VariableSlot, _slots.add(name)));
+}
+
+/**
+ *  Create a string literal
+ *  @param  value
+ *  @note   +2 on the stack
+ */
+void Interpreter::stringValue(const std::string &value)
+{
+    // push buffer and size
+    _stack.push(pointerConstant(value.data()));
+    _stack.push(sizeConstant(value.size()));
+}
+
+/**
+ *  Create an integer literal
+ *  @param  value
+ *  @note   +1 on the stack
+ */
+void Interpreter::integerValue(integer_t value)
+{
+    // push value
+    _stack.push(integerConstant(value));
+}
+
+/**
+ *  Create a double literal
+ *  @param  value
+ *  @note   +1 on the stack
+ */
+void Interpreter::doubleValue(double value)
+{
+    // push value
+    _stack.push(doubleConstant(value));
+}
+
+/**
+ *  Create a string constant for a variable
+ *  @param  variable
+ *  @note   +2 on the stack
+ */
+void Interpreter::stringVariable(const Variable *variable)
+{
+    // first we need a pointer to the variable
+    auto var = pointer(variable);
+
+    // retrieve the string value and its size
+    _stack.push(emit(Opcode::ToString, var));
+    _stack.push(emit(Opcode::Size, var));
+}
+
+/**
+ *  Create an integer constant for a variable
+ *  @param  variable
+ *  @note   +1 on the stack
+ */
+void Interpreter::integerVariable(const Variable *variable)
+{
+    // convert the variable to an integer
+    _stack.push(emit(Opcode::ToInteger, pointer(variable)));
+}
+
+/**
+ *  Create a boolean constant for a variable
+ *  @param  variable
+ *  @note   +1 on the stack
+ */
+void Interpreter::booleanVariable(const Variable *variable)
+{
+    // convert the variable to a boolean
+    _stack.push(emit(Opcode::ToBoolean, pointer(variable)));
+}
+
+/**
+ *  Create a floating point constant for a variable
+ *  @param  variable
+ *  @note   +1 on the stack
+ */
+void Interpreter::doubleVariable(const Variable *variable)
+{
+    // convert the variable to a floating point value
+    _stack.push(emit(Opcode::ToDouble, pointer(variable)));
+}
+
+/**
+ *  Create a constant for a variable
+ *  @param  variable
+ *  @note   +2 on the stack
+ */
+void Interpreter::variable(const Variable *variable)
+{
+    stringVariable(variable);
+}
+
+/**
+ *  Move an expression to the runtime space
+ *  @param  expression
+ */
+void Interpreter::pointerString(const Expression *expression)
+{
+    // get the string representation of the expression
+    expression->toString(this);
+
+    // get the size and buffer from the stack
+    auto size = pop();
+    auto buffer = pop();
+
+    // add to runtime space and push the pointer
+    _stack.push(emit(Opcode::TransferString, buffer, size));
+}
+
+/**
+ *  Move an expression to the runtime space
+ *  @param  expression
+ */
+void Interpreter::pointerInteger(const Expression *expression)
+{
+    // add the integer to runtime space and push the pointer
+    _stack.push(emit(Opcode::TransferInteger, integerExpression(expression)));
+}
+
+/**
+ *  Move an expression to the runtime space
+ *  @param  expression
+ */
+void Interpreter::pointerDouble(const Expression *expression)
+{
+    // add the floating point value to runtime space and push the pointer
+    _stack.push(emit(Opcode::TransferDouble, doubleExpression(expression)));
+}
+
+/**
+ *  Move an expression to the runtime space
+ *  @param  expression
+ */
+void Interpreter::pointerBoolean(const Expression *expression)
+{
+    // add the boolean to runtime space and push the pointer
+    _stack.push(emit(Opcode::TransferBoolean, booleanExpression(expression)));
+}
+
+/**
+ *  Negate the boolean expression
+ *  @param  expression
+ *  @note   +1 on the stack
+ */
+void Interpreter::negateBoolean(const Expression *expression)
+{
+    // negate the boolean
+    _stack.push(emit(Opcode::Not, booleanExpression(expression)));
+}
+
+/**
+ *  Arithmetric operations on integers
+ *  @param  left
+ *  @param  right
+ *  @note   +1 on the stack
+ */
+void Interpreter::integerPlus(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = integerExpression(left);
+    auto r = integerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::IntegerPlus, l, r));
+}
+
+void Interpreter::integerMinus(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = integerExpression(left);
+    auto r = integerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::IntegerMinus, l, r));
+}
+
+void Interpreter::integerMultiply(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = integerExpression(left);
+    auto r = integerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::IntegerMultiply, l, r));
+}
+
+void Interpreter::integerDivide(const Expression *left, const Expression *right)
+{
+    // the right value is calculated first, just like the jit compiler does
+    auto r = integerExpression(right);
+    auto l = integerExpression(left);
+
+    // calculate them (this checks for a division by zero), and push to stack
+    _stack.push(emit(Opcode::IntegerDivide, l, r));
+}
+
+void Interpreter::integerModulo(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = integerExpression(left);
+    auto r = integerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::IntegerModulo, l, r));
+}
+
+/**
+ *  Arithmetric operations on floating point values
+ *  @param  left
+ *  @param  right
+ *  @note   +1 on the stack
+ */
+void Interpreter::doublePlus(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = doubleExpression(left);
+    auto r = doubleExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::DoublePlus, l, r));
+}
+
+void Interpreter::doubleMinus(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = doubleExpression(left);
+    auto r = doubleExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::DoubleMinus, l, r));
+}
+
+void Interpreter::doubleMultiply(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = doubleExpression(left);
+    auto r = doubleExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::DoubleMultiply, l, r));
+}
+
+void Interpreter::doubleDivide(const Expression *left, const Expression *right)
+{
+    // the right value is calculated first, just like the jit compiler does
+    auto r = doubleExpression(right);
+    auto l = doubleExpression(left);
+
+    // calculate them (this checks for a division by zero), and push to stack
+    _stack.push(emit(Opcode::DoubleDivide, l, r));
+}
+
+/**
+ *  Arithmetric operations on variables, for operands of which the type
+ *  is not yet known at compile time
+ *  @param  left
+ *  @param  right
+ *  @note   +1 on the stack
+ */
+void Interpreter::pointerPlus(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = pointerExpression(left);
+    auto r = pointerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::Plus, l, r));
+}
+
+void Interpreter::pointerMinus(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = pointerExpression(left);
+    auto r = pointerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::Minus, l, r));
+}
+
+void Interpreter::pointerMultiply(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = pointerExpression(left);
+    auto r = pointerExpression(right);
+
+    // calculate them, and push to stack
+    _stack.push(emit(Opcode::Multiply, l, r));
+}
+
+void Interpreter::pointerDivide(const Expression *left, const Expression *right)
+{
+    // calculate left and right values
+    auto l = pointerExpression(left);
+    auto r = pointerExpression(right);
+
+    // calculate them (a null pointer means a division by zero), and push to stack
+    _stack.push(emit(Opcode::Divide, l, r));
+}
+
+void Interpreter::pointerModulo(const Expression *left, const Expression *right)
+{
+    // calculate the result
+    integerModulo(left, right);
+
+    // transfer the result to runtime space and push the pointer
+    _stack.push(emit(Opcode::TransferInteger, pop()));
+}
+
+/**
+ *  Helper method to compare two expressions as numbers
+ *  @param  left
+ *  @param  right
+ *  @param  integer     instruction to compare integers
+ *  @param  number      instruction to compare floating point values
+ */
+void Interpreter::compare(const Expression *left, const Expression *right, Opcode integer, Opcode number)
+{
+    // variables are compared as floating point values, and so is everything that is compared with them
+    bool floating = left->type() == Expression::Type::Double || left->type() == Expression::Type::Value ||
+                    right->type() == Expression::Type::Double || right->type() == Expression::Type::Value;
+
+    // calculate left and right values
+    auto l = floating ? doubleExpression(left) : integerExpression(left);
+    auto r = floating ? doubleExpression(right) : integerExpression(right);
+
+    // compare them, and push to stack
+    _stack.push(emit(floating ? number : integer, l, r));
+}
+
+/**
+ *  Comparison operators
+ *  @param  left
+ *  @param  right
+ *  @note   +1 on the stack
+ */
+void Interpreter::equals(const Expression *left, const Expression *right)
+{
+    if (left->type() == Expression::Type::Double || right->type() == Expression::Type::Double)
+    {
+        // compare as floating points
+        auto l = doubleExpression(left);
+        auto r = doubleExpression(right);
+        _stack.push(emit(Opcode::DoubleEquals, l, r));
+    }
+    else if (left->type() == Expression::Type::Integer || right->type() == Expression::Type::Integer)
+    {
+        // compare as integers
+        auto l = integerExpression(left);
+        auto r = integerExpression(right);
+        _stack.push(emit(Opcode::IntegerEquals, l, r));
+    }
+    else if (left->type() == Expression::Type::Boolean || right->type() == Expression::Type::Boolean)
+    {
+        // compare as booleans (which are stored as integers)
+        auto l = booleanExpression(left);
+        auto r = booleanExpression(right);
+        _stack.push(emit(Opcode::IntegerEquals, l, r));
+    }
+    else
+    {
+        // convert both expressions to strings
+        left->toString(this);
+        auto l_size = pop();
+        auto l = pop();
+        right->toString(this);
+        auto r_size = pop();
+        auto r = pop();
+
+        // compare the strings
+        _stack.push(emit(Opcode::StringEquals, l, l_size, r, r_size));
+    }
+}
+
+void Interpreter::notEquals(const Expression *left, const Expression *right)
+{
+    if (left->type() == Expression::Type::Double || right->type() == Expression::Type::Double)
+    {
+        // compare as floating points
+        auto l = doubleExpression(left);
+        auto r = doubleExpression(right);
+        _stack.push(emit(Opcode::DoubleNotEquals, l, r));
+    }
+    else if (left->type() == Expression::Type::Integer || right->type() == Expression::Type::Integer)
+    {
+        // compare as integers
+        auto l = integerExpression(left);
+        auto r = integerExpression(right);
+        _stack.push(emit(Opcode::IntegerNotEquals, l, r));
+    }
+    else if (left->type() == Expression::Type::Boolean || right->type() == Expression::Type::Boolean)
+    {
+        // compare as booleans (which are stored as integers)
+        auto l = booleanExpression(left);
+        auto r = booleanExpression(right);
+        _stack.push(emit(Opcode::IntegerNotEquals, l, r));
+    }
+    else
+    {
+        // convert both expressions to strings
+        left->toString(this);
+        auto l_size = pop();
+        auto l = pop();
+        right->toString(this);
+        auto r_size = pop();
+        auto r = pop();
+
+        // compare the strings
+        _stack.push(emit(Opcode::StringNotEquals, l, l_size, r, r_size));
+    }
+}
+
+void Interpreter::greater(const Expression *left, const Expression *right)
+{
+    compare(left, right, Opcode::IntegerGreater, Opcode::DoubleGreater);
+}
+
+void Interpreter::greaterEquals(const Expression *left, const Expression *right)
+{
+    compare(left, right, Opcode::IntegerGreaterEquals, Opcode::DoubleGreaterEquals);
+}
+
+void Interpreter::lesser(const Expression *left, const Expression *right)
+{
+    compare(left, right, Opcode::IntegerLesser, Opcode::DoubleLesser);
+}
+
+void Interpreter::lesserEquals(const Expression *left, const Expression *right)
+{
+    compare(left, right, Opcode::IntegerLesserEquals, Opcode::DoubleLesserEquals);
+}
+
+/**
+ *  Regular expression operator
+ *  @param  left
+ *  @param  right
+ *  @note   +1 on the stack
+ */
+void Interpreter::regex(const Expression *left, const Expression *right)
+{
+    // the compiled regex for a literal pattern
+    const boost::regex *compiled = literalRegex(right);
+
+    // the register with the handle of the regex
+    size_t handle = compiled ? pointerConstant(compiled) : _null;
+
+    // otherwise it has to be compiled at runtime
+    if (!compiled)
+    {
+        // turn the pattern into a string
+        right->toString(this);
+        auto size = pop();
+        auto buffer = pop();
+
+        // compile it (this fails if the pattern is invalid)
+        handle = emit(Opcode::RegexCompile, buffer, size);
+    }
+
+    // turn the left hand side into a string
+    left->toString(this);
+    auto size = pop();
+    auto buffer = pop();
+
+    // match the regex
+    auto result = emit(Opcode::RegexMatch, handle, buffer, size);
+
+    // release the regex (a precompiled regex is owned by us)
+    if (!compiled) emit(Opcode::RegexRelease, handle);
+
+    // push the result to the stack
+    _stack.push(result);
+}
+
+/**
+ *  Get the precompiled regular expression for a pattern
+ *  @param  pattern         expression holding the pattern
+ *  @return boost::regex    the compiled regex, or nullptr if the pattern is not a valid literal
+ */
+const boost::regex *Interpreter::literalRegex(const Expression *pattern)
+{
+    // only literal strings can be compiled in advance
+    auto *literal = dynamic_cast<const LiteralString *>(pattern);
+    if (!literal) return nullptr;
+
+    // perhaps the same pattern was already compiled
+    auto iter = _regexes.find(literal->value());
+    if (iter != _regexes.end()) return iter->second.get();
+
+    // prevent exceptions
+    try
+    {
+        // compile the pattern
+        auto *compiled = new boost::regex(literal->value());
+
+        // we own it from now on
+        _regexes[literal->value()].reset(compiled);
+
+        // expose it
+        return compiled;
+    }
+    catch (const std::runtime_error &error)
+    {
+        // invalid patterns are reported when the template is processed
+        return nullptr;
+    }
+}
+
+/**
+ *  Boolean operators
+ *  @param  left
+ *  @param  right
+ *  @note   +1 on the stack
+ */
+void Interpreter::booleanAnd(const Expression *left, const Expression *right)
+{
+    // calculate the values (both of them, just like the jit compiler does)
+    auto l = booleanExpression(left);
+    auto r = booleanExpression(right);
+
+    // push the result
+    _stack.push(emit(Opcode::And, l, r));
+}
+
+void Interpreter::booleanOr(const Expression *left, const Expression *right)
+{
+    // calculate the values (both of them, just like the jit compiler does)
+    auto l = booleanExpression(left);
+    auto r = booleanExpression(right);
+
+    // push the result
+    _stack.push(emit(Opcode::Or, l, r));
+}
+
+/**
+ *  Generate the code to apply a set of modifiers on an expression
+ *  @param  modifiers          The set of modifiers to apply
+ *  @param  variable           The variable to apply to modifiers to
+ *  @note   +1 on the stack    (pointer to the latest variable)
+ */
+void Interpreter::modifiers(const Modifiers *modifiers, const Variable *variable)
+{
+    // the pointer to the variable that is modified
+    auto var = pointer(variable);
+
+    // loop through all the modifiers
+    for (const auto &modifier : *modifiers)
+    {
+        // every modifier name has its own slot
+        auto mod = emit(Opcode::ModifierSlot, _modifiers.add(modifier->token()));
+
+        // construct the parameters, if there are any
+        const Parameters *params = modifier->parameters();
+        if (params) parameters(params);
+        auto parameters = params ? pop() : _null;
+
+        // apply the modifier, the result is the input for the next one
+        var = emit(Opcode::ModifyVariable, var, mod, parameters);
+    }
+
+    // push the final variable
+    _stack.push(var);
+}
+
+/**
+ *  Generate the code to apply a set of modifiers on an expression and turn it into a string
+ *  @param  modifiers          The set of modifiers to apply
+ *  @param  variable           The variable to apply to modifers to
+ */
+void Interpreter::modifiersString(const Modifiers *modifiers, const Variable *variable)
+{
+    // apply the modifiers
+    this->modifiers(modifiers, variable);
+    auto var = pop();
+
+    // retrieve the string value and its size
+    _stack.push(emit(Opcode::ToString, var));
+    _stack.push(emit(Opcode::Size, var));
+}
+
+/**
+ *  Generate the code to apply a set of modifiers on an expression and turn it into a boolean
+ *  @param  modifiers          The set of modifiers to apply
+ *  @param  variable           The variable to apply to modifers to
+ */
+void Interpreter::modifiersBoolean(const Modifiers *modifiers, const Variable *variable)
+{
+    // apply the modifiers
+    this->modifiers(modifiers, variable);
+
+    // convert the result to a boolean
+    _stack.push(emit(Opcode::ToBoolean, pop()));
+}
+
+/**
+ *  Generate the code to apply a set of modifiers on an expression and turn it into a double
+ *  @param  modifiers          The set of modifiers to apply
+ *  @param  variable           The variable to apply the modifiers to
+ */
+void Interpreter::modifiersDouble(const Modifiers *modifiers, const Variable *variable)
+{
+    // apply the modifiers
+    this->modifiers(modifiers, variable);
+
+    // convert the result to a floating point value
+    _stack.push(emit(Opcode::ToDouble, pop()));
+}
+
+/**
+ *  Generate the code to construct the following parameters
+ *  @param  parameters         The parameters to construct
+ *  @note   +1 on the stack
+ */
+void Interpreter::parameters(const Parameters *parameters)
+{
+    // construct the parameters
+    auto params = emit(Opcode::CreateParams, parameters->size());
+
+    // loop through all the parameters and add them one by one
+    for (auto &param : *parameters)
+    {
+        switch (param->type()) {
+        case Expression::Type::Boolean:
+            // append as boolean
+            emit(Opcode::ParamsAppendBoolean, params, booleanExpression(param.get()));
+            break;
+        case Expression::Type::Integer:
+            // append as integer
+            emit(Opcode::ParamsAppendInteger, params, integerExpression(param.get()));
+            break;
+        case Expression::Type::String: {
+            // convert the expression to a string
+            param->toString(this);
+            auto size = pop();
+            auto buffer = pop();
+
+            // append the string
+            emit(Opcode::ParamsAppendString, params, buffer, size);
+            break;
+        }
+        case Expression::Type::Double:
+            // append as floating point value
+            emit(Opcode::ParamsAppendDouble, params, doubleExpression(param.get()));
+            break;
+        default:
+            throw CompileError("Unknown typed values are currently unsupported");
+        }
+    }
+
+    // push the parameters to the stack
+    _stack.push(params);
+}
+
+/**
+ *  Generate the code to do a foreach loop over variable
+ *  @param variable         The variable object to iterate over
+ *  @param key              The magic variable name for the keys
+ *  @param value            The magic variable name for the values
+ *  @param statements       The statements to execute on each iteration
+ *  @param else_statements  The statements to execute if there was nothing to loop through
+ */
+void Interpreter::foreach(const Variable *variable, const std::string &key, const std::string &value, const Statements *statements, const Statements *else_statements)
+{
+    // create the iterator
+    auto iterator = emit(Opcode::CreateIterator, pointer(variable));
+
+    // the branch that skips the 'else' part
+    size_t skip = 0;
+
+    // the 'else' part is only executed if there is nothing to loop through
+    if (else_statements)
+    {
+        // jump to the loop if the iterator is valid
+        skip = branch(Opcode::BranchIf, emit(Opcode::ValidIterator, iterator));
+
+        // otherwise we run the else statements, and leave the loop alone
+        else_statements->generate(this);
+        auto end = branch(Opcode::Branch);
+
+        // the loop starts here
+        land(skip);
+        skip = end;
+    }
+
+    // the start of the loop
+    auto start = _instructions.size();
+
+    // leave the loop if the iterator is no longer valid
+    auto leave = branch(Opcode::BranchIfNot, emit(Opcode::ValidIterator, iterator));
+
+    // every iteration gets its own value scope
+    emit(Opcode::EnterScope);
+
+    // assign the key
+    if (!key.empty()) emit(Opcode::Assign, pointerConstant(key.data()), sizeConstant(key.size()), emit(Opcode::IteratorKey, iterator));
+
+    // assign the value
+    if (!value.empty()) emit(Opcode::Assign, pointerConstant(value.data()), sizeConstant(value.size()), emit(Opcode::IteratorValue, iterator));
+
+    // the statements in the loop
+    statements->generate(this);
+
+    // destruct the temporaries of this iteration, and proceed
+    emit(Opcode::LeaveScope);
+    emit(Opcode::IteratorNext, iterator);
+
+    // jump back to the start
+    branch(Opcode::Branch, 0, start);
+
+    // this is where we continue
+    land(leave);
+    if (else_statements) land(skip);
+}
+
+/**
+ *  Generate the code to assign the output of an expression to a key
+ *  @param key                  The key to assign the output to
+ *  @param expression           The expression to evaluate
+ */
+void Interpreter::assign(const std::string &key, const Expression *expression)
+{
+    // registers with the key
+    auto key_str = pointerConstant(key.data());
+    auto key_size = sizeConstant(key.size());
+
+    switch (expression->type()) {
+    case Expression::Type::Integer:
+        // assign an integer
+        emit(Opcode::AssignInteger, key_str, key_size, integerExpression(expression));
+        break;
+    case Expression::Type::String: {
+        // convert to a string
+        expression->toString(this);
+        auto size = pop();
+        auto str = pop();
+
+        // assign the string
+        emit(Opcode::AssignString, key_str, key_size, str, size);
+        break;
+    }
+    case Expression::Type::Boolean:
+        // assign a boolean
+        emit(Opcode::AssignBoolean, key_str, key_size, booleanExpression(expression));
+        break;
+    case Expression::Type::Value:
+        // assign the variable
+        emit(Opcode::Assign, key_str, key_size, pointerExpression(expression));
+        break;
+    case Expression::Type::Double:
+        // assign a floating point value
+        emit(Opcode::AssignDouble, key_str, key_size, doubleExpression(expression));
+        break;
+    }
+}
+
+/**
+ *  Execute the template given a certain handler
+ *  @param  handler
+ */
+void Interpreter::process(Handler &handler)
+{
+    // bind the variables and modifiers to the data
+    handler.bind(_slots, _modifiers);
+
+    // the callbacks get the handler as user data
+    void *userdata = &handler;
+
+    // every run gets its own copy of the registers, so that a template can be
+    // processed by multiple threads at the same time
+    std::vector<Register> registers(_registers);
+    Register *r = registers.data();
+
+    // the instructions
+    const Instruction *instructions = _instructions.data();
+    size_t count = _instructions.size();
+
+    // run the instructions
+    for (size_t pc = 0; pc < count; ++pc)
+    {
+        // the current instruction
+        const Instruction &i = instructions[pc];
+
+        // the register for the result
+        Register &result = r[i.result];
+
+        // check what to do
+        switch (i.opcode) {
+        case Opcode::Write:                 smart_tpl_write(userdata, r[i.a].buffer, r[i.b].size); break;
+        case Opcode::Output:                smart_tpl_output(userdata, r[i.a].pointer, i.b); break;
+        case Opcode::OutputInteger:         smart_tpl_output_integer(userdata, r[i.a].integer); break;
+        case Opcode::OutputBoolean:         smart_tpl_output_boolean(userdata, r[i.a].integer); break;
+        case Opcode::OutputDouble:          smart_tpl_output_double(userdata, r[i.a].number); break;
+        case Opcode::CacheReset:            smart_tpl_cache_reset(userdata, i.a, r[i.b].pointer); break;
+        case Opcode::OutputCached:          result.integer = smart_tpl_output_cached(userdata, i.a); break;
+        case Opcode::OutputStore:           smart_tpl_output_store(userdata, i.a, r[i.b].pointer, i.c); break;
+        case Opcode::Member:                result.pointer = smart_tpl_member(userdata, r[i.a].pointer, r[i.b].buffer, r[i.c].size); break;
+        case Opcode::MemberAt:              result.pointer = smart_tpl_member_at(userdata, r[i.a].pointer, r[i.b].integer); break;
+        case Opcode::MemberAtValue:         result.pointer = smart_tpl_member_at_value(userdata, r[i.a].pointer, r[i.b].pointer); break;
+        case Opcode::VariableSlot:          result.pointer = smart_tpl_variable_slot(userdata, i.a); break;
+        case Opcode::ToString:              result.buffer = smart_tpl_to_string(userdata, r[i.a].pointer); break;
+        case Opcode::Size:                  result.size = smart_tpl_size(userdata, r[i.a].pointer); break;
+        case Opcode::ToInteger:             result.integer = smart_tpl_to_integer(userdata, r[i.a].pointer); break;
+        case Opcode::ToBoolean:             result.integer = smart_tpl_to_boolean(userdata, r[i.a].pointer); break;
+        case Opcode::ToDouble:              result.number = smart_tpl_to_double(userdata, r[i.a].pointer); break;
+        case Opcode::TransferString:        result.pointer = smart_tpl_transfer_string(userdata, r[i.a].buffer, r[i.b].size); break;
+        case Opcode::TransferInteger:       result.pointer = smart_tpl_transfer_integer(userdata, r[i.a].integer); break;
+        case Opcode::TransferDouble:        result.pointer = smart_tpl_transfer_double(userdata, r[i.a].number); break;
+        case Opcode::TransferBoolean:       result.pointer = smart_tpl_transfer_boolean(userdata, r[i.a].integer); break;
+        case Opcode::Not:                   result.integer = !r[i.a].integer; break;
+        case Opcode::And:                   result.integer = r[i.a].integer && r[i.b].integer; break;
+        case Opcode::Or:                    result.integer = r[i.a].integer || r[i.b].integer; break;
+        case Opcode::IntegerPlus:           result.integer = r[i.a].integer + r[i.b].integer; break;
+        case Opcode::IntegerMinus:          result.integer = r[i.a].integer - r[i.b].integer; break;
+        case Opcode::IntegerMultiply:       result.integer = r[i.a].integer * r[i.b].integer; break;
+        case Opcode::DoublePlus:            result.number = r[i.a].number + r[i.b].number; break;
+        case Opcode::DoubleMinus:           result.number = r[i.a].number - r[i.b].number; break;
+        case Opcode::DoubleMultiply:        result.number = r[i.a].number * r[i.b].number; break;
+        case Opcode::Plus:                  result.pointer = smart_tpl_plus(userdata, r[i.a].pointer, r[i.b].pointer); break;
+        case Opcode::Minus:                 result.pointer = smart_tpl_minus(userdata, r[i.a].pointer, r[i.b].pointer); break;
+        case Opcode::Multiply:              result.pointer = smart_tpl_multiply(userdata, r[i.a].pointer, r[i.b].pointer); break;
+        case Opcode::IntegerEquals:         result.integer = r[i.a].integer == r[i.b].integer; break;
+        case Opcode::IntegerNotEquals:      result.integer = r[i.a].integer != r[i.b].integer; break;
+        case Opcode::IntegerGreater:        result.integer = r[i.a].integer > r[i.b].integer; break;
+        case Opcode::IntegerGreaterEquals:  result.integer = r[i.a].integer >= r[i.b].integer; break;
+        case Opcode::IntegerLesser:         result.integer = r[i.a].integer < r[i.b].integer; break;
+        case Opcode::IntegerLesserEquals:   result.integer = r[i.a].integer <= r[i.b].integer; break;
+        case Opcode::DoubleEquals:          result.integer = r[i.a].number == r[i.b].number; break;
+        case Opcode::DoubleNotEquals:       result.integer = r[i.a].number != r[i.b].number; break;
+        case Opcode::DoubleGreater:         result.integer = r[i.a].number > r[i.b].number; break;
+        case Opcode::DoubleGreaterEquals:   result.integer = r[i.a].number >= r[i.b].number; break;
+        case Opcode::DoubleLesser:          result.integer = r[i.a].number < r[i.b].number; break;
+        case Opcode::DoubleLesserEquals:    result.integer = r[i.a].number <= r[i.b].number; break;
+        case Opcode::StringEquals:          result.integer = smart_tpl_strcmp(userdata, r[i.a].buffer, r[i.b].size, r[i.c].buffer, r[i.d].size) == 0; break;
+        case Opcode::StringNotEquals:       result.integer = smart_tpl_strcmp(userdata, r[i.a].buffer, r[i.b].size, r[i.c].buffer, r[i.d].size) != 0; break;
+        case Opcode::RegexMatch:            result.integer = smart_tpl_regex_match(userdata, r[i.a].handle, r[i.b].buffer, r[i.c].size) != 0; break;
+        case Opcode::RegexRelease:          smart_tpl_regex_release(userdata, r[i.a].handle); break;
+        case Opcode::ModifierSlot:          result.handle = smart_tpl_modifier_slot(userdata, i.a); break;
+        case Opcode::ModifyVariable:        result.pointer = smart_tpl_modify_variable(userdata, r[i.a].pointer, r[i.b].handle, r[i.c].pointer); break;
+        case Opcode::CreateParams:          result.pointer = smart_tpl_create_params(userdata, i.a); break;
+        case Opcode::ParamsAppendInteger:   smart_tpl_params_append_integer(userdata, r[i.a].pointer, r[i.b].integer); break;
+        case Opcode::ParamsAppendDouble:    smart_tpl_params_append_double(userdata, r[i.a].pointer, r[i.b].number); break;
+        case Opcode::ParamsAppendString:    smart_tpl_params_append_string(userdata, r[i.a].pointer, r[i.b].buffer, r[i.c].size); break;
+        case Opcode::ParamsAppendBoolean:   smart_tpl_params_append_boolean(userdata, r[i.a].pointer, r[i.b].integer); break;
+        case Opcode::CreateIterator:        result.handle = smart_tpl_create_iterator(userdata, r[i.a].pointer); break;
+        case Opcode::ValidIterator:         result.integer = smart_tpl_valid_iterator(userdata, r[i.a].handle); break;
+        case Opcode::IteratorKey:           result.pointer = smart_tpl_iterator_key(userdata, r[i.a].handle); break;
+        case Opcode::IteratorValue:         result.pointer = smart_tpl_iterator_value(userdata, r[i.a].handle); break;
+        case Opcode::IteratorNext:          smart_tpl_iterator_next(userdata, r[i.a].handle); break;
+        case Opcode::EnterScope:            smart_tpl_enter_scope(userdata); break;
+        case Opcode::LeaveScope:            smart_tpl_leave_scope(userdata); break;
+        case Opcode::Assign:                smart_tpl_assign(userdata, r[i.a].buffer, r[i.b].size, r[i.c].pointer); break;
+        case Opcode::AssignInteger:         smart_tpl_assign_integer(userdata, r[i.a].buffer, r[i.b].size, r[i.c].integer); break;
+        case Opcode::AssignString:          smart_tpl_assign_string(userdata, r[i.a].buffer, r[i.b].size, r[i.c].buffer, r[i.d].size); break;
+        case Opcode::AssignBoolean:         smart_tpl_assign_boolean(userdata, r[i.a].buffer, r[i.b].size, r[i.c].integer); break;
+        case Opcode::AssignDouble:          smart_tpl_assign_double(userdata, r[i.a].buffer, r[i.b].size, r[i.c].number); break;
+
+        // branches continue at the target (the loop increments the program counter)
+        case Opcode::Branch:                pc = i.a - 1; break;
+        case Opcode::BranchIf:              if (r[i.b].integer) pc = i.a - 1; break;
+        case Opcode::BranchIfNot:           if (!r[i.b].integer) pc = i.a - 1; break;
+
+        // divisions end the template when dividing by zero
+        case Opcode::IntegerDivide:
+            if (r[i.b].integer == 0) return smart_tpl_mark_failed(userdata, "Division by zero");
+            result.integer = r[i.a].integer / r[i.b].integer;
+            break;
+        case Opcode::IntegerModulo:
+            if (r[i.b].integer == 0) return smart_tpl_mark_failed(userdata, "Division by zero");
+            result.integer = r[i.a].integer % r[i.b].integer;
+            break;
+        case Opcode::DoubleDivide:
+            if (r[i.b].number == 0.0) return smart_tpl_mark_failed(userdata, "Division by zero");
+            result.number = r[i.a].number / r[i.b].number;
+            break;
+        case Opcode::Divide:
+            result.pointer = smart_tpl_divide(userdata, r[i.a].pointer, r[i.b].pointer);
+            if (result.pointer == nullptr) return smart_tpl_mark_failed(userdata, "Division by zero");
+            break;
+
+        // so do invalid regular expressions
+        case Opcode::RegexCompile:
+            result.handle = smart_tpl_regex_compile(userdata, r[i.a].buffer, r[i.b].size);
+            if (result.handle == nullptr) return smart_tpl_mark_failed(userdata, "Invalid regular expression");
+            break;
+        }
+    }
+}
+
+/**
+ *  End namespace
+ */
+}}
@@ -0,0 +1,442 @@
+/**
+ *  Interpreter.h
+ *
+ *  A generator class that turns a template into a compact list of
+ *  instructions, and an executor that runs these instructions.
+ *
+ *  Compiling a template with libjit takes much more time than processing
+ *  it, which does not pay off for templates that are only processed once or
+ *  a couple of times. The interpreter generates the same calls to the
+ *  smart_tpl_* callbacks as the jit compiler does, but it stores them in a
+ *  simple instruction list instead of compiling them into machine code.
+ *
+ *  Every value that is produced by an instruction gets its own register, so
+ *  the registers play the same role as the jit_values in the Bytecode class.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class Interpreter : private Generator, public Executor
+{
+private:
+    /**
+     *  A register holds the result of an instruction, or a constant
+     */
+    union Register
+    {
+        integer_t integer;
+        double number;
+        size_t size;
+        const char *buffer;
+        const void *pointer;
+        void *handle;
+    };
+
+    /**
+     *  The instructions that are supported
+     */
+    enum class Opcode : uint8_t {
+        Write, Output, OutputInteger, OutputBoolean, OutputDouble,
+        CacheReset, OutputCached, OutputStore,
+        Member, MemberAt, MemberAtValue, VariableSlot,
+        ToString, Size, ToInteger, ToBoolean, ToDouble,
+        TransferString, TransferInteger, TransferDouble, TransferBoolean,
+        Not, And, Or,
+        IntegerPlus, IntegerMinus, IntegerMultiply, IntegerDivide, IntegerModulo,
+        DoublePlus, DoubleMinus, DoubleMultiply, DoubleDivide,
+        Plus, Minus, Multiply, Divide,
+        IntegerEquals, IntegerNotEquals, IntegerGreater, IntegerGreaterEquals, IntegerLesser, IntegerLesserEquals,
+        DoubleEquals, DoubleNotEquals, DoubleGreater, DoubleGreaterEquals, DoubleLesser, DoubleLesserEquals,
+        StringEquals, StringNotEquals,
+        RegexCompile, RegexMatch, RegexRelease,
+        ModifierSlot, ModifyVariable,
+        CreateParams, ParamsAppendInteger, ParamsAppendDouble, ParamsAppendString, ParamsAppendBoolean,
+        CreateIterator, ValidIterator, IteratorKey, IteratorValue, IteratorNext, EnterScope, LeaveScope,
+        Assign, AssignInteger, AssignString, AssignBoolean, AssignDouble,
+        Branch, BranchIf, BranchIfNot
+    };
+
+    /**
+     *  A single instruction
+     */
+    struct Instruction
+    {
+        /**
+         *  What to do
+         *  @var Opcode
+         */
+        Opcode opcode;
+
+        /**
+         *  The register that receives the result
+         *  @var size_t
+         */
+        size_t result;
+
+        /**
+         *  The operands, these are register numbers, or (for cache slots,
+         *  variable slots, flags and branch targets) immediate values
+         *  @var size_t
+         */
+        size_t a, b, c, d;
+    };
+
+    /**
+     *  The syntax tree
+     *  @var    SyntaxTree
+     */
+    SyntaxTree _tree;
+
+    /**
+     *  The instructions of the template
+     *  @var    std::vector
+     */
+    std::vector<Instruction> _instructions;
+
+    /**
+     *  The initial value of all registers (the constants, and zero for the others)
+     *  @var    std::vector
+     */
+    std::vector<Register> _registers;
+
+    /**
+     *  Register that holds a null pointer (and zero)
+     *  @var    size_t
+     */
+    size_t _null;
+
+    /**
+     *  Stack with the registers of temporary values
+     *  @var    std::stack
+     */
+    std::stack<size_t> _stack;
+
+    /**
+     *  The slot indices of the variables and modifiers that are used in the template
+     *  @var    Slots
+     */
+    Slots _slots;
+    Slots _modifiers;
+
+    /**
+     *  Regular expressions with a literal pattern, these are compiled once
+     *  when the template is compiled, and not every time they are evaluated
+     *  @var    std::map
+     */
+    std::map<std::string, std::unique_ptr<boost::regex>> _regexes;
+
+    /**
+     *  Helper methods to add a register
+     *  @param  value
+     *  @return size_t      the register number
+     */
+    size_t allocate();
+    size_t integerConstant(integer_t value);
+    size_t doubleConstant(double value);
+    size_t sizeConstant(size_t value);
+    size_t pointerConstant(const void *value);
+
+    /**
+     *  Helper method to add an instruction
+     *  @param  opcode      the instruction
+     *  @param  a, b, c, d  the operands
+     *  @return size_t      the register that receives the result
+     */
+    size_t emit(Opcode opcode, size_t a = 0, size_t b = 0, size_t c = 0, size_t d = 0);
+
+    /**
+     *  Helper method to add a branch instruction, the target of forward
+     *  branches is filled in later by calling land()
+     *  @param  opcode      Branch, BranchIf or BranchIfNot
+     *  @param  condition   register with the condition
+     *  @param  target      the instruction to jump to
+     *  @return size_t      position of the branch instruction
+     */
+    size_t branch(Opcode opcode, size_t condition = 0, size_t target = 0);
+
+    /**
+     *  Make a forward branch jump to the next instruction that is added
+     *  @param  position    position of the branch instruction
+     */
+    void land(size_t position);
+
+    /**
+     *  Helper method to get the precompiled regex for a literal pattern
+     *  @param  pattern
+     *  @return boost::regex
+     */
+    const boost::regex *literalRegex(const Expression *pattern);
+
+    /**
+     *  Helper method to pop a register from the stack
+     *  @return size_t
+     */
+    size_t pop();
+
+    /**
+     *  Construct a pointer to a variable
+     *  @param  variable
+     *  @return size_t
+     */
+    size_t pointer(const Variable *variable);
+
+    /**
+     *  Retrieve the integer, boolean, floating point or pointer representation of an expression
+     *  @param  expression
+     *  @return size_t
+     */
+    size_t integerExpression(const Expression *expression);
+    size_t booleanExpression(const Expression *expression);
+    size_t doubleExpression(const Expression *expression);
+    size_t pointerExpression(const Expression *expression);
+
+    /**
+     *  Helper method to compare two expressions as numbers
+     *  @param  left
+     *  @param  right
+     *  @param  integer     instruction to compare integers
+     *  @param  number      instruction to compare floating point values
+     */
+    void compare(const Expression *left, const Expression *right, Opcode integer, Opcode number);
+
+    /**
+     *  Generate code to output raw data
+     *  @param  data                data to output
+     */
+    virtual void raw(const std::string &data) override;
+
+    /**
+     *  Generate the code to output a variable
+     *  @param  variable           The variable to output
+     */
+    virtual void output(const Variable *variable) override;
+
+    /**
+     *  Generate the code to output the output of a filter
+     *  @param  filter             The filter to eventually output
+     */
+    virtual void output(const Filter *filter) override;
+
+    /**
+     *  Generate the code to forget the cached output of a loop invariant expression
+     *  @param  slot                the cache slot
+     *  @param  root                the variable that the output depends on (may be a nullptr)
+     */
+    virtual void cacheReset(size_t slot, const Variable *root) override;
+
+    /**
+     *  Generate the code to output a loop invariant variable
+     *  @param  slot                the cache slot
+     *  @param  variable            the variable (or filter) to output
+     *  @param  escape              should the output be escaped?
+     */
+    virtual void cachedOutput(size_t slot, const Variable *variable, bool escape) override;
+
+    /**
+     *  Generate the code to write an expression as a string
+     *  @param  expression          the expression to write as a string
+     */
+    virtual void write(const Expression *expression) override;
+
+    /**
+     *  Generate a conditional statement
+     *  @param  expression          the expression to evaluate
+     *  @param  ifstatements        the statements in the 'if' part
+     *  @param  elsestatements      the statements in the 'else' part
+     */
+    virtual void condition(const Expression *expression, const Statements *ifstatements, const Statements *elsestatements) override;
+
+    /**
+     *  Generate the code to get a pointer to a variable
+     *  @param  parent              parent variable from which the var is retrieved
+     *  @param  name                name of the variable
+     *  @param  expression          Expression that evaluates to a var name
+     */
+    virtual void varPointer(const Variable *parent, const std::string &name) override;
+    virtual void varPointer(const Variable *parent, const Expression *expression) override;
+    virtual void varPointer(const std::string &name) override;
+
+    /**
+     *  Create a string or integer literal
+     *  @param  value
+     */
+    virtual void stringValue(const std::string &value) override;
+    virtual void integerValue(integer_t value) override;
+    virtual void doubleValue(double value) override;
+
+    /**
+     *  Create a string or integer constant for a variable
+     *  @param  variable
+     */
+    virtual void stringVariable(const Variable *variable) override;
+    virtual void integerVariable(const Variable *variable) override;
+    virtual void booleanVariable(const Variable *variable) override;
+    virtual void doubleVariable(const Variable *variable) override;
+    virtual void variable(const Variable *variable) override;
+
+    /**
+     *  Move a typed expression to the runtime space
+     *  @param  expression
+     */
+    virtual void pointerString(const Expression *expression) override;
+    virtual void pointerInteger(const Expression *expression) override;
+    virtual void pointerDouble(const Expression *expression) override;
+    virtual void pointerBoolean(const Expression *expression) override;
+
+    /**
+     *  Negate the boolean expression
+     *  @param  expression
+     */
+    virtual void negateBoolean(const Expression *expression) override;
+
+    /**
+     *  Arithmetric operations
+     *  @param  left
+     *  @param  right
+     */
+    virtual void integerPlus(const Expression *left, const Expression *right) override;
+    virtual void doublePlus(const Expression *left, const Expression *right) override;
+    virtual void pointerPlus(const Expression *left, const Expression *right) override;
+    virtual void integerMinus(const Expression *left, const Expression *right) override;
+    virtual void doubleMinus(const Expression *left, const Expression *right) override;
+    virtual void pointerMinus(const Expression *left, const Expression *right) override;
+    virtual void integerMultiply(const Expression *left, const Expression *right) override;
+    virtual void doubleMultiply(const Expression *left, const Expression *right) override;
+    virtual void pointerMultiply(const Expression *left, const Expression *right) override;
+    virtual void integerDivide(const Expression *left, const Expression *right) override;
+    virtual void doubleDivide(const Expression *left, const Expression *right) override;
+    virtual void pointerDivide(const Expression *left, const Expression *right) override;
+    virtual void integerModulo(const Expression *left, const Expression *right) override;
+    virtual void pointerModulo(const Expression *left, const Expression *right) override;
+
+    /**
+     *  Comparison operators
+     *  @param  left
+     *  @param  right
+     */
+    virtual void equals(const Expression *left, const Expression *right) override;
+    virtual void notEquals(const Expression *left, const Expression *right) override;
+    virtual void greater(const Expression *left, const Expression *right) override;
+    virtual void greaterEquals(const Expression *left, const Expression *right) override;
+    virtual void lesser(const Expression *left, const Expression *right) override;
+    virtual void lesserEquals(const Expression *left, const Expression *right) override;
+    virtual void regex(const Expression *left, const Expression *right) override;
+
+    /**
+     *  Boolean operators
+     *  @param  left
+     *  @param  right
+     */
+    virtual void booleanAnd(const Expression *left, const Expression *right) override;
+    virtual void booleanOr(const Expression *left, const Expression *right) override;
+
+    /**
+     *  Generate the code to apply a set of modifiers on an expression
+     *  @param  modifiers          The set of modifiers to apply
+     *  @param  variable           The variable to apply to modifers to
+     */
+    virtual void modifiers(const Modifiers *modifiers, const Variable *variable) override;
+
+    /**
+     *  Generate the code to apply a set of modifiers on an expression and turn it into a specific type
+     *  @param  modifiers          The set of modifiers to apply
+     *  @param  variable           The variable to apply to modifers to
+     */
+    virtual void modifiersString(const Modifiers *modifiers, const Variable *variable) override;
+    virtual void modifiersBoolean(const Modifiers *modifiers, const Variable *variable) override;
+    virtual void modifiersDouble(const Modifiers *modifiers, const Variable *variable) override;
+
+    /**
+     *  Generate the code to construct the following parameters
+     *  @param  parameters         The parameters to construct
+     */
+    virtual void parameters(const Parameters *parameters) override;
+
+    /**
+     *  Generate the code to do a foreach loop over variable
+     *  @param variable         The variable object to iterate over
+     *  @param key              The magic variable name for the keys
+     *  @param value            The magic variable name for the values
+     *  @param statements       The statements to execute on each iteration
+     *  @param else_statements  The statements to execute if there was nothing to loop through
+     */
+    virtual void foreach(const Variable *variable, const std::string &key, const std::string &value, const Statements *statements, const Statements *else_statements) override;
+
+    /**
+     *  Generate the code to assign the output of an expression to a key
+     *  @param key                  The key to assign the output to
+     *  @param expression           The expression to evaluate
+     */
+    virtual void assign(const std::string &key, const Expression *expression) override;
+
+public:
+    /**
+     *  Constructor
+     *  @param  source
+     *  @throws CompileError If the template could not be parsed
+     */
+    Interpreter(const Source &source);
+
+    /**
+     *  Destructor
+     */
+    virtual ~Interpreter() = default;
+
+    /**
+     *  Execute the template given a certain handler
+     *  @param  handler
+     */
+    void process(Handler &handler) override;
+
+    /**
+     *  Does the template use personalisation data?
+     *  @return bool
+     */
+    bool personalized() const override
+    {
+        // ask the tree whether it is personalized
+        return _tree.personalized();
+    }
+
+    /**
+     *  Is the output of the template always the same?
+     *  @return bool
+     */
+    bool constant() const override
+    {
+        // this is the case without variables and modifiers
+        return !_tree.personalized() && _modifiers.size() == 0;
+    }
+
+    /**
+     *  Compile the template into C code
+     *  @return std::string
+     */
+    std::string compile() override
+    {
+        // convert the syntax tree into C code
+        return CCode(_tree).asString();
+    }
+
+    /**
+     *  Retrieve what encoding the 'template' has natively
+     *  @return std::string
+     */
+    std::string encoding() override
+    {
+        return _tree.mode();
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
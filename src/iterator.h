@@ -23,6 +23,14 @@ namespace SmartTpl { namespace Internal {
 class Iterator
 {
 private:
+    /**
+     *  Copy of the source value (if it is a variant), this keeps the underlying
+     *  value alive when the variable is reassigned inside the loop
+     *
+     *  @var VariantValue
+     */
+    std::unique_ptr<VariantValue> _source;
+
     /**
      *  Iterator
      *
@@ -36,7 +44,8 @@ public:
      *  @param  source      The source value object to iterate over
      */
     Iterator(const Value *source) :
-        _iterator(source->iterator()) {}
+        _source(dynamic_cast<const VariantValue *>(source) ? new VariantValue(*static_cast<const VariantValue *>(source)) : nullptr),
+        _iterator(_source ? _source->iterator() : source->iterator()) {}
 
     /**
      *  Destructor
@@ -80,6 +89,15 @@ public:
         return _iterator->value();
     }
 
+    /**
+     *  Retrieve pointer to the current member, without copying it
+     *  @return Value       or nullptr if the iterator does not support this
+     */
+    const Value *current() const
+    {
+        return _iterator->current();
+    }
+
     /**
      *  Move to the next position
      */
@@ -0,0 +1,100 @@
+/**
+ *  JsonEscaper.cpp
+ *
+ *  Implementation of the scanner that finds the characters that have to be
+ *  escaped in a json string: control characters, quotes and backslashes.
+ *  On x86 processors we check 16 bytes at a time with SSE2.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Dependencies
+ */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Does a character have to be escaped?
+ *  @param  c
+ *  @return bool
+ */
+static inline bool special(unsigned char c)
+{
+    return c < 32 || c == '\"' || c == '\\';
+}
+
+#if defined(__SSE2__)
+
+/**
+ *  Find the special characters in a block of 16 bytes
+ *  @param  block       the block
+ *  @return int         bitmask with a bit set for each special character
+ */
+static inline int specials(__m128i block)
+{
+    // the characters that we look for (control characters are all characters up to 31)
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(31);
+
+    // a byte is a control character when the unsigned minimum with 31 is the byte itself
+    __m128i found = _mm_or_si128(
+        _mm_cmpeq_epi8(_mm_min_epu8(block, control), block),
+        _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash))
+    );
+
+    // turn the result into a bitmask, the lowest bit is the first character
+    return _mm_movemask_epi8(found);
+}
+
+#endif
+
+/**
+ *  Find the first character in a buffer that has to be escaped
+ *  @param  data        the buffer
+ *  @param  size        size of the buffer
+ *  @return size_t      position of the character, or size if there is none
+ */
+size_t JsonEscaper::scan(const char *data, size_t size)
+{
+    // start at the beginning
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // process blocks of 16 bytes
+    for (; i + 16 <= size; i += 16)
+    {
+        // check the block
+        int mask = specials(_mm_loadu_si128((const __m128i *)(data + i)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    // if the buffer is big enough, the tail is checked by loading the last 16 bytes (this
+    // overlaps with the previous block, so we ignore the bits for the bytes that we already had)
+    if (i < size && size >= 16)
+    {
+        // check the last block, and remove the bytes that were already checked
+        unsigned int mask = (unsigned int)specials(_mm_loadu_si128((const __m128i *)(data + size - 16))) >> (16 - (size - i));
+        return mask ? i + __builtin_ctz(mask) : size;
+    }
+#endif
+
+    // check the rest one character at a time
+    for (; i < size; ++i) if (special(data[i])) return i;
+
+    // nothing found
+    return size;
+}
+
+/**
+ *  End namespace
+ */
+}}
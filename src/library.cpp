@@ -61,6 +61,16 @@ static struct smart_tpl_callbacks callbacks = {
     .params_append_boolean = smart_tpl_params_append_boolean,
     .mark_failed           = smart_tpl_mark_failed,
     .throw_exception       = smart_tpl_throw_exception,
+    .enter_scope           = smart_tpl_enter_scope,
+    .leave_scope           = smart_tpl_leave_scope,
+    .variable_slot         = smart_tpl_variable_slot,
+    .modifier_slot         = smart_tpl_modifier_slot,
+    .regex_cached          = smart_tpl_regex_cached,
+    .regex_match           = smart_tpl_regex_match,
+    .regex_search          = smart_tpl_regex_search,
+    .cache_reset           = smart_tpl_cache_reset,
+    .output_cached         = smart_tpl_output_cached,
+    .output_store          = smart_tpl_output_store,
 };
 
 /**
@@ -69,6 +79,9 @@ static struct smart_tpl_callbacks callbacks = {
  */
 void Library::process(Handler &handler)
 {
+    // bind the variables and modifiers to the data
+    if (_slotted) handler.bind(_slots, _modifiers);
+
     // call the function
     _function(&callbacks, &handler);
 }
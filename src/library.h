@@ -46,6 +46,19 @@ private:
      */
     const char *_mode;
 
+    /**
+     *  The slot indices of the variables and modifiers that are used in the template
+     *  @var    Slots
+     */
+    Slots _slots;
+    Slots _modifiers;
+
+    /**
+     *  Does the library access variables by slot? (older libraries do not)
+     *  @var    bool
+     */
+    bool _slotted = false;
+
 public:
     /**
      *  Constructor
@@ -81,6 +94,22 @@ public:
 
         // Turn the const char ** into const char *
         _mode = *mode_ptr;
+
+        // find the names of the variables
+        const char **variables = (const char **) dlsym(_handle, "variables");
+
+        // older libraries do not have them, they only access variables by name
+        if (!variables) return;
+
+        // store the names
+        _slots = Slots(variables);
+        _slotted = true;
+
+        // find the names of the modifiers
+        const char **modifiers = (const char **) dlsym(_handle, "modifiers");
+
+        // store them too
+        if (modifiers) _modifiers = Slots(modifiers);
     }
 
     /**
@@ -108,6 +137,16 @@ public:
         return _personalized;
     }
 
+    /**
+     *  Is the output of the template always the same?
+     *  @return bool
+     */
+    bool constant() const override
+    {
+        // older libraries do not tell which modifiers they use
+        return !_personalized && _slotted && _modifiers.size() == 0;
+    }
+
     /**
      *  Compile the template into C code
      *  @return std::string
@@ -0,0 +1,227 @@
+/**
+ *  LibraryCache.h
+ *
+ *  Directory with templates that were compiled into shared libraries. When a
+ *  template is loaded with a cache directory, we first check whether the
+ *  directory already holds a shared library for it. If it does not, the
+ *  template is converted into C code, compiled with the system compiler,
+ *  and (atomically) stored in the directory, so that later processes only
+ *  have to load the library instead of compiling the template again.
+ *
+ *  The libraries are named after the SHA-256 hash of the template source,
+ *  the tokenizer version, and the version of the interface between the
+ *  generated code and this library.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class LibraryCache
+{
+private:
+    /**
+     *  The directory
+     *  @var std::string
+     */
+    std::string _directory;
+
+    /**
+     *  Revision of the generated code, this should be raised when the code
+     *  that is generated for the same template changes in a way that old
+     *  libraries can no longer be used
+     *  @var int
+     */
+    static constexpr int revision = 2;
+
+    /**
+     *  The name of the library for a template
+     *  @param  source      the template source
+     *  @return std::string the filename, or an empty string if the hash can not be calculated
+     */
+    std::string filename(const Source &source) const
+    {
+        // the hash is calculated with openssl
+        if (!OpenSSL::instance()) return std::string();
+
+        // calculate the hash of the source
+        unsigned char digest[SHA256_DIGEST_LENGTH];
+        OpenSSL::instance().SHA256((const unsigned char *)source.data(), source.size(), digest);
+
+        // start with the directory
+        std::ostringstream stream;
+        stream << _directory << '/' << std::setfill('0') << std::hex;
+
+        // add the hash
+        for (size_t i = 0; i < sizeof(digest); ++i) stream << std::setw(2) << (unsigned int)digest[i];
+
+        // the tokenizer version and the interface version (the callbacks are only ever
+        // added at the end, so the size of the struct tells which ones are available)
+        stream << std::dec << '-' << source.version() << '-' << sizeof(struct smart_tpl_callbacks) << '-' << revision << ".so";
+
+        // done
+        return stream.str();
+    }
+
+    /**
+     *  Split a list of arguments on whitespace, just like a shell would do
+     *  when there is no quoting (the arguments are not passed to a shell)
+     *  @param  value       the arguments
+     *  @param  arguments   the list to add them to
+     */
+    static void split(const char *value, std::vector<std::string> &arguments)
+    {
+        // read the words one by one
+        std::istringstream stream(value);
+        for (std::string argument; stream >> argument; ) arguments.push_back(std::move(argument));
+    }
+
+    /**
+     *  Run the C compiler, its errors end up on our own stderr
+     *  @param  input       file with the C code
+     *  @param  output      the library to create
+     *  @return bool        did the compiler succeed?
+     */
+    static bool compile(const std::string &input, const std::string &output)
+    {
+        // the compiler and its flags can be set in the environment
+        const char *compiler = getenv("CC");
+        const char *cflags = getenv("CFLAGS");
+
+        // the arguments for the compiler
+        std::vector<std::string> arguments;
+        split(compiler && *compiler ? compiler : "gcc", arguments);
+        arguments.insert(arguments.end(), { "-x", "c", "-fPIC", "-shared" });
+        split(cflags ? cflags : "-O2 -nostdlib", arguments);
+        arguments.insert(arguments.end(), { "-o", output, input });
+
+        // execvp() wants them as an array of pointers (this is prepared before we fork,
+        // because the child process of a multi-threaded program should not allocate)
+        std::vector<char *> argv;
+        for (auto &argument : arguments) argv.push_back(&argument[0]);
+        argv.push_back(nullptr);
+
+        // start the compiler
+        pid_t pid = fork();
+        if (pid < 0) return false;
+
+        // the child process runs the compiler, and only gets here if it does not exist
+        if (pid == 0) { execvp(argv[0], argv.data()); _exit(127); }
+
+        // wait for the compiler to finish
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0) if (errno != EINTR) return false;
+
+        // check if it was successful
+        return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    /**
+     *  Compile a template into a library
+     *  @param  source      the template source
+     *  @param  filename    the name of the library
+     *  @return bool        was the library created?
+     *  @throws CompileError
+     */
+    bool build(const Source &source, const std::string &filename) const
+    {
+        // convert the template into C code (this throws for invalid templates)
+        CCode code(source);
+
+        // other processes (or threads) might be building the same library, so
+        // we use temporary files of our own, and move the library into place when ready
+        static std::atomic<unsigned int> counter(0);
+        std::string temporary = filename + ".tmp." + std::to_string(getpid()) + "." + std::to_string(counter++);
+        std::string input = temporary + ".c";
+
+        // write the C code to a file (and not to a pipe, so that a compiler that
+        // exits early does not leave us with a SIGPIPE)
+        std::ofstream stream(input, std::ios::out | std::ios::trunc | std::ios::binary);
+        stream << code.asString();
+        stream.close();
+
+        // compile the code, and move the library into place if it was successful
+        bool success = stream && compile(input, temporary) && rename(temporary.c_str(), filename.c_str()) == 0;
+
+        // clean up the code, and the partial output
+        unlink(input.c_str());
+        if (!success) unlink(temporary.c_str());
+
+        // done
+        return success;
+    }
+
+    /**
+     *  Load a library
+     *  @param  filename    the name of the library
+     *  @return std::shared_ptr<Executor>
+     */
+    static std::shared_ptr<Executor> open(const std::string &filename)
+    {
+        try
+        {
+            // load the library
+            return std::make_shared<Library>(filename);
+        }
+        catch (const std::runtime_error &error)
+        {
+            // the library is not usable
+            return nullptr;
+        }
+    }
+
+public:
+    /**
+     *  Constructor
+     *
+     *  Relative directories get a "./" prefix, so that the filenames that we
+     *  pass to the compiler can not be mistaken for options.
+     *
+     *  @param  directory   the cache directory
+     */
+    LibraryCache(const std::string &directory) :
+        _directory(directory.empty() || directory[0] == '/' ? directory : "./" + directory) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~LibraryCache() = default;
+
+    /**
+     *  Get the compiled library for a template
+     *  @param  source      the template source
+     *  @return std::shared_ptr<Executor>   the library, or nullptr if it could not be compiled
+     *  @throws CompileError
+     */
+    std::shared_ptr<Executor> load(const Source &source) const
+    {
+        // find the name of the library
+        auto name = filename(source);
+        if (name.empty()) return nullptr;
+
+        // use the library if it already exists
+        if (access(name.c_str(), R_OK) == 0)
+        {
+            // load it
+            auto result = open(name);
+            if (result) return result;
+
+            // the library is broken, we build it again
+            unlink(name.c_str());
+        }
+
+        // build the library, and load it
+        return build(source, name) ? open(name) : nullptr;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
@@ -18,11 +18,6 @@ namespace SmartTpl { namespace Internal {
 class MapIterator : public SmartTpl::Iterator
 {
 private:
-    /**
-     *  The map we're iterating over
-     */
-    const std::map<std::string, VariantValue> _map;
-
     /**
      *  Iterator to the current position in our map
      */
@@ -36,11 +31,15 @@ private:
 public:
     /**
      *  Constructor
+     *
+     *  The map is not copied, the MapValue that holds it should stay alive
+     *  as long as the iterator is in use.
+     *
+     *  @param  value       the map to iterate over
      */
     MapIterator(const std::map<std::string, VariantValue> &value)
-    : _map(value),
-      _iter(_map.begin()),
-      _end(_map.end())
+    : _iter(value.begin()),
+      _end(value.end())
     {}
 
     /**
@@ -74,6 +73,15 @@ public:
         return _iter->second;
     }
 
+    /**
+     *  Retrieve pointer to the current member, without copying it
+     *  @return Value
+     */
+    const Value *current() const override
+    {
+        return &_iter->second;
+    }
+
     /**
      *  Retrieve a pointer to the current key
      *  @return Variant
@@ -54,6 +54,17 @@ public:
         _modifiers.emplace_back(modifier);
     }
 
+    /**
+     *  Remove a number of modifiers from the front of the list, this is used
+     *  when they were already applied at compile time
+     *  @param  count
+     */
+    void remove(size_t count)
+    {
+        // remove them one by one
+        while (count-- > 0 && !_modifiers.empty()) _modifiers.pop_front();
+    }
+
     /**
      *  Generate the output of these modifiers
      *  @param  generator
@@ -0,0 +1,643 @@
+/**
+ *  Number.cpp
+ *
+ *  Implementation of the number conversions. Integers are formatted two
+ *  digits at a time with a lookup table. Doubles are formatted exactly:
+ *  the binary mantissa is scaled with a 128 bit multiplication and rounded
+ *  half to even, which is what printf() does too. Parsing a double uses the
+ *  exact fast path for short mantissas and small exponents, and leaves all
+ *  other input (long mantissas, huge exponents, hexadecimal numbers, "inf"
+ *  and "nan") to strtod().
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  All pairs of digits, "00" up to "99"
+ *  @var char[]
+ */
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ *  The powers of ten that fit in an unsigned 64 bit integer
+ *  @var uint64_t[]
+ */
+static const uint64_t integerPowers[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+};
+
+/**
+ *  The powers of ten that can be represented exactly as a double
+ *  @var double[]
+ */
+static const double doublePowers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ *  Write an unsigned integer at the end of a buffer
+ *  @param  value       the value to write
+ *  @param  end         pointer just after the buffer
+ *  @return char*       pointer to the first digit
+ */
+static char *writeBackwards(uint64_t value, char *end)
+{
+    // write two digits at a time
+    while (value >= 100)
+    {
+        // the index of the two lowest digits
+        auto index = (value % 100) * 2;
+        value /= 100;
+
+        // write them
+        *--end = digitPairs[index + 1];
+        *--end = digitPairs[index];
+    }
+
+    // the last one or two digits
+    if (value >= 10)
+    {
+        *--end = digitPairs[value * 2 + 1];
+        *--end = digitPairs[value * 2];
+    }
+    else *--end = '0' + value;
+
+    // done
+    return end;
+}
+
+/**
+ *  Write an unsigned integer with a fixed number of digits (padded with zeros)
+ *  @param  value       the value to write
+ *  @param  digits      number of digits
+ *  @param  buffer      the buffer to write to
+ */
+static void writeFixed(uint64_t value, size_t digits, char *buffer)
+{
+    // fill the buffer from the end
+    for (size_t i = digits; i > 0; --i, value /= 10) buffer[i - 1] = '0' + value % 10;
+}
+
+/**
+ *  Helper class that holds a double that is rounded to a fixed number of
+ *  decimals, split up in an integral and a fractional part
+ */
+struct FixedDouble
+{
+    /**
+     *  Is the value negative? (this is also true for a negative value that is
+     *  rounded to zero, because printf() writes "-0" for these values too)
+     *  @var bool
+     */
+    bool negative = false;
+
+    /**
+     *  The digits before the decimal point
+     *  @var uint64_t
+     */
+    uint64_t integral = 0;
+
+    /**
+     *  The digits after the decimal point
+     *  @var uint64_t
+     */
+    uint64_t fraction = 0;
+
+    /**
+     *  Round a value
+     *  @param  value       the value to round
+     *  @param  decimals    number of decimals, at most 19
+     *  @return bool        false if the value is too big (or not finite), and can not be handled here
+     */
+    bool assign(double value, size_t decimals)
+    {
+        // get the bits that make up the double
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        // split up in sign, exponent and mantissa
+        negative = bits >> 63;
+        int exponent = (bits >> 52) & 0x7ff;
+        uint64_t mantissa = bits & ((1ull << 52) - 1);
+
+        // infinity and nan can not be handled here
+        if (exponent == 0x7ff) return false;
+
+        // normal values have an implicit leading bit, so that the value is mantissa * 2^shift
+        int shift = exponent == 0 ? -1074 : exponent - 1075;
+        if (exponent != 0) mantissa |= 1ull << 52;
+
+        // values without a fraction can be written as an integer if they fit
+        if (shift >= 0)
+        {
+            // the mantissa has 53 bits, so the value fits in 63 bits if we shift at most 10 bits
+            if (shift > 10) return false;
+
+            // the value is an integer
+            integral = mantissa << shift;
+            fraction = 0;
+
+            // done
+            return true;
+        }
+
+        // the value is mantissa / 2^bits
+        unsigned int bitcount = -shift;
+
+        // the part before the decimal point, and the bits that make up the fraction
+        integral = bitcount < 64 ? mantissa >> bitcount : 0;
+        uint64_t remainder = bitcount < 64 ? mantissa & ((1ull << bitcount) - 1) : mantissa;
+
+        // the power of ten to scale the fraction with
+        uint64_t scale = integerPowers[decimals];
+
+        // the scaled fraction (this fits in 117 bits, because the mantissa has 53 bits)
+        unsigned __int128 scaled = (unsigned __int128)remainder * scale;
+
+        // if the fraction is shifted out completely, it is less than half and rounds to zero
+        if (bitcount > 117)
+        {
+            fraction = 0;
+            return true;
+        }
+
+        // split the scaled value in the decimals and the bits that are rounded off
+        fraction = scaled >> bitcount;
+        unsigned __int128 rest = scaled & (((unsigned __int128)1 << bitcount) - 1);
+        unsigned __int128 half = (unsigned __int128)1 << (bitcount - 1);
+
+        // the last digit that is written, for rounding half to even
+        uint64_t last = decimals == 0 ? integral : fraction;
+
+        // keep the value if we are less than halfway, or exactly halfway and the last digit is even
+        if (rest < half || (rest == half && (last & 1) == 0)) return true;
+
+        // round up, and carry over to the integral part
+        if (++fraction < scale) return true;
+
+        // the fraction overflowed
+        fraction = 0;
+        integral += 1;
+
+        // done
+        return true;
+    }
+};
+
+/**
+ *  Format a double with printf(), for the values that are not handled by FixedDouble
+ *  @param  value       the value to format
+ *  @param  decimals    the number of decimals
+ *  @return std::string
+ */
+static std::string printFixed(double value, int decimals)
+{
+    // find out how much room is needed
+    int size = snprintf(nullptr, 0, "%.*f", decimals, value);
+
+    // format in a string that is big enough (including the null character)
+    std::string result(size + 1, '\0');
+    snprintf(&result[0], result.size(), "%.*f", decimals, value);
+
+    // remove the null character
+    result.resize(size);
+
+    // done
+    return result;
+}
+
+/**
+ *  Check if a character is whitespace, in the same way as isspace() does in the C locale
+ *  @param  c
+ *  @return bool
+ */
+static bool isWhitespace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ *  Check if a character is a decimal digit
+ *  @param  c
+ *  @return bool
+ */
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ *  Parse a double with strtod(), for the input that is not handled by the fast path
+ *  @param  data        the text to parse
+ *  @param  size        size of the text
+ *  @param  result      the parsed value
+ *  @return bool
+ */
+static bool parseSlow(const char *data, size_t size, double &result)
+{
+    // strtod() needs a null terminated string, short strings are copied to the stack
+    char buffer[128];
+    std::string copy;
+    const char *text = buffer;
+
+    // copy the text
+    if (size < sizeof(buffer)) { memcpy(buffer, data, size); buffer[size] = '\0'; }
+    else { copy.assign(data, size); text = copy.c_str(); }
+
+    // parse the number
+    char *end = nullptr;
+    errno = 0;
+    result = strtod(text, &end);
+
+    // was it a valid number?
+    if (end != text && errno != ERANGE) return true;
+
+    // the text could not be parsed, or is out of range
+    result = 0.0;
+    return false;
+}
+
+/**
+ *  End of internal namespace
+ */
+}
+
+/**
+ *  Format an integer
+ *  @param  value       the value to format
+ *  @param  buffer      buffer of at least integerSize bytes
+ *  @return size_t      number of bytes written
+ */
+size_t Number::format(integer_t value, char *buffer)
+{
+    // the absolute value (this also works for the lowest possible value)
+    uint64_t absolute = value < 0 ? 0 - (uint64_t)value : value;
+
+    // write the digits at the end of a temporary buffer
+    char digits[integerSize];
+    char *begin = Internal::writeBackwards(absolute, digits + integerSize);
+
+    // add the sign
+    if (value < 0) *--begin = '-';
+
+    // copy the result to the front of the buffer
+    size_t size = digits + integerSize - begin;
+    memcpy(buffer, begin, size);
+
+    // done
+    return size;
+}
+
+/**
+ *  Format a double with at most five decimals
+ *  @param  value       the value to format
+ *  @param  buffer      buffer of at least doubleSize bytes
+ *  @return size_t      number of bytes written
+ */
+size_t Number::format(double value, char *buffer)
+{
+    // round the value to five decimals
+    Internal::FixedDouble fixed;
+
+    // very big values, infinity and nan are left to printf()
+    if (!fixed.assign(value, 5))
+    {
+        // format the string
+        size_t written = snprintf(buffer, doubleSize, "%.5f", value);
+
+        // remove trailing zeroes
+        while (buffer[written - 1] == '0') written--;
+
+        // round number?
+        if (buffer[written - 1] == '.') written--;
+
+        // done
+        return written;
+    }
+
+    // start with the sign
+    char *current = buffer;
+    if (fixed.negative) *current++ = '-';
+
+    // write the digits before the decimal point
+    char digits[integerSize];
+    char *begin = Internal::writeBackwards(fixed.integral, digits + integerSize);
+    size_t size = digits + integerSize - begin;
+    memcpy(current, begin, size);
+    current += size;
+
+    // without a fraction we are ready
+    if (fixed.fraction == 0) return current - buffer;
+
+    // write the decimals
+    *current++ = '.';
+    Internal::writeFixed(fixed.fraction, 5, current);
+    current += 5;
+
+    // remove the trailing zeros
+    while (current[-1] == '0') --current;
+
+    // done
+    return current - buffer;
+}
+
+/**
+ *  Append a formatted integer to a string
+ *  @param  value       the value to format
+ *  @param  output      the string to append to
+ */
+void Number::append(integer_t value, std::string &output)
+{
+    // format in a buffer on the stack
+    char buffer[integerSize];
+    output.append(buffer, format(value, buffer));
+}
+
+/**
+ *  Append a formatted double to a string
+ *  @param  value       the value to format
+ *  @param  output      the string to append to
+ */
+void Number::append(double value, std::string &output)
+{
+    // format in a buffer on the stack
+    char buffer[doubleSize];
+    output.append(buffer, format(value, buffer));
+}
+
+/**
+ *  Append a double with a fixed number of decimals and custom separators
+ *  @param  value       the value to format
+ *  @param  decimals    number of decimals
+ *  @param  point       the decimal separator
+ *  @param  thousands   the thousands separator, or zero for no separator
+ *  @param  output      the string to append to
+ */
+void Number::append(double value, int decimals, char point, char thousands, std::string &output)
+{
+    // a negative precision means the default precision for streams
+    if (decimals < 0) decimals = 6;
+
+    // buffers for the digits before and after the decimal point
+    char integral[integerSize];
+    char fraction[20];
+
+    // the digits that are going to be written
+    bool negative;
+    const char *digits;
+    size_t size;
+    const char *decimal = fraction;
+
+    // the value formatted by printf() (only used for the values that we can not handle ourselves)
+    std::string printed;
+
+    // round the value to the number of decimals
+    Internal::FixedDouble fixed;
+    if (decimals <= 19 && fixed.assign(value, decimals))
+    {
+        // write the digits
+        negative = fixed.negative;
+        digits = Internal::writeBackwards(fixed.integral, integral + integerSize);
+        size = integral + integerSize - digits;
+        Internal::writeFixed(fixed.fraction, decimals, fraction);
+    }
+    else
+    {
+        // let printf() do the work
+        printed = Internal::printFixed(value, decimals);
+
+        // split up in the sign, the digits before the point, and the decimals
+        negative = printed[0] == '-';
+        digits = printed.data() + negative;
+        size = std::min(printed.find('.'), printed.size()) - negative;
+        decimal = digits + size + 1;
+
+        // infinity and nan have no decimals
+        if (decimal > printed.data() + printed.size()) decimals = 0;
+    }
+
+    // reserve the space that is needed
+    output.reserve(output.size() + negative + size + size / 3 + 1 + decimals);
+
+    // start with the sign
+    if (negative) output.push_back('-');
+
+    // without a separator the digits can be copied at once
+    if (thousands == 0) output.append(digits, size);
+
+    // otherwise we insert a separator before every group of three digits
+    else for (size_t i = 0; i < size; ++i)
+    {
+        // insert the separator
+        if (i > 0 && (size - i) % 3 == 0) output.push_back(thousands);
+
+        // add the digit
+        output.push_back(digits[i]);
+    }
+
+    // add the decimals
+    if (decimals == 0) return;
+    output.push_back(point);
+    output.append(decimal, decimals);
+}
+
+/**
+ *  Convert an integer to a string
+ *  @param  value       the value to convert
+ *  @return std::string
+ */
+std::string Number::toString(integer_t value)
+{
+    // format in a buffer on the stack
+    char buffer[integerSize];
+    return std::string(buffer, format(value, buffer));
+}
+
+/**
+ *  Convert a double to a string
+ *  @param  value       the value to convert
+ *  @return std::string
+ */
+std::string Number::toString(double value)
+{
+    // format in a buffer on the stack
+    char buffer[doubleSize];
+    return std::string(buffer, format(value, buffer));
+}
+
+/**
+ *  Parse an integer
+ *  @param  data        the text to parse
+ *  @param  size        size of the text
+ *  @param  result      the parsed value
+ *  @return bool
+ */
+bool Number::parse(const char *data, size_t size, integer_t &result)
+{
+    // nothing has been parsed yet
+    result = 0;
+
+    // the end of the input
+    const char *end = data + size;
+
+    // skip leading whitespace
+    while (data < end && Internal::isWhitespace(*data)) ++data;
+
+    // check for a sign
+    bool negative = data < end && *data == '-';
+    if (data < end && (*data == '-' || *data == '+')) ++data;
+
+    // there should be at least one digit
+    if (data == end || !Internal::isDigit(*data)) return false;
+
+    // the highest value that is allowed
+    uint64_t limit = negative ? 9223372036854775808ull : 9223372036854775807ull;
+
+    // parse the digits
+    uint64_t value = 0;
+    for (; data < end && Internal::isDigit(*data); ++data)
+    {
+        // the value of the digit
+        unsigned int digit = *data - '0';
+
+        // check for an overflow
+        if (value > (limit - digit) / 10) return false;
+
+        // add the digit
+        value = value * 10 + digit;
+    }
+
+    // store the result (the conversion is well-defined because the value is in range)
+    result = negative ? (integer_t)(0 - value) : (integer_t)value;
+
+    // done
+    return true;
+}
+
+/**
+ *  Parse a double
+ *  @param  data        the text to parse
+ *  @param  size        size of the text
+ *  @param  result      the parsed value
+ *  @return bool
+ */
+bool Number::parse(const char *data, size_t size, double &result)
+{
+    // the end of the input
+    const char *end = data + size;
+
+    // skip leading whitespace
+    while (data < end && Internal::isWhitespace(*data)) ++data;
+
+    // the number starts here (this is where the slow path starts too)
+    const char *start = data;
+
+    // check for a sign
+    bool negative = data < end && *data == '-';
+    if (data < end && (*data == '-' || *data == '+')) ++data;
+
+    // hexadecimal numbers are left to strtod()
+    if (end - data > 1 && data[0] == '0' && (data[1] == 'x' || data[1] == 'X')) return Internal::parseSlow(start, end - start, result);
+
+    // the significant digits, the number of them, and the number of zeros that were not yet added
+    uint64_t mantissa = 0;
+    int significant = 0;
+    int zeros = 0;
+
+    // the number of digits in total, and the number of digits after the decimal point
+    int digits = 0;
+    int decimals = 0;
+
+    // parse the digits before and after the decimal point
+    for (bool point = false; data < end; ++data)
+    {
+        // check for the decimal point
+        if (*data == '.' && !point) { point = true; continue; }
+
+        // stop at the first character that is not a digit
+        if (!Internal::isDigit(*data)) break;
+
+        // keep track of the number of digits
+        digits += 1;
+        decimals += point;
+
+        // zeros are only added to the mantissa when another digit follows
+        if (*data == '0') { zeros += significant > 0; continue; }
+
+        // we can not handle more than 19 significant digits
+        significant += zeros + 1;
+        if (significant > 19) return Internal::parseSlow(start, end - start, result);
+
+        // add the digits
+        mantissa = mantissa * Internal::integerPowers[zeros + 1] + (*data - '0');
+        zeros = 0;
+    }
+
+    // without digits this is not a number (or it is "inf" or "nan")
+    if (digits == 0) return Internal::parseSlow(start, end - start, result);
+
+    // the power of ten with which the mantissa should be multiplied
+    int exponent = zeros - decimals;
+
+    // check for an exponent, which should have at least one digit
+    if (end - data > 1 && (*data == 'e' || *data == 'E'))
+    {
+        // skip the 'e' and the sign
+        const char *current = data + 1;
+        bool negativeExponent = *current == '-';
+        if (*current == '-' || *current == '+') ++current;
+
+        // parse the digits of the exponent (we stop counting at a ridiculous value)
+        int value = 0;
+        for (data = current; current < end && Internal::isDigit(*current); ++current)
+        {
+            if (value < 100000) value = value * 10 + (*current - '0');
+        }
+
+        // apply the exponent if there were digits
+        if (current > data) exponent += negativeExponent ? -value : value;
+    }
+
+    // the mantissa and the power of ten should be exact doubles
+    if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+    {
+        // zero is always zero
+        if (mantissa != 0) return Internal::parseSlow(start, end - start, result);
+        exponent = 0;
+    }
+
+    // calculate the value, both operands are exact so the result is correctly rounded
+    double value = (double)mantissa;
+    value = exponent < 0 ? value / Internal::doublePowers[-exponent] : value * Internal::doublePowers[exponent];
+
+    // apply the sign
+    result = negative ? -value : value;
+
+    // done
+    return true;
+}
+
+/**
+ *  End namespace
+ */
+}
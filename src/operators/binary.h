@@ -51,6 +51,47 @@ public:
      *  @return Type
      */
     virtual Type type() const override { return Type::Boolean; }
+
+    /**
+     *  Evaluate the operator at compile time
+     *  @param  left
+     *  @param  right
+     *  @return Literal     the result, or nullptr if it can not be evaluated at compile time
+     */
+    virtual Literal *evaluate(const Literal &left, const Literal &right) const
+    {
+        // by default operators are evaluated at runtime
+        return nullptr;
+    }
+
+    /**
+     *  Optimize the expression before code is generated for it
+     *  @return Expression
+     */
+    virtual Expression *optimize() override
+    {
+        // optimize both operands first
+        Expression::optimize(_left);
+        Expression::optimize(_right);
+
+        // we can only calculate the result if both operands are literals
+        auto *left = dynamic_cast<Literal*>(_left.get());
+        auto *right = dynamic_cast<Literal*>(_right.get());
+
+        // evaluate the operator, or leave it alone
+        return left && right ? evaluate(*left, *right) : nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that the expression depends on
+     *  @param  names
+     *  @return bool
+     */
+    virtual bool variables(std::set<std::string> &names) const override
+    {
+        // we depend on both operands
+        return _left->variables(names) && _right->variables(names);
+    }
 };
 
 /**
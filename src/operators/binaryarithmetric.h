@@ -45,6 +45,44 @@ public:
         // otherwise, we have to determine at runtime
         return Type::Value;
     }
+
+    /**
+     *  Calculate the result of the operator for integer operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool        false if the result has to be calculated at runtime
+     */
+    virtual bool integerCalculate(integer_t left, integer_t right, integer_t &result) const { return false; }
+
+    /**
+     *  Calculate the result of the operator for double operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool        false if the result has to be calculated at runtime
+     */
+    virtual bool doubleCalculate(double left, double right, double &result) const { return false; }
+
+    /**
+     *  Evaluate the operator at compile time
+     *  @param  left
+     *  @param  right
+     *  @return Literal
+     */
+    virtual Literal *evaluate(const Literal &left, const Literal &right) const override
+    {
+        // the result of the calculation
+        integer_t integer;
+        double number;
+
+        // the type of the operation determines how the operands are converted
+        switch (type()) {
+        case Type::Integer: return integerCalculate(left.integerValue(), right.integerValue(), integer) ? new LiteralInteger(integer) : nullptr;
+        case Type::Double:  return doubleCalculate(left.doubleValue(), right.doubleValue(), number) ? new LiteralDouble(number) : nullptr;
+        default:            return nullptr;
+        }
+    }
 };
 
 /**
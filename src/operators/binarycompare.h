@@ -29,6 +29,52 @@ public:
      *  Destructor
      */
     virtual ~BinaryCompareOperator() {}
+
+protected:
+    /**
+     *  Check at compile time whether two literals are equal, this uses the
+     *  same conversions as the generated code
+     *  @param  left
+     *  @param  right
+     *  @return bool
+     */
+    static bool equal(const Literal &left, const Literal &right)
+    {
+        // if one of the operands is a double, they are compared as doubles
+        if (left.type() == Type::Double || right.type() == Type::Double) return left.doubleValue() == right.doubleValue();
+
+        // otherwise if one of them is an integer, they are compared as integers
+        if (left.type() == Type::Integer || right.type() == Type::Integer) return left.integerValue() == right.integerValue();
+
+        // otherwise if one of them is a boolean, they are compared as booleans
+        if (left.type() == Type::Boolean || right.type() == Type::Boolean) return left.booleanValue() == right.booleanValue();
+
+        // strings are compared with strncmp() at runtime, which stops at a null character
+        auto l = left.stringValue(), r = right.stringValue();
+        return l.size() == r.size() && strncmp(l.data(), r.data(), l.size()) == 0;
+    }
+
+    /**
+     *  Should two literals be compared as doubles by an ordering operator?
+     *  @param  left
+     *  @param  right
+     *  @return bool
+     */
+    static bool doubles(const Literal &left, const Literal &right)
+    {
+        return left.type() == Type::Double || right.type() == Type::Double;
+    }
+
+    /**
+     *  The value of an operand of an ordering operator, when compared as double
+     *  (operands that are no doubles are converted to integer first)
+     *  @param  literal
+     *  @return double
+     */
+    static double number(const Literal &literal)
+    {
+        return literal.type() == Type::Double ? literal.doubleValue() : literal.integerValue();
+    }
 };
 
 /**
@@ -57,6 +57,41 @@ public:
     {
         generator->pointerDivide(_left.get(), _right.get());
     }
+
+    /**
+     *  Calculate the result of the operator for integer operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool
+     */
+    virtual bool integerCalculate(integer_t left, integer_t right, integer_t &result) const override
+    {
+        // division by zero is an error that has to be reported at runtime, and
+        // the one division that overflows is left to the runtime as well
+        if (right == 0 || (left == INT64_MIN && right == -1)) return false;
+
+        // calculate the result
+        result = left / right;
+        return true;
+    }
+
+    /**
+     *  Calculate the result of the operator for double operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool
+     */
+    virtual bool doubleCalculate(double left, double right, double &result) const override
+    {
+        // division by zero is an error that has to be reported at runtime
+        if (right == 0) return false;
+
+        // calculate the result
+        result = left / right;
+        return true;
+    }
 };
 
 /**
@@ -48,6 +48,17 @@ public:
     {
         generator->equals(_left.get(), _right.get());
     }
+
+    /**
+     *  Evaluate the operator at compile time
+     *  @param  left
+     *  @param  right
+     *  @return Literal
+     */
+    virtual Literal *evaluate(const Literal &left, const Literal &right) const override
+    {
+        return new LiteralBoolean(equal(left, right));
+    }
 };
 
 /**
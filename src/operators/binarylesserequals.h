@@ -48,6 +48,21 @@ public:
     {
         generator->lesserEquals(_left.get(), _right.get());
     }
+
+    /**
+     *  Evaluate the operator at compile time
+     *  @param  left
+     *  @param  right
+     *  @return Literal
+     */
+    virtual Literal *evaluate(const Literal &left, const Literal &right) const override
+    {
+        // compare the operands as doubles if one of them is a double
+        if (doubles(left, right)) return new LiteralBoolean(number(left) <= number(right));
+
+        // otherwise they are compared as integers
+        return new LiteralBoolean(left.integerValue() <= right.integerValue());
+    }
 };
 
 /**
@@ -57,6 +57,34 @@ public:
     {
         generator->pointerMinus(_left.get(), _right.get());
     }
+
+    /**
+     *  Calculate the result of the operator for integer operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool
+     */
+    virtual bool integerCalculate(integer_t left, integer_t right, integer_t &result) const override
+    {
+        // integer overflow wraps around, just like it does at runtime
+        result = (integer_t)((uint64_t)left - (uint64_t)right);
+        return true;
+    }
+
+    /**
+     *  Calculate the result of the operator for double operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool
+     */
+    virtual bool doubleCalculate(double left, double right, double &result) const override
+    {
+        // calculate the result
+        result = left - right;
+        return true;
+    }
 };
 
 /**
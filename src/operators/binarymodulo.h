@@ -68,6 +68,22 @@ public:
         return Type::Integer;
     }
 
+    /**
+     *  Calculate the result of the operator for integer operands at compile time
+     *  @param  left
+     *  @param  right
+     *  @param  result
+     *  @return bool
+     */
+    virtual bool integerCalculate(integer_t left, integer_t right, integer_t &result) const override
+    {
+        // leave the cases that can not be calculated to the runtime
+        if (right == 0 || (left == INT64_MIN && right == -1)) return false;
+
+        // calculate the result
+        result = left % right;
+        return true;
+    }
 };
 
 /**
@@ -0,0 +1,261 @@
+/**
+ *  RegexCache.cpp
+ *
+ *  Implementation of the process-wide regex cache. To prevent that all
+ *  threads fight over one lock, the cache is split into a number of shards
+ *  that each have their own lock and their own LRU list. A pattern always
+ *  ends up in the same shard, based on its hash.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class RegexShard
+{
+private:
+    /**
+     *  An entry in the LRU list
+     */
+    struct Entry
+    {
+        /**
+         *  The key (the flags and the pattern)
+         */
+        std::string key;
+
+        /**
+         *  The compiled regex
+         */
+        std::shared_ptr<const boost::regex> regex;
+    };
+
+    /**
+     *  Lock to protect the members
+     *  @var    std::mutex
+     */
+    std::mutex _mutex;
+
+    /**
+     *  The entries, the most recently used one first
+     *  @var    std::list
+     */
+    std::list<Entry> _entries;
+
+    /**
+     *  Index to find the entries by their key
+     *  @var    std::unordered_map
+     */
+    std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+
+    /**
+     *  Remove the least recently used entries until there are at most capacity left
+     *  @param  capacity
+     */
+    void shrink(size_t capacity)
+    {
+        // remove from the back of the list
+        while (_entries.size() > capacity)
+        {
+            // forget the entry
+            _index.erase(_entries.back().key);
+            _entries.pop_back();
+        }
+    }
+
+public:
+    /**
+     *  Find a regex
+     *  @param  key         the key to look for
+     *  @return std::shared_ptr
+     */
+    std::shared_ptr<const boost::regex> find(const std::string &key)
+    {
+        // lock the shard
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // look up the key
+        auto iter = _index.find(key);
+        if (iter == _index.end()) return nullptr;
+
+        // it is now the most recently used one
+        _entries.splice(_entries.begin(), _entries, iter->second);
+
+        // expose the regex
+        return iter->second->regex;
+    }
+
+    /**
+     *  Add a regex, if another thread added the same key in the meantime,
+     *  the regex of the other thread is returned
+     *  @param  key         the key
+     *  @param  regex       the compiled regex
+     *  @param  capacity    max number of regexes in this shard
+     *  @return std::shared_ptr
+     */
+    std::shared_ptr<const boost::regex> insert(const std::string &key, std::shared_ptr<const boost::regex> regex, size_t capacity)
+    {
+        // lock the shard
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // perhaps another thread was faster
+        auto iter = _index.find(key);
+        if (iter != _index.end()) return iter->second->regex;
+
+        // add it to the front of the list
+        _entries.push_front(Entry{ key, std::move(regex) });
+        _index.emplace(key, _entries.begin());
+
+        // make sure that we do not exceed the capacity
+        shrink(capacity);
+
+        // expose the regex (it could already be removed if the capacity is zero)
+        return _entries.empty() ? nullptr : _entries.front().regex;
+    }
+
+    /**
+     *  Change the capacity
+     *  @param  capacity    max number of regexes in this shard
+     */
+    void capacity(size_t capacity)
+    {
+        // lock the shard
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // remove the entries that no longer fit
+        shrink(capacity);
+    }
+
+    /**
+     *  Number of regexes in the shard
+     *  @return size_t
+     */
+    size_t size()
+    {
+        // lock the shard
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // the number of entries
+        return _entries.size();
+    }
+};
+
+/**
+ *  Number of shards
+ *  @var    size_t
+ */
+static constexpr size_t shards = 16;
+
+/**
+ *  All shards
+ *  @var    RegexShard
+ */
+static RegexShard regexShards[shards];
+
+/**
+ *  Max number of regexes in the cache
+ *  @var    std::atomic
+ */
+static std::atomic<size_t> regexCapacity(256);
+
+/**
+ *  Max number of regexes in a single shard
+ *  @return size_t
+ */
+static size_t shardCapacity()
+{
+    // round up, so that a small capacity does not end up as zero per shard
+    return (regexCapacity.load(std::memory_order_relaxed) + shards - 1) / shards;
+}
+
+/**
+ *  End of internal namespace
+ */
+}
+
+/**
+ *  Get a compiled regex
+ *  @param  pattern     the regular expression
+ *  @param  flags       flags for compiling the regex
+ *  @return std::shared_ptr
+ */
+std::shared_ptr<const boost::regex> RegexCache::get(const std::string &pattern, Flags flags)
+{
+    // the key consists of the flags followed by the pattern
+    std::string key((const char *)&flags, sizeof(flags));
+    key.append(pattern);
+
+    // the shard in which the regex is stored
+    auto &shard = Internal::regexShards[Internal::nameHash(key.data(), key.size()) % Internal::shards];
+
+    // check if it was already compiled
+    auto regex = shard.find(key);
+    if (regex) return regex;
+
+    // compile the regex, this is done without holding a lock, so that we do not block
+    // other threads (an exception is thrown if the pattern is invalid)
+    regex = std::make_shared<const boost::regex>(pattern, flags);
+
+    // store it in the cache (if the cache is disabled we simply use our own copy)
+    auto result = shard.insert(key, regex, Internal::shardCapacity());
+
+    // expose the regex
+    return result ? result : regex;
+}
+
+/**
+ *  The max number of regexes in the cache
+ *  @return size_t
+ */
+size_t RegexCache::capacity()
+{
+    return Internal::regexCapacity.load(std::memory_order_relaxed);
+}
+
+/**
+ *  Change the max number of regexes in the cache
+ *  @param  capacity    the new capacity
+ */
+void RegexCache::capacity(size_t capacity)
+{
+    // store the new capacity
+    Internal::regexCapacity.store(capacity, std::memory_order_relaxed);
+
+    // apply it to all shards
+    for (auto &shard : Internal::regexShards) shard.capacity(Internal::shardCapacity());
+}
+
+/**
+ *  Number of regexes that are currently in the cache
+ *  @return size_t
+ */
+size_t RegexCache::size()
+{
+    // the total size of all shards
+    size_t result = 0;
+    for (auto &shard : Internal::regexShards) result += shard.size();
+
+    // done
+    return result;
+}
+
+/**
+ *  Remove all regexes from the cache
+ */
+void RegexCache::clear()
+{
+    // remove all entries from all shards
+    for (auto &shard : Internal::regexShards) shard.capacity(0);
+}
+
+/**
+ *  End namespace
+ */
+}
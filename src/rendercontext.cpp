@@ -0,0 +1,63 @@
+/**
+ *  RenderContext.cpp
+ *
+ *  Implementation of the RenderContext class
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Constructor
+ */
+RenderContext::RenderContext() : RenderContext(true) {}
+
+/**
+ *  Constructor that can allocate every temporary value on the heap (only for the benchmarks)
+ *  @param  arena       allocate the temporary values from an arena?
+ */
+RenderContext::RenderContext(bool arena) : _handler(new Internal::Handler(nullptr, nullptr, !arena)) {}
+
+/**
+ *  Destructor
+ */
+RenderContext::~RenderContext()
+{
+    // we no longer need the handler
+    delete _handler;
+}
+
+/**
+ *  The output of the last call to Template::process()
+ *  @return std::string
+ */
+const std::string &RenderContext::output() const
+{
+    return _handler->output();
+}
+
+/**
+ *  Move the output of the last call to Template::process() out of the context
+ *  @return std::string
+ */
+std::string RenderContext::release()
+{
+    // move the buffer out of the handler
+    std::string result(std::move(_handler->output()));
+
+    // leave the handler with a valid (empty) buffer
+    _handler->output().clear();
+
+    // done
+    return result;
+}
+
+/**
+ *  End namespace
+ */
+}
@@ -0,0 +1,73 @@
+/**
+ *  Segments.cpp
+ *
+ *  Implementation of the Segments class
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Constructor
+ */
+Segments::Segments() : _handler(new Internal::Handler(nullptr, nullptr)) {}
+
+/**
+ *  Destructor
+ */
+Segments::~Segments()
+{
+    // we no longer need the handler
+    delete _handler;
+}
+
+/**
+ *  Collect the segments from the handler
+ */
+void Segments::collect()
+{
+    // the buffer with the dynamic output will no longer change, so we can point into it
+    const auto &buffer = _handler->output();
+
+    // forget the previous call, but keep the memory
+    _segments.clear();
+    _bytes = 0;
+
+    // convert the segments
+    for (const auto &segment : _handler->segments())
+    {
+        // the dynamic parts are stored in the buffer
+        const char *data = segment.data ? segment.data : buffer.data() + segment.offset;
+
+        // add the segment
+        _segments.push_back(iovec{ const_cast<char *>(data), segment.size });
+        _bytes += segment.size;
+    }
+}
+
+/**
+ *  Copy the entire output into one string
+ *  @return std::string
+ */
+std::string Segments::str() const
+{
+    // allocate the string in one go
+    std::string result;
+    result.reserve(_bytes);
+
+    // append all segments
+    for (const auto &segment : _segments) result.append((const char *)segment.iov_base, segment.iov_len);
+
+    // done
+    return result;
+}
+
+/**
+ *  End namespace
+ */
+}
@@ -0,0 +1,148 @@
+/**
+ *  Slots.h
+ *
+ *  The names of all variables that are used in a template. Every distinct
+ *  name gets its own slot index when the template is compiled, so that at
+ *  runtime a variable can be fetched from an array instead of looking it
+ *  up by name every time it is accessed.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class Slots
+{
+private:
+    /**
+     *  Names of the variables, the position in the vector is the slot index
+     *  @var    std::vector
+     */
+    std::vector<std::string> _names;
+
+    /**
+     *  The slot index of each name
+     *  @var    std::map
+     */
+    std::map<std::string, size_t> _indices;
+
+    /**
+     *  Hashes of the names, so that they do not have to be calculated
+     *  every time the slots are bound to a data object
+     *  @var    std::vector
+     */
+    std::vector<uint64_t> _hashes;
+
+public:
+    /**
+     *  Value that is returned by find() for unknown names
+     *  @var    size_t
+     */
+    static constexpr size_t npos = size_t(-1);
+
+    /**
+     *  Constructor
+     */
+    Slots() {}
+
+    /**
+     *  Constructor based on a nullptr terminated array of names, this is
+     *  the format in which the names are stored in a compiled template
+     *  @param  names       the names
+     */
+    Slots(const char * const *names)
+    {
+        // add all names
+        while (*names) add(*names++);
+    }
+
+    /**
+     *  Destructor
+     */
+    virtual ~Slots() {}
+
+    /**
+     *  Get the slot index for a name, a new slot is added if the name was
+     *  not yet known
+     *  @param  name        name of the variable
+     *  @return size_t
+     */
+    size_t add(const std::string &name)
+    {
+        // try to add the name with the next index
+        auto result = _indices.emplace(name, _names.size());
+
+        // if the name is new we should remember it (and its hash)
+        if (result.second)
+        {
+            _names.push_back(name);
+            _hashes.push_back(nameHash(name.data(), name.size()));
+        }
+
+        // return the index
+        return result.first->second;
+    }
+
+    /**
+     *  Find the slot index of a name
+     *  @param  name        name of the variable
+     *  @param  size        size of the name
+     *  @return size_t      the index, or npos if the name is not used
+     */
+    size_t find(const char *name, size_t size) const
+    {
+        // look up the name
+        auto iter = _indices.find(std::string(name, size));
+
+        // check if it was found
+        return iter == _indices.end() ? npos : iter->second;
+    }
+
+    /**
+     *  All names, ordered by slot index
+     *  @return std::vector
+     */
+    const std::vector<std::string> &names() const
+    {
+        return _names;
+    }
+
+    /**
+     *  Hashes of all names, ordered by slot index
+     *  @return std::vector
+     */
+    const std::vector<uint64_t> &hashes() const
+    {
+        return _hashes;
+    }
+
+    /**
+     *  Name of a slot
+     *  @param  index       the slot index
+     *  @return std::string
+     */
+    const std::string &name(size_t index) const
+    {
+        return _names[index];
+    }
+
+    /**
+     *  Number of slots
+     *  @return size_t
+     */
+    size_t size() const
+    {
+        return _names.size();
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}}
@@ -52,6 +52,28 @@ public:
     {
         generator->assign(*_var, _expression.get());
     }
+
+    /**
+     *  Optimize the statement before code is generated for it
+     *  @return Statements
+     */
+    Statements *optimize() override
+    {
+        // optimize the expression that is assigned
+        Expression::optimize(_expression);
+
+        // the statement stays
+        return nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that are assigned by the statement
+     *  @param  names
+     */
+    void bound(std::set<std::string> &names) const override
+    {
+        names.insert(*_var);
+    }
 };
 
 /**
@@ -0,0 +1,69 @@
+/**
+ *  CachedOutput.h
+ *
+ *  Statement to echo the output of a variable (or filter) inside a loop, when
+ *  the output is the same on every iteration. The output is only generated
+ *  (and escaped) on the first iteration, after which it is written from a
+ *  cache slot.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class CachedOutputStatement : public Statement
+{
+private:
+    /**
+     *  The variable that is written
+     *  @var    Variable
+     */
+    std::unique_ptr<Variable> _variable;
+
+    /**
+     *  The cache slot
+     *  @var    size_t
+     */
+    size_t _slot;
+
+    /**
+     *  Should the output be escaped?
+     *  @var    bool
+     */
+    bool _escape;
+
+public:
+    /**
+     *  Constructor
+     *  @param  variable        the variable to output
+     *  @param  slot            the cache slot
+     *  @param  escape          should the output be escaped?
+     */
+    CachedOutputStatement(Variable *variable, size_t slot, bool escape) :
+        _variable(variable), _slot(slot), _escape(escape) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~CachedOutputStatement() {}
+
+    /**
+     *  Generate the output of this statement
+     *  @param  generator
+     */
+    void generate(Generator *generator) const override
+    {
+        generator->cachedOutput(_slot, _variable.get(), _escape);
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}}
@@ -44,6 +44,64 @@ public:
     {
         _expression->output(generator);
     }
+
+    /**
+     *  Optimize the statement before code is generated for it
+     *  @return Statements
+     */
+    Statements *optimize() override
+    {
+        // optimize the expression
+        Expression::optimize(_expression);
+
+        // if it did not become a literal, we still have to output it at runtime
+        auto *literal = dynamic_cast<Literal*>(_expression.get());
+        if (literal == nullptr) return nullptr;
+
+        // the literal is turned into raw output, formatted in the same way as at runtime
+        switch (literal->type()) {
+        case Expression::Type::Integer: return new Statements(new RawStatement(new Token(Number::toString(literal->integerValue()))));
+        case Expression::Type::Double:  return new Statements(new RawStatement(new Token(Number::toString(literal->doubleValue()))));
+        case Expression::Type::Boolean: return new Statements(new RawStatement(new Token(literal->booleanValue() ? "true" : "false")));
+        default:                        return new Statements(new RawStatement(new Token(literal->stringValue())));
+        }
+    }
+
+    /**
+     *  Move work out of the loops
+     *  @param  loop
+     *  @param  slots
+     *  @return Statement
+     */
+    Statement *hoist(Loop *loop, size_t &slots) override
+    {
+        // outside loops there is nothing to win
+        if (loop == nullptr) return nullptr;
+
+        // only variables (and filters) are written as they are
+        auto *variable = dynamic_cast<Variable*>(_expression.get());
+        if (variable == nullptr) return nullptr;
+
+        // find out what the output depends on, if there is more than one variable, we leave it alone
+        std::set<std::string> names;
+        if (!variable->variables(names) || names.size() > 1) return nullptr;
+
+        // find the outermost loop in which these variables do not change
+        auto *owner = loop->owner(names);
+        if (owner == nullptr) return nullptr;
+
+        // filters may turn off the escaping
+        auto *filter = dynamic_cast<Filter*>(variable);
+        bool escape = filter ? filter->escape() : true;
+
+        // the loop resets the cache before it starts
+        size_t slot = slots++;
+        owner->add(slot, names.empty() ? std::string() : *names.begin());
+
+        // the variable is moved to the replacement
+        _expression.release();
+        return new CachedOutputStatement(variable, slot, escape);
+    }
 };
 
 /**
@@ -49,6 +49,13 @@ private:
      */
     std::unique_ptr<Statements> _else_statements;
 
+    /**
+     *  The cache slots that are reset before the loop starts, together with
+     *  the variable that the cached output depends on (may be a nullptr)
+     *  @var std::vector
+     */
+    std::vector<std::pair<size_t,std::unique_ptr<Variable>>> _caches;
+
 public:
     /**
      *  Constructor
@@ -82,12 +89,85 @@ public:
      */
     void generate(Generator *generator) const override
     {
+        // forget the output that was cached during a previous run of the loop
+        for (auto &cache : _caches) generator->cacheReset(cache.first, cache.second.get());
+
         // if there is no key, we pass an empty string
         if (_key == nullptr) generator->foreach(_source.get(), std::string(""), *_value, _statements.get(), _else_statements.get());
     
         // otherwise we call the generator with a reference to the key
         else generator->foreach(_source.get(), *_key, *_value, _statements.get(), _else_statements.get());
     }
+
+    /**
+     *  Optimize the statement before code is generated for it
+     *  @return Statements
+     */
+    Statements *optimize() override
+    {
+        // optimize the variable to loop over (it is never replaced)
+        _source->optimize();
+
+        // optimize the nested statements
+        if (_statements) _statements->optimize();
+        if (_else_statements) _else_statements->optimize();
+
+        // the loop stays
+        return nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that are assigned by the statement
+     *  @param  names
+     */
+    void bound(std::set<std::string> &names) const override
+    {
+        // the loop assigns the key and the value
+        if (_key) names.insert(*_key);
+        names.insert(*_value);
+
+        // and so might the nested statements
+        if (_statements) _statements->bound(names);
+        if (_else_statements) _else_statements->bound(names);
+    }
+
+    /**
+     *  Move work out of the loops
+     *  @param  parent
+     *  @param  slots
+     *  @return Statement
+     */
+    Statement *hoist(Loop *parent, size_t &slots) override
+    {
+        // the else statements do not run inside this loop
+        if (_else_statements) _else_statements->hoist(parent, slots);
+
+        // nothing to do for an empty loop
+        if (!_statements) return nullptr;
+
+        // the variables that change on every iteration
+        std::set<std::string> names;
+        if (_key) names.insert(*_key);
+        names.insert(*_value);
+        _statements->bound(names);
+
+        // move the work out of the statements in the loop
+        Loop loop(parent, std::move(names));
+        _statements->hoist(&loop, slots);
+
+        // remember the caches that we should reset
+        for (auto &cache : loop.caches())
+        {
+            // the variable the output depends on
+            auto *root = cache.second.empty() ? nullptr : new LiteralVariable(new Token(cache.second));
+
+            // add the cache
+            _caches.emplace_back(cache.first, std::unique_ptr<Variable>(root));
+        }
+
+        // the loop stays
+        return nullptr;
+    }
 };
 
 /**
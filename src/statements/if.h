@@ -68,6 +68,55 @@ public:
         // generate a condition statement
         generator->condition(_expression.get(), _trueStatements.get(), _falseStatements.get());
     }
+
+    /**
+     *  Optimize the statement before code is generated for it
+     *  @return Statements
+     */
+    Statements *optimize() override
+    {
+        // optimize the condition and the nested statements
+        Expression::optimize(_expression);
+        if (_trueStatements) _trueStatements->optimize();
+        if (_falseStatements) _falseStatements->optimize();
+
+        // if the condition is not constant, it has to be checked at runtime
+        auto *literal = dynamic_cast<Literal*>(_expression.get());
+        if (literal == nullptr) return nullptr;
+
+        // the branch that is taken replaces the entire statement
+        auto *branch = literal->booleanValue() ? _trueStatements.release() : _falseStatements.release();
+
+        // if there is no such branch, the statement is simply removed
+        return branch ? branch : new Statements();
+    }
+
+    /**
+     *  Collect the names of the variables that are assigned by the statement
+     *  @param  names
+     */
+    void bound(std::set<std::string> &names) const override
+    {
+        // check both branches
+        if (_trueStatements) _trueStatements->bound(names);
+        if (_falseStatements) _falseStatements->bound(names);
+    }
+
+    /**
+     *  Move work out of the loops
+     *  @param  loop
+     *  @param  slots
+     *  @return Statement
+     */
+    Statement *hoist(Loop *loop, size_t &slots) override
+    {
+        // the branches are inside the same loop as we are
+        if (_trueStatements) _trueStatements->hoist(loop, slots);
+        if (_falseStatements) _falseStatements->hoist(loop, slots);
+
+        // the statement stays
+        return nullptr;
+    }
 };
 
 /**
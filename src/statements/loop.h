@@ -0,0 +1,110 @@
+/**
+ *  Loop.h
+ *
+ *  Helper class that is used while the statements inside a foreach loop are
+ *  inspected for output that is the same on every iteration. Such output is
+ *  generated once, and remembered in a cache slot that is reset right before
+ *  the loop starts.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class Loop
+{
+private:
+    /**
+     *  The loop that we are nested in
+     *  @var Loop
+     */
+    Loop *_parent;
+
+    /**
+     *  Names of the variables that get a new value inside the loop
+     *  @var std::set
+     */
+    std::set<std::string> _bound;
+
+    /**
+     *  The cache slots that are reset before the loop starts, together with
+     *  the name of the variable that the cached output depends on
+     *  @var std::vector
+     */
+    std::vector<std::pair<size_t,std::string>> _caches;
+
+    /**
+     *  Is one of the variables assigned inside the loop?
+     *  @param  names
+     *  @return bool
+     */
+    bool binds(const std::set<std::string> &names) const
+    {
+        // check all names
+        for (const auto &name : names) if (_bound.count(name)) return true;
+
+        // none of them is assigned
+        return false;
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  parent      the loop that we are nested in (or nullptr)
+     *  @param  bound       names of the variables that are assigned in the loop
+     */
+    Loop(Loop *parent, std::set<std::string> &&bound) : _parent(parent), _bound(std::move(bound)) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~Loop() = default;
+
+    /**
+     *  Find the outermost loop during which the variables keep the same value,
+     *  output that only depends on these variables can be cached in that loop
+     *  @param  names       names of the variables
+     *  @return Loop        the loop, or nullptr if the variables change in this loop
+     */
+    Loop *owner(const std::set<std::string> &names)
+    {
+        // the loop that we found so far
+        Loop *result = nullptr;
+
+        // move outwards until we find a loop that assigns one of the variables
+        for (Loop *loop = this; loop != nullptr && !loop->binds(names); loop = loop->_parent) result = loop;
+
+        // expose the result
+        return result;
+    }
+
+    /**
+     *  Add a cache slot that should be reset before the loop starts
+     *  @param  slot        the cache slot
+     *  @param  name        the variable that the output depends on (empty if there is none)
+     */
+    void add(size_t slot, const std::string &name)
+    {
+        _caches.emplace_back(slot, name);
+    }
+
+    /**
+     *  The cache slots that should be reset
+     *  @return std::vector
+     */
+    const std::vector<std::pair<size_t,std::string>> &caches() const
+    {
+        return _caches;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
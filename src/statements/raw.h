@@ -46,6 +46,22 @@ public:
         // add write instruction of raw data
         generator->raw(*_data);
     }
+
+    /**
+     *  Merge the statement that comes right after this one into this statement
+     *  @param  next
+     *  @return bool
+     */
+    bool merge(const Statement &next) override
+    {
+        // only raw data can be appended to raw data
+        auto *raw = dynamic_cast<const RawStatement*>(&next);
+        if (raw == nullptr) return false;
+
+        // append the data, so that it is written in one go
+        _data->append(*raw->_data);
+        return true;
+    }
 };
 
 /**
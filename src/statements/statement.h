@@ -43,6 +43,45 @@ public:
      */
     virtual void generate(Generator *generator) const = 0;
 
+    /**
+     *  Optimize the statement before code is generated for it
+     *
+     *  Statements that can be simplified at compile time (like an if statement
+     *  with a constant condition) return the statements that should replace
+     *  them (this list may be empty). Other statements return a nullptr, but
+     *  they may still have optimized their expressions and nested statements.
+     *
+     *  @return Statements      the replacement, or nullptr to keep this statement
+     */
+    virtual Statements *optimize() { return nullptr; }
+
+    /**
+     *  Merge the statement that comes right after this one into this statement
+     *  @param  next            the next statement
+     *  @return bool            true if it was merged (and can be removed)
+     */
+    virtual bool merge(const Statement &next) { return false; }
+
+    /**
+     *  Collect the names of the variables that are assigned by the statement
+     *  (or by one of its nested statements)
+     *  @param  names           set that is filled with the names
+     */
+    virtual void bound(std::set<std::string> &names) const {}
+
+    /**
+     *  Move work out of the loops
+     *
+     *  Output that gives the same result on every iteration of a loop is
+     *  replaced by a statement that only generates it once. The loop that
+     *  the output is invariant for gets a cache slot, that it resets before
+     *  it starts.
+     *
+     *  @param  loop            the innermost loop that we are in (or nullptr)
+     *  @param  slots           counter for assigning cache slots
+     *  @return Statement       the replacement, or nullptr to keep this statement
+     */
+    virtual Statement *hoist(Loop *loop, size_t &slots) { return nullptr; }
 };
 
 /**
@@ -28,7 +28,7 @@ public:
     /**
      *  Constructor
      */
-    Statements();
+    Statements() {}
 
     /**
      *  Constructor with already the first statement
@@ -59,6 +59,72 @@ public:
         // loop through the statements, and output each one of them
         for (auto &statement : _statements) statement->generate(generator);
     }
+
+    /**
+     *  Optimize the statements before code is generated for them
+     *  @return Statements
+     */
+    Statements *optimize() override
+    {
+        // optimize the statements one by one
+        for (auto iter = _statements.begin(); iter != _statements.end(); )
+        {
+            // ask the statement for a replacement
+            std::unique_ptr<Statements> replacement((*iter)->optimize());
+
+            // keep the statement if there is none
+            if (!replacement) { ++iter; continue; }
+
+            // move the replacement in front of the statement, and remove the statement
+            _statements.splice(iter, replacement->_statements);
+            iter = _statements.erase(iter);
+        }
+
+        // merge statements that can be combined (like raw statements that are now adjacent)
+        for (auto iter = _statements.begin(); iter != _statements.end(); )
+        {
+            // the statement after this one
+            auto next = std::next(iter);
+            if (next == _statements.end()) break;
+
+            // remove the next statement if it was merged, otherwise move on
+            if ((*iter)->merge(**next)) _statements.erase(next);
+            else iter = next;
+        }
+
+        // the list itself stays
+        return nullptr;
+    }
+
+    /**
+     *  Collect the names of the variables that are assigned by the statements
+     *  @param  names
+     */
+    void bound(std::set<std::string> &names) const override
+    {
+        // check all statements
+        for (auto &statement : _statements) statement->bound(names);
+    }
+
+    /**
+     *  Move work out of the loops
+     *  @param  loop
+     *  @param  slots
+     *  @return Statement
+     */
+    Statement *hoist(Loop *loop, size_t &slots) override
+    {
+        // replace the statements that have a replacement
+        for (auto &statement : _statements)
+        {
+            // ask for a replacement
+            auto *replacement = statement->hoist(loop, slots);
+            if (replacement) statement.reset(replacement);
+        }
+
+        // the list itself stays
+        return nullptr;
+    }
 };
 
 /**
@@ -39,10 +39,7 @@ public:
             v1::Tokenizer tokenizer;
             
             // pass the buffer to the tokenizer, it will pass all tokens to this syntaxtree object
-            if (tokenizer.process(this, buffer, size)) return;
-            
-            // report the error
-            throw CompileError(_error, tokenizer.getCurrentLine());
+            if (!tokenizer.process(this, buffer, size)) throw CompileError(_error, tokenizer.getCurrentLine());
         }
         else
         {
@@ -50,11 +47,16 @@ public:
             v2::Tokenizer tokenizer;
             
             // pass the buffer to the tokenizer, it will pass all tokens to this syntaxtree object
-            if (tokenizer.process(this, buffer, size)) return;
-
-            // report the error
-            throw CompileError(_error, tokenizer.getCurrentLine());
+            if (!tokenizer.process(this, buffer, size)) throw CompileError(_error, tokenizer.getCurrentLine());
         }
+
+        // fold constant expressions and remove branches that are never taken, so
+        // that both the jit compiler and the c code generator get a simpler tree
+        if (_statements) _statements->optimize();
+
+        // output inside loops that does not change between the iterations is only generated once
+        size_t slots = 0;
+        if (_statements) _statements->hoist(nullptr, slots);
     }
 
     /**
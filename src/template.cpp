@@ -17,18 +17,32 @@ namespace SmartTpl {
  *  Constructor
  *  @param  source        Source of the template to load
  */
-Template::Template(const Source &source)
+Template::Template(const Source &source) : Template(source, std::string()) {}
+
+/**
+ *  Constructor that uses a directory with compiled templates
+ *  @param  source        Source of the template to load
+ *  @param  directory     Directory with compiled templates
+ */
+Template::Template(const Source &source, const std::string &directory)
 {
     // is the source a shared library?
     if (source.library())
     {
         // hey that's cool, we can create create a shard library
-        _executor = new Internal::Library(source.name());
+        _executor = std::make_shared<Internal::Library>(source.name());
     }
     else
     {
-        // it was not a shared library, we're going to compile it into bytecode ourselves
-        _executor = new Internal::Bytecode(source);
+        // try to use a library from the directory with compiled templates
+        if (!directory.empty()) _executor = Internal::LibraryCache(directory).load(source);
+
+        // libjit can not generate native code on every platform, its own interpreter
+        // is much slower than ours, so in that case we interpret the template ourselves
+        if (!_executor && jit_uses_interpreter()) _executor = std::make_shared<Internal::Interpreter>(source);
+
+        // otherwise we're going to compile it into bytecode ourselves
+        if (!_executor) _executor = std::make_shared<Internal::Bytecode>(source);
     }
 
     // Set the _encoding using the encoding() method on our executor
@@ -36,14 +50,39 @@ Template::Template(const Source &source)
 }
 
 /**
- *  Destructor
+ *  Constructor for a template that is compiled when it turns out to be used a lot
+ *  @param  source        Source of the template to load
+ *  @param  threshold     Number of times that the template is processed before it is compiled
+ *  @param  directory     Directory with compiled templates
  */
-Template::~Template()
+Template::Template(const Source &source, size_t threshold, const std::string &directory)
 {
-    // we no longer need the executor
-    delete _executor;
+    // a shared library is already compiled
+    if (source.library()) _executor = std::make_shared<Internal::Library>(source.name());
+
+    // templates that are never compiled only need the interpreter
+    else if (threshold == never) _executor = std::make_shared<Internal::Interpreter>(source);
+
+    // other templates start in the interpreter
+    else _executor = std::make_shared<Internal::Tiered>(source, threshold, directory);
+
+    // Set the _encoding using the encoding() method on our executor
+    _encoding = _executor->encoding();
 }
 
+/**
+ *  Constructor for a template that uses an executor that already exists
+ *  @param  executor      The shared executor
+ */
+Template::Template(const std::shared_ptr<Internal::Executor> &executor) :
+    _executor(executor),
+    _encoding(executor->encoding()) {}
+
+/**
+ *  Destructor
+ */
+Template::~Template() {}
+
 /**
  *  Is this template dependent on data to be personalised?
  *
@@ -79,6 +118,9 @@ std::string Template::compile() const
  */
 std::string Template::process(const Data &data, const std::string &outencoding) const
 {
+    // the output of templates without personalisation is always the same
+    if (_executor->constant()) return *_executor->rendered(outencoding);
+
     // we need a handler object
     Internal::Handler handler(&data, Internal::Escaper::get(outencoding));
 
@@ -88,8 +130,147 @@ std::string Template::process(const Data &data, const std::string &outencoding)
     // In case our handler is set in failed mode we have to throw a runtime error
     if (handler.failed()) throw RunTimeError(handler.error());
 
-    // return the generated output string
-    return handler.output();
+    // the handler is about to be destructed, so we can move the output out of it
+    return std::move(handler.output());
+}
+
+/**
+ *  Process the template, reusing the buffers of a render context
+ *
+ *  @param  context      Context that is reused between calls
+ *  @param  data         Data source
+ *  @param  outencoding  The encoding that should be used for the output
+ *  @return std::string
+ */
+const std::string &Template::process(RenderContext &context, const Data &data, const std::string &outencoding) const
+{
+    // the handler is owned by the context
+    auto *handler = context._handler;
+
+    // clear the state of the previous call
+    handler->reset(&data, Internal::Escaper::get(outencoding));
+
+    // templates without personalisation only have to be processed once
+    if (_executor->constant())
+    {
+        // copy the shared output into the context
+        auto output = _executor->rendered(outencoding);
+        handler->write(output->data(), output->size());
+    }
+    else
+    {
+        // ask the executor to display the template
+        _executor->process(*handler);
+    }
+
+    // we no longer need the values that were created during processing,
+    // but the output remains available in the context
+    handler->cleanup();
+
+    // In case our handler is set in failed mode we have to throw a runtime error
+    if (handler->failed()) throw RunTimeError(handler->error());
+
+    // expose the generated output
+    return handler->output();
+}
+
+/**
+ *  Process the template, and collect the output as a list of segments
+ *  @param  segments     Object that receives the segments
+ *  @param  data         Data source
+ *  @param  outencoding  The encoding that should be used for the output
+ *  @return Segments
+ */
+const Segments &Template::process(Segments &segments, const Data &data, const std::string &outencoding) const
+{
+    // the handler is owned by the segments object
+    auto *handler = segments._handler;
+
+    // clear the state of the previous call, and refer to the static text instead of copying it
+    handler->reset(&data, Internal::Escaper::get(outencoding), true);
+
+    // templates without personalisation only have to be processed once
+    if (_executor->constant())
+    {
+        // refer to the shared output (it lives as long as the executor)
+        auto output = _executor->rendered(outencoding);
+        handler->write(output->data(), output->size());
+    }
+    else
+    {
+        // ask the executor to display the template
+        _executor->process(*handler);
+    }
+
+    // we no longer need the values that were created during processing
+    handler->cleanup();
+
+    // collect the segments (so that the segments of a previous call are gone, even on failure)
+    segments.collect();
+
+    // In case our handler is set in failed mode we have to throw a runtime error
+    if (handler->failed()) throw RunTimeError(handler->error());
+
+    // expose the segments
+    return segments;
+}
+
+/**
+ *  Process the template, and stream the output to a sink
+ *
+ *  @param  data         Data source
+ *  @param  sink         The sink that receives the output
+ *  @param  outencoding  The encoding that should be used for the output
+ */
+void Template::process(const Data &data, Sink &sink, const std::string &outencoding) const
+{
+    // templates without personalisation only have to be processed once
+    if (_executor->constant())
+    {
+        // the shared output
+        auto output = _executor->rendered(outencoding);
+
+        // prevent exceptions, errors are reported just like when the template is processed
+        try
+        {
+            // pass the output to the sink in one go
+            sink.write(output->data(), output->size());
+        }
+        catch (const std::exception &exception)
+        {
+            // report the error
+            throw RunTimeError(exception.what());
+        }
+
+        // done
+        return;
+    }
+
+    // we need a handler object that flushes to the sink
+    Internal::Handler handler(&data, Internal::Escaper::get(outencoding), &sink);
+
+    // ask the executor to display the template
+    _executor->process(handler);
+
+    // pass the remaining output to the sink
+    handler.flush();
+
+    // In case our handler is set in failed mode we have to throw a runtime error
+    if (handler.failed()) throw RunTimeError(handler.error());
+}
+
+/**
+ *  The output of a template that does not use personalisation data
+ *  @param  outencoding  The encoding that should be used for the output
+ *  @return std::shared_ptr
+ */
+std::shared_ptr<const std::string> Template::output(const std::string &outencoding) const
+{
+    // personalised templates have to be processed every time
+    if (!_executor->constant()) return nullptr;
+
+    // get the shared output
+    return _executor->rendered(outencoding);
 }
 
 /**
@@ -0,0 +1,186 @@
+/**
+ *  TemplateCache.cpp
+ *
+ *  Implementation of the TemplateCache class
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl {
+
+/**
+ *  Constructor
+ *  @param  budget      memory budget of the cache, in bytes
+ */
+TemplateCache::TemplateCache(size_t budget) : _cache(new Internal::ExecutorCache(budget)) {}
+
+/**
+ *  Destructor
+ */
+TemplateCache::~TemplateCache()
+{
+    // we no longer need the cache
+    delete _cache;
+}
+
+/**
+ *  The cache that is shared by the entire process
+ *  @return TemplateCache
+ */
+TemplateCache &TemplateCache::instance()
+{
+    // constructed on first use
+    static TemplateCache cache;
+
+    // expose it
+    return cache;
+}
+
+/**
+ *  Get a template from a source
+ *  @param  source      the template source
+ *  @return Template
+ */
+Template TemplateCache::get(const Source &source)
+{
+    // shared libraries are not read, so they can only be found by filename
+    if (source.library()) return get(source.name(), source.version());
+
+    // the key of the template
+    Internal::ExecutorCache::Key key{ Internal::nameHash(source.data(), source.size()), source.version() };
+
+    // the directory with compiled templates
+    std::string directory;
+
+    {
+        // look it up
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto executor = _cache->find(key, source.data(), source.size());
+        if (executor) return Template(executor);
+
+        // we need to compile it, remember the directory to use
+        directory = _directory;
+    }
+
+    // compile the template, we do this without holding the lock, so that
+    // other threads can still get their templates in the meantime
+    Template result(source, directory);
+
+    // store it (if another thread was faster, we use their executor)
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Template(_cache->store(key, std::string(source.data(), source.size()), result._executor));
+}
+
+/**
+ *  Get a template from a file
+ *  @param  filename    name of the file
+ *  @param  version     the tokenizer version
+ *  @return Template
+ */
+Template TemplateCache::get(const std::string &filename, size_t version)
+{
+    // find out the current state of the file
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) throw std::runtime_error(strerror(errno));
+
+    // the modification time and size tell us whether the file was changed
+    Internal::ExecutorCache::Stamp stamp{ (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec, (int64_t)info.st_size };
+
+    {
+        // look up the file
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto executor = _cache->find(filename, version, stamp);
+        if (executor) return Template(executor);
+    }
+
+    // load the file (this reads it, unless it is a shared library)
+    SmartTpl::File file(filename, version);
+
+    // shared libraries are loaded, and remembered by filename only
+    if (file.library())
+    {
+        // load the library
+        Template result(file);
+
+        // store it
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache->store(filename, version, stamp, result._executor);
+        return result;
+    }
+
+    // get the template by its content (another file may have the same content)
+    Template result(get(file));
+
+    // remember the file
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cache->link(filename, version, stamp, Internal::ExecutorCache::Key{ Internal::nameHash(file.data(), file.size()), version }, result._executor);
+    return result;
+}
+
+/**
+ *  Use a directory to store the compiled templates in
+ *  @param  directory
+ */
+void TemplateCache::directory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _directory = directory;
+}
+
+/**
+ *  Change the memory budget
+ *  @param  bytes
+ */
+void TemplateCache::budget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cache->budget(bytes);
+}
+
+/**
+ *  The memory budget
+ *  @return size_t
+ */
+size_t TemplateCache::budget() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cache->budget();
+}
+
+/**
+ *  The estimated memory that is used by the compiled templates
+ *  @return size_t
+ */
+size_t TemplateCache::used() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cache->used();
+}
+
+/**
+ *  Number of compiled templates in the cache
+ *  @return size_t
+ */
+size_t TemplateCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cache->size();
+}
+
+/**
+ *  Remove all templates from the cache
+ */
+void TemplateCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cache->clear();
+}
+
+/**
+ *  End namespace
+ */
+}
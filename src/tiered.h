@@ -0,0 +1,255 @@
+/**
+ *  Tiered.h
+ *
+ *  Executor that starts running a template with the interpreter, which
+ *  hardly takes any time to set up, and that switches to faster executors
+ *  when the template turns out to be used a lot:
+ *
+ *  -   tier 0: the interpreter, that is used for the first renders
+ *  -   tier 1: the jit compiled bytecode, after a number of renders
+ *  -   tier 2: a shared library that is compiled in the background (only
+ *              when a directory for the compiled templates was given)
+ *
+ *  The compilers run in a background thread, and the executor that is in
+ *  use is replaced atomically. Renders that are busy keep a reference to the
+ *  executor that they started with, so the promotion does not wait for them,
+ *  and they do not wait for the promotion. The executors that are replaced
+ *  are kept until the template is destructed, because the segments that
+ *  they generated point into them. The template does not wait for the
+ *  compiler either when it is destructed: the compiler thread keeps the data
+ *  that it needs alive, and it skips the shared library.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Class definition
+ */
+class Tiered : public Executor
+{
+private:
+    /**
+     *  The data that is shared with the thread that compiles the template,
+     *  this thread keeps it alive, so that the template does not have to wait
+     *  for the compiler when it is destructed
+     */
+    struct State
+    {
+        /**
+         *  Copy of the template source, that is needed to compile it later
+         *  @var    Buffer
+         */
+        Buffer source;
+
+        /**
+         *  Directory for the shared libraries (empty when there is no tier 2)
+         *  @var    std::string
+         */
+        std::string directory;
+
+        /**
+         *  The executor that is currently in use, this is only accessed with
+         *  std::atomic_load() and std::atomic_exchange()
+         *  @var    std::shared_ptr
+         */
+        std::shared_ptr<Executor> executor;
+
+        /**
+         *  The executors that were replaced, and the mutex that protects them
+         *  @var    std::vector
+         *  @var    std::mutex
+         */
+        std::vector<std::shared_ptr<Executor>> retired;
+        std::mutex mutex;
+
+        /**
+         *  Is the template destructed? The compiler then stops as soon as it can
+         *  @var    std::atomic
+         */
+        std::atomic<bool> destructed;
+
+        /**
+         *  Constructor
+         *  @param  source      the template source
+         *  @param  directory   directory for shared libraries
+         *  @throws CompileError
+         */
+        State(const Source &source, const std::string &directory) :
+            source(source.data(), source.size(), source.version()),
+            directory(directory),
+            executor(std::make_shared<Interpreter>(source)),
+            destructed(false) {}
+
+        /**
+         *  Replace the executor that is in use
+         *  @param  replacement the new executor
+         */
+        void replace(const std::shared_ptr<Executor> &replacement)
+        {
+            // lock the list of retired executors
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // swap in the new executor, and keep the old one alive
+            retired.push_back(std::atomic_exchange(&executor, replacement));
+        }
+    };
+
+    /**
+     *  The shared data
+     *  @var    std::shared_ptr
+     */
+    std::shared_ptr<State> _state;
+
+    /**
+     *  Number of renders after which the template is compiled
+     *  @var    size_t
+     */
+    size_t _threshold;
+
+    /**
+     *  The number of renders so far
+     *  @var    std::atomic
+     */
+    std::atomic<size_t> _renders;
+
+    /**
+     *  Properties of the template
+     *  @var    std::string
+     *  @var    bool
+     */
+    std::string _encoding;
+    bool _personalized;
+    bool _constant;
+
+    /**
+     *  Promote the template to the next tiers
+     */
+    void promote()
+    {
+        // the template is compiled in the background, so that the render that
+        // reaches the threshold does not have to wait for the compiler either,
+        // the thread is detached and only holds on to the shared data
+        auto state = _state;
+        std::thread([state]() {
+
+            // prevent exceptions, because there is nobody to catch them in this thread
+            // (if the template can not be compiled we just keep interpreting it)
+            if (!jit_uses_interpreter() && !state->destructed) try
+            {
+                // compile the template with libjit (unless libjit itself is an interpreter
+                // on this platform, because then the bytecode is slower than our interpreter)
+                state->replace(std::make_shared<Bytecode>(state->source));
+            }
+            catch (const std::exception &error) {}
+
+            // without a directory there is no shared library, and there is no
+            // need to start the c compiler if the template is no longer used
+            if (state->directory.empty() || state->destructed) return;
+
+            // prevent exceptions here too
+            try
+            {
+                // get the library (this loads it if it was compiled before)
+                auto library = LibraryCache(state->directory).load(state->source);
+
+                // swap it in
+                if (library) state->replace(library);
+            }
+            catch (const std::exception &error) {}
+        }).detach();
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  source      the template source
+     *  @param  threshold   number of renders after which the template is compiled
+     *  @param  directory   directory for shared libraries (an empty string for no shared libraries)
+     *  @throws CompileError
+     */
+    Tiered(const Source &source, size_t threshold, const std::string &directory) :
+        _state(std::make_shared<State>(source, directory)),
+        _threshold(threshold),
+        _renders(0),
+        _encoding(_state->executor->encoding()),
+        _personalized(_state->executor->personalized()),
+        _constant(_state->executor->constant())
+    {
+        // without a threshold the template is compiled right away
+        if (_threshold == 0) promote();
+    }
+
+    /**
+     *  Destructor
+     */
+    virtual ~Tiered()
+    {
+        // we do not wait for the compiler, but tell it that it can stop
+        _state->destructed = true;
+    }
+
+    /**
+     *  Execute the template given a certain handler
+     *  @param  handler
+     */
+    void process(Handler &handler) override
+    {
+        // the render that reaches the threshold promotes the template (exactly
+        // one render does this, and it only starts the compiler in the background)
+        if (++_renders == _threshold) promote();
+
+        // use the executor that is in use right now, this reference keeps
+        // it alive even when it is replaced while we're busy
+        auto executor = std::atomic_load(&_state->executor);
+
+        // run it
+        executor->process(handler);
+    }
+
+    /**
+     *  Does the template use personalisation data?
+     *  @return bool
+     */
+    bool personalized() const override
+    {
+        return _personalized;
+    }
+
+    /**
+     *  Is the output of the template always the same?
+     *  @return bool
+     */
+    bool constant() const override
+    {
+        return _constant;
+    }
+
+    /**
+     *  Compile the template into C code
+     *  @return std::string
+     */
+    std::string compile() override
+    {
+        // the shared library can not be turned into C code, so we use the source
+        return CCode(_state->source).asString();
+    }
+
+    /**
+     *  Retrieve what encoding the 'template' has natively
+     *  @return std::string
+     */
+    std::string encoding() override
+    {
+        return _encoding;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}}
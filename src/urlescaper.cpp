@@ -0,0 +1,75 @@
+/**
+ *  UrlEscaper.cpp
+ *
+ *  Implementation of the scanner that finds the characters that have to be
+ *  encoded in an url. Only letters, digits and the '_', '.' and '-'
+ *  characters can be copied as they are, we look them up in a table.
+ *
+ *  @copyright 2019 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Namespace
+ */
+namespace SmartTpl { namespace Internal {
+
+/**
+ *  Table with the characters that can be copied without encoding them
+ */
+static const struct SafeTable
+{
+    /**
+     *  The table itself, indexed by the (unsigned) character
+     */
+    bool safe[256] = {};
+
+    /**
+     *  Constructor
+     */
+    SafeTable()
+    {
+        // letters and digits
+        for (int c = 'a'; c <= 'z'; ++c) safe[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c) safe[c] = true;
+        for (int c = '0'; c <= '9'; ++c) safe[c] = true;
+
+        // and a couple of other characters
+        for (unsigned char c : { '_', '.', '-' }) safe[c] = true;
+    }
+} table;
+
+/**
+ *  Find the first character in a buffer that has to be encoded
+ *  @param  data        the buffer
+ *  @param  size        size of the buffer
+ *  @return size_t      position of the character, or size if there is none
+ */
+size_t UrlEscaper::scan(const char *data, size_t size)
+{
+    // the characters as unsigned values, so that they can be used as index
+    auto *bytes = (const unsigned char *)data;
+
+    // check four characters per iteration
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        // check if all four are safe
+        if (table.safe[bytes[i]] & table.safe[bytes[i+1]] & table.safe[bytes[i+2]] & table.safe[bytes[i+3]]) continue;
+
+        // one of them is not
+        while (table.safe[bytes[i]]) ++i;
+        return i;
+    }
+
+    // the tail
+    for (; i < size; ++i) if (!table.safe[bytes[i]]) return i;
+
+    // nothing found
+    return size;
+}
+
+/**
+ *  End namespace
+ */
+}}
@@ -13,43 +13,254 @@
  */
 namespace SmartTpl {
 
+/**
+ *  Store a string, short strings are stored inline
+ *  @param  value       the string to store
+ *  @param  size        size of the string
+ */
+void VariantValue::store(const char *value, size_t size)
+{
+    // long strings need a regular string value
+    if (size > InlineSize) return (void)(*this = std::make_shared<StringValue>(value, size));
+
+    // copy the string in our own buffer
+    _value.reset();
+    _type = Type::String;
+    _size = size;
+    memcpy(_string, value, size);
+}
+
+/**
+ *  Store a string, short strings are stored inline
+ *  @param  value       the string to store
+ */
+void VariantValue::store(std::string &&value)
+{
+    // long strings are moved into a regular string value
+    if (value.size() > InlineSize) *this = std::make_shared<StringValue>(std::move(value));
+
+    // short strings are copied into our own buffer
+    else store(value.data(), value.size());
+}
+
+/**
+ *  Call a function with the stored value as Value object
+ *  @param  callback    the function to call
+ *  @return mixed       return value of the callback
+ */
+template <typename Result, typename Callback>
+Result VariantValue::visit(Callback &&callback) const
+{
+    // check the type
+    switch (_type) {
+    case Type::Null:        return callback(NullValue());
+    case Type::Boolean:     return callback(BoolValue(_boolean));
+    case Type::Integer:     return callback(NumericValue(_integer));
+    case Type::Double:      return callback(DoubleValue(_double));
+    case Type::String:      return callback(Internal::InlineStringValue(_string, _size));
+    default:                return callback(*_value);
+    }
+}
+
 /**
  *  Constructors, one for most scalar types
  */
-VariantValue::VariantValue() : _value(new NullValue()) {}
-VariantValue::VariantValue(std::nullptr_t value) : _value(new NullValue()) {}
-VariantValue::VariantValue(bool value) : _value(new BoolValue(value)) {}
-VariantValue::VariantValue(int16_t value) : _value(new NumericValue(value)) {}
-VariantValue::VariantValue(int32_t value) : _value(new NumericValue(value)) {}
-VariantValue::VariantValue(int64_t value) : _value(new NumericValue(value)) {}
-VariantValue::VariantValue(double value) : _value(new DoubleValue(value)) {}
-VariantValue::VariantValue(const char* value) : _value(value ? (Value *)new StringValue(value) : (Value *)new NullValue()) {}
-VariantValue::VariantValue(const char* value, size_t len) : _value(value ? (Value *)new StringValue(value, len) : (Value *)new NullValue()) {}
-VariantValue::VariantValue(std::string value) : _value(new StringValue(std::move(value))) {}
-VariantValue::VariantValue(const std::vector<VariantValue>& value) : _value(new VectorValue(value)) {};
-VariantValue::VariantValue(std::vector<VariantValue>&& value) : _value(new VectorValue(std::move(value))) {};
-VariantValue::VariantValue(const std::initializer_list<VariantValue>& value) : _value(new VectorValue(value)) {};
-VariantValue::VariantValue(const std::map<std::string, VariantValue>& value) : _value(new MapValue(value)) {};
-VariantValue::VariantValue(std::map<std::string, VariantValue>&& value) : _value(new MapValue(std::move(value))) {};
-VariantValue::VariantValue(const std::initializer_list<std::map<std::string, VariantValue>::value_type>& value) : _value(new MapValue(value)) {};
-
-/**
- *  Assignment operators, one for most scalar types just like the constructors
- */
-VariantValue& VariantValue::operator=(std::nullptr_t value) { _value.reset(new NullValue()); return *this; }
-VariantValue& VariantValue::operator=(bool value) { _value.reset(new BoolValue(value)); return *this; }
-VariantValue& VariantValue::operator=(int16_t value) { _value.reset(new NumericValue(value)); return *this; }
-VariantValue& VariantValue::operator=(int32_t value) { _value.reset(new NumericValue(value)); return *this; }
-VariantValue& VariantValue::operator=(int64_t value) { _value.reset(new NumericValue(value)); return *this; }
-VariantValue& VariantValue::operator=(double value) { _value.reset(new DoubleValue(value)); return *this; }
-VariantValue& VariantValue::operator=(const char* value) { _value.reset(value ? (Value *)new StringValue(value) : (Value *)new NullValue()); return *this; }
-VariantValue& VariantValue::operator=(std::string value) { _value.reset(new StringValue(std::move(value))); return *this; }
-VariantValue& VariantValue::operator=(const std::vector<VariantValue>& value) { _value.reset(new VectorValue(value)); return *this; }
-VariantValue& VariantValue::operator=(std::vector<VariantValue>&& value) { _value.reset(new VectorValue(std::move(value))); return *this; }
-VariantValue& VariantValue::operator=(const std::initializer_list<VariantValue>& value) { _value.reset(new VectorValue(value)); return *this; }
-VariantValue& VariantValue::operator=(const std::map<std::string, VariantValue>& value) { _value.reset(new MapValue(value)); return *this; }
-VariantValue& VariantValue::operator=(std::map<std::string, VariantValue>&& value) { _value.reset(new MapValue(std::move(value))); return *this; }
-VariantValue& VariantValue::operator=(const std::initializer_list<std::map<std::string, VariantValue>::value_type>& value) { _value.reset(new MapValue(value)); return *this; }
+VariantValue::VariantValue(const char* value) { if (value) store(value, strlen(value)); }
+VariantValue::VariantValue(const char* value, size_t len) { if (value) store(value, len); }
+VariantValue::VariantValue(std::string value) { store(std::move(value)); }
+VariantValue::VariantValue(const std::vector<VariantValue>& value) : _type(Type::Shared), _value(new VectorValue(value)) {};
+VariantValue::VariantValue(std::vector<VariantValue>&& value) : _type(Type::Shared), _value(new VectorValue(std::move(value))) {};
+VariantValue::VariantValue(const std::initializer_list<VariantValue>& value) : _type(Type::Shared), _value(new VectorValue(value)) {};
+VariantValue::VariantValue(const std::map<std::string, VariantValue>& value) : _type(Type::Shared), _value(new MapValue(value)) {};
+VariantValue::VariantValue(std::map<std::string, VariantValue>&& value) : _type(Type::Shared), _value(new MapValue(std::move(value))) {};
+VariantValue::VariantValue(const std::initializer_list<std::map<std::string, VariantValue>::value_type>& value) : _type(Type::Shared), _value(new MapValue(value)) {};
+
+/**
+ *  Assignment operators, the scalar types are implemented in the header file
+ */
+VariantValue& VariantValue::operator=(const char* value) { if (value) store(value, strlen(value)); else store(nullptr); return *this; }
+VariantValue& VariantValue::operator=(const std::vector<VariantValue>& value) { return *this = std::make_shared<VectorValue>(value); }
+VariantValue& VariantValue::operator=(std::vector<VariantValue>&& value) { return *this = std::make_shared<VectorValue>(std::move(value)); }
+VariantValue& VariantValue::operator=(const std::initializer_list<VariantValue>& value) { return *this = std::make_shared<VectorValue>(value); }
+VariantValue& VariantValue::operator=(const std::map<std::string, VariantValue>& value) { return *this = std::make_shared<MapValue>(value); }
+VariantValue& VariantValue::operator=(std::map<std::string, VariantValue>&& value) { return *this = std::make_shared<MapValue>(std::move(value)); }
+VariantValue& VariantValue::operator=(const std::initializer_list<std::map<std::string, VariantValue>::value_type>& value) { return *this = std::make_shared<MapValue>(value); }
+
+/**
+ *  If this type was used in an arithmetric operation, should it then be
+ *  treated as a floating point number, or as a regular integer?
+ *  @return bool
+ */
+bool VariantValue::arithmeticFloat() const
+{
+    // pass on to the stored value
+    return visit<bool>([](const Value &value) { return value.arithmeticFloat(); });
+}
+
+/**
+ *  Convert the value to a string
+ *  @return std::string
+ */
+std::string VariantValue::toString() const
+{
+    // inline strings can be constructed right away
+    if (_type == Type::String) return std::string(_string, _size);
+
+    // pass on to the stored value
+    return visit<std::string>([](const Value &value) { return value.toString(); });
+}
+
+/**
+ *  Get access to the buffer of a stored string, without making a copy
+ *  @param  data        filled with a pointer to the buffer
+ *  @param  size        filled with the size of the buffer
+ *  @return bool        was the value a string?
+ */
+bool VariantValue::string(const char *&data, size_t &size) const
+{
+    // inline strings are stored in our own buffer
+    if (_type == Type::String)
+    {
+        // expose the buffer
+        data = _string;
+        size = _size;
+        return true;
+    }
+
+    // other inline values are not strings
+    if (_type != Type::Shared) return false;
+
+    // a variant that wraps another variant
+    if (typeid(*_value) == typeid(VariantValue)) return static_cast<const VariantValue &>(*_value).string(data, size);
+
+    // a derived class of StringValue could override toString(), so we only accept the class itself
+    if (typeid(*_value) != typeid(StringValue)) return false;
+
+    // expose the buffer of the string value
+    auto &value = static_cast<const StringValue &>(*_value).value();
+    data = value.data();
+    size = value.size();
+    return true;
+}
+
+/**
+ *  Convert the variable to a numeric value
+ *  @return integer_t
+ */
+integer_t VariantValue::toNumeric() const
+{
+    // pass on to the stored value
+    return visit<integer_t>([](const Value &value) { return value.toNumeric(); });
+}
+
+/**
+ *  Convert the variable to a boolean value
+ *  @return bool
+ */
+bool VariantValue::toBoolean() const
+{
+    // pass on to the stored value
+    return visit<bool>([](const Value &value) { return value.toBoolean(); });
+}
+
+/**
+ *  Convert the variable to a floating point value
+ *  @return double
+ */
+double VariantValue::toDouble() const
+{
+    // pass on to the stored value
+    return visit<double>([](const Value &value) { return value.toDouble(); });
+}
+
+/**
+ *  Get access to the amount of members this value has
+ *  @return size_t
+ */
+size_t VariantValue::memberCount() const
+{
+    // pass on to the stored value
+    return visit<size_t>([](const Value &value) { return value.memberCount(); });
+}
+
+/**
+ *  Get access to a member value
+ *  @param  name        name of the member
+ *  @param  size        size of the name
+ *  @return VariantValue
+ */
+VariantValue VariantValue::member(const char *name, size_t size) const
+{
+    // pass on to the stored value
+    return visit<VariantValue>([name, size](const Value &value) { return value.member(name, size); });
+}
+
+/**
+ *  Get access to a member at a certain position
+ *  @param  position    Position of the item we want to retrieve
+ *  @return VariantValue
+ */
+VariantValue VariantValue::member(size_t position) const
+{
+    // pass on to the stored value
+    return visit<VariantValue>([position](const Value &value) { return value.member(position); });
+}
+
+/**
+ *  Get access to a member at a certain position
+ *  @param  position    Position of the item we want to retrieve
+ *  @return VariantValue
+ */
+VariantValue VariantValue::member(const Value &position) const
+{
+    // pass on to the stored value
+    return visit<VariantValue>([&position](const Value &value) { return value.member(position); });
+}
+
+/**
+ *  Use this value as index of another parent value
+ *  @param  parent      the value in which to look for this key
+ *  @return VariantValue
+ */
+VariantValue VariantValue::lookupIn(const Value &parent) const
+{
+    // pass on to the stored value
+    return visit<VariantValue>([&parent](const Value &value) { return value.lookupIn(parent); });
+}
+
+/**
+ *  Create a new iterator that allows you to iterate over the subvalues
+ *  @return Newly allocated Iterator
+ */
+Iterator *VariantValue::iterator() const
+{
+    // scalar values can not be iterated over
+    if (_type != Type::Shared) return nullptr;
+
+    // pass on to the stored value
+    return _value->iterator();
+}
+
+/**
+ *  Compare two variants
+ *  @param  that        the other variant
+ *  @return bool
+ */
+bool VariantValue::operator==(const VariantValue &that) const
+{
+    // values of different types are never equal
+    if (_type != that._type) return false;
+
+    // check the type
+    switch (_type) {
+    case Type::Null:        return true;
+    case Type::Boolean:     return _boolean == that._boolean;
+    case Type::Integer:     return _integer == that._integer;
+    case Type::Double:      return _double == that._double;
+    case Type::String:      return _size == that._size && memcmp(_string, that._string, _size) == 0;
+    default:                return _value == that._value;
+    }
+}
 
 /**
  *  End namespace
@@ -18,12 +18,6 @@ namespace SmartTpl { namespace Internal {
 class VectorIterator : public SmartTpl::Iterator
 {
 private:
-    /**
-     *  The vector we're iterating over
-     *  @var std::vector
-     */
-    const std::vector<VariantValue> _vector;
-
     /**
      *  Iterator to the current position in our vector
      *  @var const_iterator
@@ -45,11 +39,15 @@ private:
 public:
     /**
      *  Constructor
+     *
+     *  The vector is not copied, the VectorValue that holds it should stay
+     *  alive as long as the iterator is in use.
+     *
+     *  @param  value       the vector to iterate over
      */
     VectorIterator(const std::vector<VariantValue> &value)
-    : _vector(value),
-      _iter(_vector.begin()),
-      _end(_vector.end()),
+    : _iter(value.begin()),
+      _end(value.end()),
       _count(0)
     {}
 
@@ -85,6 +83,15 @@ public:
         return *_iter;
     }
 
+    /**
+     *  Retrieve pointer to the current member, without copying it
+     *  @return Value
+     */
+    const Value *current() const override
+    {
+        return &*_iter;
+    }
+
     /**
      *  Retrieve a pointer to the current key
      *  @return Variant
@@ -22,13 +22,15 @@ TEST(CCode, ForEach)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n{\n"
-    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable(userdata,\"map\",3));\n"
-    "while (callbacks->valid_iterator(userdata,iterator)) {\n"
+    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable_slot(userdata,0));\n"
+    "while (callbacks->valid_iterator(userdata,iterator)) {\ncallbacks->enter_scope(userdata);\n"
     "callbacks->assign(userdata,\"key\",3,callbacks->iterator_value(userdata,iterator));\n"
-    "callbacks->write(userdata,\"key: \",5);\ncallbacks->output(userdata,callbacks->variable(userdata,\"key\",3),1);\n"
-    "callbacks->write(userdata,\"\\n\",1);\ncallbacks->iterator_next(userdata,iterator);\n}\n}\n}\n"
+    "callbacks->write(userdata,\"key: \",5);\ncallbacks->output(userdata,callbacks->variable_slot(userdata,1),1);\n"
+    "callbacks->write(userdata,\"\\n\",1);\ncallbacks->leave_scope(userdata);\ncallbacks->iterator_next(userdata,iterator);\n}\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"map\",\"key\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -41,16 +43,18 @@ TEST(CCode, ForEachWithKeys)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n{\n"
-    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable(userdata,\"map\",3));\n"
-    "while (callbacks->valid_iterator(userdata,iterator)) {\n"
+    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable_slot(userdata,0));\n"
+    "while (callbacks->valid_iterator(userdata,iterator)) {\ncallbacks->enter_scope(userdata);\n"
     "callbacks->assign(userdata,\"key\",3,callbacks->iterator_key(userdata,iterator));\n"
     "callbacks->assign(userdata,\"value\",5,callbacks->iterator_value(userdata,iterator));\n"
-    "callbacks->write(userdata,\"key: \",5);\ncallbacks->output(userdata,callbacks->variable(userdata,\"key\",3),1);\n"
+    "callbacks->write(userdata,\"key: \",5);\ncallbacks->output(userdata,callbacks->variable_slot(userdata,1),1);\n"
     "callbacks->write(userdata,\"\\nvalue: \",8);\n"
-    "callbacks->output(userdata,callbacks->variable(userdata,\"value\",5),1);\n"
-    "callbacks->iterator_next(userdata,iterator);\n}\n}\n}\n"
+    "callbacks->output(userdata,callbacks->variable_slot(userdata,2),1);\n"
+    "callbacks->leave_scope(userdata);\ncallbacks->iterator_next(userdata,iterator);\n}\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"map\",\"key\",\"value\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -63,14 +67,16 @@ TEST(CCode, ForEachElse)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n{\n"
-    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable(userdata,\"map\",3));\n"
+    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable_slot(userdata,0));\n"
     "if (!callbacks->valid_iterator(userdata,iterator)) {\ncallbacks->write(userdata,\"else\",4);\n} else {\n"
-    "while (callbacks->valid_iterator(userdata,iterator)) {\n"
+    "while (callbacks->valid_iterator(userdata,iterator)) {\ncallbacks->enter_scope(userdata);\n"
     "callbacks->assign(userdata,\"key\",3,callbacks->iterator_value(userdata,iterator));\n"
-    "callbacks->write(userdata,\"key: \",5);\ncallbacks->output(userdata,callbacks->variable(userdata,\"key\",3),1);\n"
-    "callbacks->write(userdata,\"\\n\",1);\ncallbacks->iterator_next(userdata,iterator);\n}\n}\n}\n}\n"
+    "callbacks->write(userdata,\"key: \",5);\ncallbacks->output(userdata,callbacks->variable_slot(userdata,1),1);\n"
+    "callbacks->write(userdata,\"\\n\",1);\ncallbacks->leave_scope(userdata);\ncallbacks->iterator_next(userdata,iterator);\n}\n}\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"map\",\"key\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -84,10 +90,12 @@ TEST(CCode, SingleModifier)
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->output(userdata,callbacks->modify_variable(userdata,"
-    "callbacks->variable(userdata,\"var\",3),"
-    "callbacks->modifier(userdata,\"toupper\",7),NULL),1);\n}\n"
+    "callbacks->variable_slot(userdata,0),"
+    "callbacks->modifier_slot(userdata,0),NULL),1);\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"var\",0};\n"
+    "const char *modifiers[] = {\"toupper\",0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -102,10 +110,11 @@ TEST(CCode, ChainedModifiers)
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->output(userdata,callbacks->modify_variable(userdata,"
     "callbacks->modify_variable(userdata,callbacks->modify_variable(userdata,"
-    "callbacks->modify_variable(userdata,callbacks->variable(userdata,\"var\",3),"
-    "callbacks->modifier(userdata,\"toupper\",7),NULL),callbacks->modifier(userdata,"
-    "\"tolower\",7),NULL),callbacks->modifier(userdata,\"toupper\",7),NULL),"
-    "callbacks->modifier(userdata,\"tolower\",7),NULL),1);\n}\nint personalized = 1;\nconst char *mode = \"raw\";\n");
+    "callbacks->modify_variable(userdata,callbacks->variable_slot(userdata,0),"
+    "callbacks->modifier_slot(userdata,0),NULL),callbacks->modifier_slot(userdata,1),NULL),callbacks->modifier_slot(userdata,0),NULL),"
+    "callbacks->modifier_slot(userdata,1),NULL),1);\n}\nint personalized = 1;\nconst char *mode = \"raw\";\n"
+    "const char *variables[] = {\"var\",0};\n"
+    "const char *modifiers[] = {\"toupper\",\"tolower\",0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -118,10 +127,12 @@ TEST(CCode, IfElse)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->to_boolean(userdata,callbacks->variable(userdata,\"variable\",8))){\n"
+    "if (callbacks->to_boolean(userdata,callbacks->variable_slot(userdata,0))){\n"
     "callbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"variable\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -134,13 +145,15 @@ TEST(CCode, ElseIf)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->to_boolean(userdata,callbacks->variable(userdata,\"variable\",8))){\n"
+    "if (callbacks->to_boolean(userdata,callbacks->variable_slot(userdata,0))){\n"
     "callbacks->write(userdata,\"first is true\",13);\n}else{\n"
-    "if (callbacks->to_boolean(userdata,callbacks->variable(userdata,\"othervariable\",13))){\n"
+    "if (callbacks->to_boolean(userdata,callbacks->variable_slot(userdata,1))){\n"
     "callbacks->write(userdata,\"second is true\",14);\n}else{\n"
     "callbacks->write(userdata,\"nothing is true\",15);\n}\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"variable\",\"othervariable\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -153,8 +166,10 @@ TEST(CCode, IfNotTrue)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (!1){\ncallbacks->write(userdata,\"false\",5);\n}else{\ncallbacks->write(userdata,\"true\",4);\n}\n}\n"
-    "int personalized = 0;\nconst char *mode = \"raw\";\n");
+    "callbacks->write(userdata,\"true\",4);\n}\n"
+    "int personalized = 0;\nconst char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -167,9 +182,11 @@ TEST(CCode, IfNotVar)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (!callbacks->to_boolean(userdata,callbacks->variable(userdata,\"var\",3))){\n"
+    "if (!callbacks->to_boolean(userdata,callbacks->variable_slot(userdata,0))){\n"
     "callbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
-    "int personalized = 1;\nconst char *mode = \"raw\";\n");
+    "int personalized = 1;\nconst char *mode = \"raw\";\n"
+    "const char *variables[] = {\"var\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -182,10 +199,12 @@ TEST(CCode, VarGreaterThen)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->to_double(userdata,callbacks->variable(userdata,\"age\",3))>18){\n"
+    "if (callbacks->to_double(userdata,callbacks->variable_slot(userdata,0))>18){\n"
     "callbacks->write(userdata,\"You are over 18 years old.\",26);\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"age\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -198,10 +217,12 @@ TEST(CCode, VarGreaterThenNegativeNumber)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->to_double(userdata,callbacks->variable(userdata,\"age\",3))>-1){\n"
+    "if (callbacks->to_double(userdata,callbacks->variable_slot(userdata,0))>-1){\n"
     "callbacks->write(userdata,\"You are alive..\",15);\n}\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"age\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -214,11 +235,13 @@ TEST(CCode, LiteralArrayAccess)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "callbacks->output(userdata,callbacks->member_at(userdata,callbacks->variable(userdata,\"map\",3),0),1);\n"
+    "callbacks->output(userdata,callbacks->member_at(userdata,callbacks->variable_slot(userdata,0),0),1);\n"
     "callbacks->write(userdata,\"\\n\",1);\n"
-    "callbacks->output(userdata,callbacks->member(userdata,callbacks->variable(userdata,\"map\",3),\"anothermember\",13),1);\n}\n"
+    "callbacks->output(userdata,callbacks->member(userdata,callbacks->variable_slot(userdata,0),\"anothermember\",13),1);\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"map\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -231,10 +254,11 @@ TEST(CCode, NumericComparison)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (10==100){\ncallbacks->write(userdata,\"true\",4);\n}else{\n"
-    "callbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"false\",5);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -247,9 +271,11 @@ TEST(CCode, BoolComparison)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (1==0){\ncallbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"false\",5);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -262,10 +288,11 @@ TEST(CCode, StringComparison)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->strcmp(userdata,\"string1\",7,\"string2\",7) == 0){\ncallbacks->write(userdata,\"true\",4);\n}else{\n"
-    "callbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"false\",5);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -278,10 +305,11 @@ TEST(CCode, StringComparisonNotEquals)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->strcmp(userdata,\"string1\",7,\"string2\",7) != 0){\n"
-    "callbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"true\",4);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -296,7 +324,9 @@ TEST(CCode, AssignValue)
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->assign_string(userdata,\"value\",5,\"string\",6);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -311,7 +341,9 @@ TEST(CCode, AssignValueIs)
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->assign_string(userdata,\"value\",5,\"string\",6);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -324,10 +356,11 @@ TEST(CCode, LiteralStringsWeirdCharacters)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->strcmp(userdata,\"?_\\\"<test>\",9,\"-\\'/%#^&\",7) == 0){\n"
-    "callbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"false\",5);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -340,10 +373,11 @@ TEST(CCode, LiteralEmptyString)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->strcmp(userdata,NULL,0,\"not empty\",9) == 0){\n"
-    "callbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"false\",5);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -357,12 +391,14 @@ TEST(CCode, ModifierParameters)
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->output(userdata,callbacks->modify_variable(userdata,"
-    "callbacks->variable(userdata,\"var\",3),callbacks->modifier(userdata,\"substring\",9),"
+    "callbacks->variable_slot(userdata,0),callbacks->modifier_slot(userdata,0),"
     "callbacks->params_append_integer(userdata,"
     "callbacks->params_append_integer(userdata,"
     "callbacks->create_params(userdata,2),1),5)),1);\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"var\",0};\n"
+    "const char *modifiers[] = {\"substring\",0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -379,7 +415,9 @@ TEST(CCode, Unicode)
     "\x88\x9C\xED\x95\x9C \xEC\x9C\xA0\xEB\x8B\x88 \xED\x85\x8C\xEC\x8A\xA4\xED\x8A\xB8"
     "\xEC\x9E\x85\xEB\x8B\x88\xEB\x8B\xA4 ..\",48);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -392,12 +430,11 @@ TEST(CCode, LiteralStringUnicode)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "if (callbacks->strcmp(userdata,NULL,0,\"\xEC\x9D\xB4\xEA\xB2\x83\xEC\x9D\x80 "
-    "\xEB\x8B\xA8\xEC\x88\x9C\xED\x95\x9C \xEC\x9C\xA0\xEB\x8B\x88 \xED\x85\x8C\xEC"
-    "\x8A\xA4\xED\x8A\xB8\xEC\x9E\x85\xEB\x8B\x88\xEB\x8B\xA4 ..\",48) == 0){\n"
-    "callbacks->write(userdata,\"true\",4);\n}else{\ncallbacks->write(userdata,\"false\",5);\n}\n}\n"
+    "callbacks->write(userdata,\"false\",5);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -410,9 +447,11 @@ TEST(CCode, TemplateMode)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "callbacks->output(userdata,callbacks->variable(userdata,\"var\",3),1);\n}\n"
+    "callbacks->output(userdata,callbacks->variable_slot(userdata,0),1);\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"test\";\n");
+    "const char *mode = \"test\";\n"
+    "const char *variables[] = {\"var\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
     EXPECT_EQ("test", tpl.encoding());
 
@@ -428,7 +467,9 @@ TEST(CCode, Encoded)
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->write(userdata,\"<b>This is bold</b>\",19);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"html\";\n");
+    "const char *mode = \"html\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
     EXPECT_EQ("html", tpl.encoding());
 
@@ -444,7 +485,9 @@ TEST(CCode, LiteralBlock)
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->write(userdata,\"{width=100;}{$var}{if}1 2 3\",27);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
@@ -457,10 +500,111 @@ TEST(CCode, OutputMath)
 
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "callbacks->write(userdata,\"1+3-2*10=\",9);\ncallbacks->output_integer(userdata,((1+3)-(2*10)));\n"
-    "callbacks->write(userdata,\"\\n(1+3-2)*10=\",12);\ncallbacks->output_integer(userdata,(((1+3)-2)*10));\n}\n"
+    "callbacks->write(userdata,\"1+3-2*10=-16\\n(1+3-2)*10=20\",26);\n}\n"
+    "int personalized = 0;\n"
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
+    EXPECT_EQ(expectedOutput, tpl.compile());
+
+    compile(tpl);
+}
+
+TEST(CCode, RegexLiteralPattern)
+{
+    string input("{if $email =~ \"^[a-z]+@\"}yes{else}no{/if}");
+    Template tpl((Buffer(input, 2)));
+
+    string expectedOutput("#include <smarttpl/callbacks.h>\n"
+    "static void *regexes[1];\n"
+    "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
+    "if (callbacks->regex_match(userdata,callbacks->regex_cached(userdata,&regexes[0],\"^[a-z]+@\",8),"
+    "callbacks->to_string(userdata,callbacks->variable_slot(userdata,0)), callbacks->size(userdata,callbacks->variable_slot(userdata,0)))){\n"
+    "callbacks->write(userdata,\"yes\",3);\n}else{\ncallbacks->write(userdata,\"no\",2);\n}\n}\n"
+    "int personalized = 1;\n"
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"email\",0};\n"
+    "const char *modifiers[] = {0};\n");
+    EXPECT_EQ(expectedOutput, tpl.compile());
+
+    compile(tpl);
+}
+
+TEST(CCode, StringComparisonVariable)
+{
+    string input("{if $var == \"?_\\\"<test>\"}true{/if}");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput("#include <smarttpl/callbacks.h>\n"
+    "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
+    "if (callbacks->strcmp(userdata,callbacks->to_string(userdata,callbacks->variable_slot(userdata,0)), "
+    "callbacks->size(userdata,callbacks->variable_slot(userdata,0)),\"?_\\\"<test>\",9) == 0){\n"
+    "callbacks->write(userdata,\"true\",4);\n}\n}\n"
+    "int personalized = 1;\n"
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"var\",0};\n"
+    "const char *modifiers[] = {0};\n");
+    EXPECT_EQ(expectedOutput, tpl.compile());
+
+    compile(tpl);
+}
+
+TEST(CCode, ConstantBranches)
+{
+    string input("a{if false}b{/if}c{if 2 > 1}d{else}e{/if}{1 + 2}");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput("#include <smarttpl/callbacks.h>\n"
+    "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
+    "callbacks->write(userdata,\"acd3\",4);\n}\n"
     "int personalized = 0;\n"
-    "const char *mode = \"raw\";\n");
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {0};\n");
+    EXPECT_EQ(expectedOutput, tpl.compile());
+
+    compile(tpl);
+}
+
+TEST(CCode, LiteralModifiers)
+{
+    string input("{\"abc\"|toupper}{\"abc\"|toupper|raw}");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput("#include <smarttpl/callbacks.h>\n"
+    "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
+    "callbacks->output(userdata,callbacks->transfer_string(userdata,\"ABC\",3),1);\n"
+    "callbacks->output(userdata,callbacks->modify_variable(userdata,callbacks->transfer_string(userdata,\"ABC\",3),"
+    "callbacks->modifier_slot(userdata,0),NULL),0);\n}\n"
+    "int personalized = 0;\n"
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {0};\n"
+    "const char *modifiers[] = {\"raw\",0};\n");
+    EXPECT_EQ(expectedOutput, tpl.compile());
+
+    compile(tpl);
+}
+
+TEST(CCode, LoopInvariantOutput)
+{
+    string input("{foreach $item in $list}{$item} {$shop|toupper}{/foreach}");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput("#include <smarttpl/callbacks.h>\n"
+    "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
+    "callbacks->cache_reset(userdata,0,callbacks->variable_slot(userdata,0));\n{\n"
+    "void *iterator = callbacks->create_iterator(userdata,callbacks->variable_slot(userdata,1));\n"
+    "while (callbacks->valid_iterator(userdata,iterator)) {\ncallbacks->enter_scope(userdata);\n"
+    "callbacks->assign(userdata,\"item\",4,callbacks->iterator_value(userdata,iterator));\n"
+    "callbacks->output(userdata,callbacks->variable_slot(userdata,2),1);\n"
+    "callbacks->write(userdata,\" \",1);\n"
+    "if (!callbacks->output_cached(userdata,0)) callbacks->output_store(userdata,0,callbacks->modify_variable(userdata,"
+    "callbacks->variable_slot(userdata,0),callbacks->modifier_slot(userdata,0),NULL),1);\n"
+    "callbacks->leave_scope(userdata);\ncallbacks->iterator_next(userdata,iterator);\n}\n}\n}\n"
+    "int personalized = 1;\n"
+    "const char *mode = \"raw\";\n"
+    "const char *variables[] = {\"shop\",\"list\",\"item\",0};\n"
+    "const char *modifiers[] = {\"toupper\",0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
 
     compile(tpl);
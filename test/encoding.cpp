@@ -15,6 +15,78 @@
 using namespace SmartTpl;
 using namespace std;
 
+/**
+ *  Reference implementation of the json encoding, this is how the json
+ *  escaper used to encode (ascii) strings one character at a time
+ *  @param  input
+ *  @return string
+ */
+static string jsonReference(const string &input)
+{
+    const char *hex = "0123456789abcdef";
+    string output;
+    for (const char &c : input)
+    {
+        if (c < 32 || c == '"' || c == '\\')
+        {
+            switch(c) {
+            case '\b':  output.append("\\b"); break;
+            case '\n':  output.append("\\n"); break;
+            case '\r':  output.append("\\r"); break;
+            case '\t':  output.append("\\t"); break;
+            case '\f':  output.append("\\f"); break;
+            case '"':   output.append("\\\""); break;
+            case '\\':  output.append("\\\\"); break;
+            default:
+                output.append("\\x");
+                output.push_back(hex[c >> 4]);
+                output.push_back(hex[c & 0xf]);
+            }
+        }
+        else output.push_back(c);
+    }
+    return output;
+}
+
+/**
+ *  Reference implementation of the url encoding, this is how the url
+ *  escaper used to encode (ascii) strings with an insert per character
+ *  @param  input
+ *  @return string
+ */
+static string urlReference(string input)
+{
+    const char hex[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < input.length(); ++i)
+    {
+        char &ch = input[i];
+        if (isalnum(ch) || ch == '_' || ch == '.' || ch == '-') continue;
+        if (ch == ' ') ch = '+';
+        else
+        {
+            const char encoded[] = { hex[ch >> 4], hex[ch & 0x0F] };
+            ch = '%';
+            input.insert(i + 1, encoded, sizeof(encoded));
+            i += 2;
+        }
+    }
+    return input;
+}
+
+/**
+ *  Create a random ascii string with a fair amount of special characters
+ *  @param  seed
+ *  @return string
+ */
+static string randomAscii(unsigned int seed)
+{
+    srand(seed);
+    string result;
+    size_t size = rand() % 100;
+    for (size_t i = 0; i < size; ++i) result.push_back(rand() % 4 == 0 ? char(rand() % 128) : char('a' + rand() % 26));
+    return result;
+}
+
 TEST(Encoding, Html)
 {
     string input("<b>This is {$bold}</b>");
@@ -35,6 +107,39 @@ TEST(Encoding, Html)
     }
 }
 
+/**
+ *  Long values are escaped in blocks of 16 or 32 bytes, so we put the special
+ *  characters at all possible positions in and around such blocks
+ */
+TEST(Encoding, HtmlLongValue)
+{
+    string input("{$value}");
+    Template tpl((Buffer(input)));
+
+    // the special characters and their escaped versions
+    vector<pair<char, string>> specials({ { '<', "&lt;" }, { '>', "&gt;" }, { '&', "&amp;" }, { '"', "&quot;" }, { '\'', "&apos;" } });
+
+    for (size_t position = 0; position < 70; ++position)
+    {
+        for (const auto &special : specials)
+        {
+            // a value with one special character, and one at the end
+            string value(70, 'a');
+            value[position] = special.first;
+            value.push_back('&');
+
+            // the expected escaped version
+            string escaped = value.substr(0, position) + special.second + value.substr(position + 1, 70 - position - 1) + "&amp;";
+
+            Data data;
+            data.assign("value", value);
+
+            EXPECT_EQ(escaped, tpl.process(data, "html"));
+            EXPECT_EQ(value, tpl.process(data, "raw"));
+        }
+    }
+}
+
 TEST(Encoding, HtmlToRaw)
 {
     string input("{escape}<b>This is {$bold}</b>");
@@ -45,8 +150,10 @@ TEST(Encoding, HtmlToRaw)
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->write(userdata,\"<b>This is \",11);\n"
-    "callbacks->output(userdata,callbacks->variable(userdata,\"bold\",4),1);\n"
-    "callbacks->write(userdata,\"</b>\",4);\n}\nint personalized = 1;\nconst char *mode = \"html\";\n");
+    "callbacks->output(userdata,callbacks->variable_slot(userdata,0),1);\n"
+    "callbacks->write(userdata,\"</b>\",4);\n}\nint personalized = 1;\nconst char *mode = \"html\";\n"
+    "const char *variables[] = {\"bold\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
     EXPECT_TRUE(tpl.personalized());
 
@@ -76,8 +183,10 @@ TEST(Encoding, HtmlEncodingRawOverride)
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
     "callbacks->write(userdata,\"<b>This is \",11);\n"
     "callbacks->output(userdata,callbacks->modify_variable(userdata,"
-    "callbacks->variable(userdata,\"bold\",4),callbacks->modifier(userdata,\"raw\",3),NULL),0);\n"
-    "callbacks->write(userdata,\"</b>\",4);\n}\nint personalized = 1;\nconst char *mode = \"html\";\n");
+    "callbacks->variable_slot(userdata,0),callbacks->modifier_slot(userdata,0),NULL),0);\n"
+    "callbacks->write(userdata,\"</b>\",4);\n}\nint personalized = 1;\nconst char *mode = \"html\";\n"
+    "const char *variables[] = {\"bold\",0};\n"
+    "const char *modifiers[] = {\"raw\",0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
     EXPECT_TRUE(tpl.personalized());
 
@@ -101,10 +210,12 @@ TEST(Encoding, HtmlToRawUnicode)
     data.assign("test", "( ͡° ͜ʖ ͡°)");
     string expectedOutput("#include <smarttpl/callbacks.h>\n"
     "void show_template(struct smart_tpl_callbacks *callbacks, void *userdata) {\n"
-    "callbacks->output(userdata,callbacks->variable(userdata,\"test\",4),1);\n"
+    "callbacks->output(userdata,callbacks->variable_slot(userdata,0),1);\n"
     "callbacks->write(userdata,\" ( \xCD\xA1\xC2\xB0 \xCD\x9C\xCA\x96 \xCD\xA1\xC2\xB0)\",18);\n}\n"
     "int personalized = 1;\n"
-    "const char *mode = \"html\";\n");
+    "const char *mode = \"html\";\n"
+    "const char *variables[] = {\"test\",0};\n"
+    "const char *modifiers[] = {0};\n");
     EXPECT_EQ(expectedOutput, tpl.compile());
     EXPECT_TRUE(tpl.personalized());
 
@@ -117,4 +228,93 @@ TEST(Encoding, HtmlToRawUnicode)
         EXPECT_EQ("( ͡° ͜ʖ ͡°) ( ͡° ͜ʖ ͡°)", library.process(data)); // We compiled it in html mode so default is html
         EXPECT_EQ("( ͡° ͜ʖ ͡°) ( ͡° ͜ʖ ͡°)", library.process(data, "raw")); // We request raw mode, so it decodes it for us
     }
-}
\ No newline at end of file
+}
+
+TEST(Encoding, JsonEquivalence)
+{
+    // the value is escaped by the output encoding, and by the modifier
+    Template output((Buffer("{$value}")));
+    Template modifier((Buffer("{$value|escape:\"json\"}")));
+
+    for (unsigned int seed = 0; seed < 1000; ++seed)
+    {
+        string value = randomAscii(seed);
+        string expected = jsonReference(value);
+
+        Data data;
+        data.assign("value", value);
+
+        EXPECT_EQ(expected, output.process(data, "json"));
+        EXPECT_EQ(expected, modifier.process(data, "raw"));
+    }
+}
+
+TEST(Encoding, UrlEquivalence)
+{
+    // the value is escaped by the output encoding, and by the modifier
+    Template output((Buffer("{$value}")));
+    Template modifier((Buffer("{$value|escape:\"url\"}")));
+
+    for (unsigned int seed = 0; seed < 1000; ++seed)
+    {
+        string value = randomAscii(seed);
+        string expected = urlReference(value);
+
+        Data data;
+        data.assign("value", value);
+
+        EXPECT_EQ(expected, output.process(data, "url"));
+        EXPECT_EQ(expected, modifier.process(data, "raw"));
+    }
+}
+
+TEST(Encoding, NonAscii)
+{
+    string input("{$value|escape:\"json\"} {$value|escape:\"url\"}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("value", "caf\xc3\xa9 \"ol\xc3\xa9\"");
+
+    // bytes outside the ascii range are copied as they are into json, and are hex encoded in urls
+    string expectedOutput("caf\xc3\xa9 \\\"ol\xc3\xa9\\\" caf%C3%A9+%22ol%C3%A9%22");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+class ShoutingValue : public StringValue {
+public:
+    ShoutingValue(const char *value) : StringValue(value) {}
+    virtual std::string toString() const override { return StringValue::toString() + "!"; }
+};
+
+TEST(Encoding, StringValues)
+{
+    string input("{$short} {$long} {$string} {$plain} {$derived} {$number}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("short", "<b>")
+        .assign("long", string(100, '&'))
+        .assign("string", VariantValue(std::make_shared<StringValue>("<i>")))
+        .assignManaged("plain", new StringValue("<s>"))
+        .assign("derived", VariantValue(std::make_shared<ShoutingValue>("<u>")))
+        .assign("number", 42);
+
+    // strings are escaped straight from their own buffer, other values are converted first
+    string expectedOutput("&lt;b&gt; ");
+    for (int i = 0; i < 100; ++i) expectedOutput.append("&amp;");
+    expectedOutput.append(" &lt;i&gt; &lt;s&gt; &lt;u&gt;! 42");
+    EXPECT_EQ(expectedOutput, tpl.process(data, "html"));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data, "html"));
+    }
+}
@@ -0,0 +1,123 @@
+/**
+ *  Interpreter.cpp
+ *
+ *  Tests that check that interpreted templates give the same output as
+ *  compiled templates
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+/**
+ *  Helper function to process a template both interpreted and compiled
+ *  @param  input       the template
+ *  @param  data        the data
+ *  @param  encoding    the output encoding
+ *  @return string      the interpreted output
+ */
+static string both(const string &input, const Data &data, const string &encoding = "raw")
+{
+    Template interpreted(Buffer(input), Template::never);
+    Template compiled((Buffer(input)));
+
+    // the outputs should be the same
+    string output(interpreted.process(data, encoding));
+    EXPECT_EQ(compiled.process(data, encoding), output);
+    EXPECT_EQ(compiled.personalized(), interpreted.personalized());
+    EXPECT_EQ(compiled.encoding(), interpreted.encoding());
+    return output;
+}
+
+TEST(Interpreter, Output)
+{
+    Data data;
+    data.assign("name", "John <b>").assign("a", 7).assign("b", 2).assign("x", 1.5).assign("s", "12");
+
+    EXPECT_EQ("Hello John <b>!", both("Hello {$name}!", data));
+    EXPECT_EQ("Hello John &lt;b&gt;!", both("Hello {$name}!", data, "html"));
+    EXPECT_EQ("9 5 14 3 1 3 5.5", both("{$a + $b} {$a - $b} {$a * $b} {$a / $b} {$a % $b} {$x * 2} {$a * 1 + $x * 2 - 4.5}", data));
+    EXPECT_EQ("13 true 0.5", both("{$s + 1} {true} {1 / 2.0}", data));
+    EXPECT_EQ("no output", both("no output", data));
+    EXPECT_FALSE(Template(Buffer("no output"), Template::never).personalized());
+}
+
+TEST(Interpreter, Conditions)
+{
+    Data data;
+    data.assign("a", 7).assign("b", 2).assign("name", "john").assign("email", "john@example.com");
+
+    EXPECT_EQ("yes", both("{if $a > $b}yes{else}no{/if}", data));
+    EXPECT_EQ("no", both("{if $a <= $b}yes{else}no{/if}", data));
+    EXPECT_EQ("yes", both("{if $name == \"john\"}yes{/if}", data));
+    EXPECT_EQ("yes", both("{if $name != \"jane\" and $a >= 7}yes{/if}", data));
+    EXPECT_EQ("yes", both("{if !$missing or $a < 0}yes{/if}", data));
+    EXPECT_EQ("b", both("{if $a == 1}a{elseif $a == 7}b{else}c{/if}", data));
+    EXPECT_EQ("yes", both("{if $email =~ \"^[a-z]+@\"}yes{else}no{/if}", data));
+    EXPECT_EQ("no", both("{if $name =~ $email}yes{else}no{/if}", data));
+}
+
+TEST(Interpreter, Loops)
+{
+    Data data;
+    data.assign("list", VariantValue(vector<VariantValue>({ 1, 2, 3 })))
+        .assign("empty", VariantValue(vector<VariantValue>()))
+        .assign("map", VariantValue(map<string, VariantValue>({ { "a", "x" }, { "b", "y" } })))
+        .assign("shop", "My Shop");
+
+    EXPECT_EQ("1,2,3,", both("{foreach $i in $list}{$i},{/foreach}", data));
+    EXPECT_EQ("else", both("{foreach $i in $empty}{$i}{foreachelse}else{/foreach}", data));
+    EXPECT_EQ("a=x b=y ", both("{foreach $map as $key => $value}{$key}={$value} {/foreach}", data));
+    EXPECT_EQ("1:MY SHOP 2:MY SHOP 3:MY SHOP ", both("{foreach $i in $list}{$i}:{$shop|toupper} {/foreach}", data));
+    EXPECT_EQ("11 12 13 21 22 23 31 32 33 ", both("{foreach $i in $list}{foreach $j in $list}{$i}{$j} {/foreach}{/foreach}", data));
+    EXPECT_EQ("6", both("{$total = 0}{foreach $i in $list}{$total = $total + $i}{/foreach}{$total}", data));
+    EXPECT_EQ("2", both("{$list[1]}", data));
+}
+
+TEST(Interpreter, Modifiers)
+{
+    Data data;
+    data.assign("name", "john doe").assign("n", 1234.5678);
+
+    EXPECT_EQ("JOHN DOE", both("{$name|toupper}", data));
+    EXPECT_EQ("ohn", both("{$name|substr:1:3}", data));
+    EXPECT_EQ("OHN", both("{$name|substr:1:3|toupper}", data));
+    EXPECT_EQ("1.234,57", both("{$n|number_format:2:',':'.'}", data));
+    EXPECT_EQ("yes", both("{if $name|toupper == \"JOHN DOE\"}yes{/if}", data));
+    EXPECT_EQ("default", both("{$missing|default:\"default\"}", data));
+}
+
+TEST(Interpreter, Errors)
+{
+    Data data;
+    data.assign("a", 1).assign("zero", 0).assign("pattern", "[invalid");
+
+    EXPECT_THROW(Template(Buffer("{if $a}unterminated"), Template::never), CompileError);
+    EXPECT_THROW(Template(Buffer("{$a / $zero}"), Template::never).process(data), RunTimeError);
+    EXPECT_THROW(Template(Buffer("{$a / 0}"), Template::never).process(data), RunTimeError);
+    EXPECT_THROW(Template(Buffer("{$a % $zero}"), Template::never).process(data), RunTimeError);
+    EXPECT_THROW(Template(Buffer("{if $a =~ $pattern}x{/if}"), Template::never).process(data), RunTimeError);
+}
+
+TEST(Interpreter, Compile)
+{
+    // interpreted templates can still be compiled into shared libraries
+    string input("{foreach $i in $list}{$i|toupper} {/foreach}");
+    Template tpl(Buffer(input), Template::never);
+    EXPECT_EQ(Template(Buffer(input)).compile(), tpl.compile());
+
+    Data data;
+    data.assign("list", VariantValue(vector<VariantValue>({ "a", "b" })));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ("A B ", library.process(data));
+    }
+}
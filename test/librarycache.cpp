@@ -0,0 +1,145 @@
+/**
+ *  LibraryCache.cpp
+ *
+ *  Tests for the directory with templates that were compiled into shared libraries
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+/**
+ *  Helper function to list the files in a directory
+ *  @param  directory
+ *  @return vector
+ */
+static vector<string> files(const string &directory)
+{
+    // the result
+    vector<string> result;
+
+    // open the directory
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) return result;
+
+    // add all regular entries
+    while (struct dirent *entry = readdir(dir))
+    {
+        // skip the current and parent directory
+        if (entry->d_name[0] == '.') continue;
+
+        // add the entry
+        result.emplace_back(directory + "/" + entry->d_name);
+    }
+
+    // done
+    closedir(dir);
+    return result;
+}
+
+/**
+ *  Helper function to remove a directory and the files in it
+ *  @param  directory
+ */
+static void cleanup(const string &directory)
+{
+    // remove the files and the directory
+    for (auto &file : files(directory)) unlink(file.c_str());
+    rmdir(directory.c_str());
+}
+
+TEST(LibraryCache, Load)
+{
+    char buffer[] = "/tmp/smarttpl.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(buffer));
+    string directory(buffer);
+
+    string input("Hello {$name|toupper}, {if $count > 1}{$count} items{else}one item{/if}");
+
+    Data data;
+    data.assign("name", "John").assign("count", 3);
+
+    // the first template builds the library, the second one loads it
+    Template first(Buffer(input), directory);
+    EXPECT_EQ("Hello JOHN, 3 items", first.process(data));
+    auto created = files(directory);
+
+    Template second(Buffer(input), directory);
+    EXPECT_EQ("Hello JOHN, 3 items", second.process(data));
+
+    // if a compiler is available, there is exactly one library (and no temporary files left)
+    if (!getenv("NO_COMPILE") && !no_gcc)
+    {
+        EXPECT_EQ(1, created.size());
+        EXPECT_EQ(created, files(directory));
+    }
+
+    // a different template gets its own library
+    Template other(Buffer("{$name}"), directory);
+    EXPECT_EQ("John", other.process(data));
+
+    cleanup(directory);
+}
+
+TEST(LibraryCache, Broken)
+{
+    char buffer[] = "/tmp/smarttpl.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(buffer));
+    string directory(buffer);
+
+    Data data;
+    data.assign("name", "John");
+
+    {
+        // build the library (the template has to be gone before the library is
+        // replaced, because it is still loaded as long as the template exists)
+        Template first(Buffer("Hi {$name}"), directory);
+        EXPECT_EQ("Hi John", first.process(data));
+    }
+
+    // replace the library with garbage (with a new file, like the library cache does itself)
+    auto created = files(directory);
+    for (auto &file : created)
+    {
+        ofstream(file + ".broken") << "not a shared library";
+        rename((file + ".broken").c_str(), file.c_str());
+    }
+
+    // the broken library is replaced, or the template falls back to the jit
+    Template second(Buffer("Hi {$name}"), directory);
+    EXPECT_EQ("Hi John", second.process(data));
+
+    // if a compiler is available, the library was built again
+    if (!getenv("NO_COMPILE") && !no_gcc)
+    {
+        ASSERT_EQ(1, created.size());
+        EXPECT_EQ(created, files(directory));
+        struct stat info;
+        ASSERT_EQ(0, stat(created[0].c_str(), &info));
+        EXPECT_GT(info.st_size, (off_t)strlen("not a shared library"));
+    }
+
+    // templates that can not be compiled still throw, and leave nothing behind
+    EXPECT_THROW(Template(Buffer("{if $a}unterminated"), directory), CompileError);
+
+    cleanup(directory);
+}
+
+TEST(LibraryCache, NoDirectory)
+{
+    // without a directory (or with one that does not exist) the jit is used
+    Template tpl(Buffer("{$a + 1}"), "/non/existing/directory");
+
+    Data data;
+    data.assign("a", 41);
+
+    EXPECT_EQ("42", tpl.process(data));
+}
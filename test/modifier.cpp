@@ -396,6 +396,39 @@ TEST(Modifier, DateFormat)
     }
 }
 
+TEST(Modifier, DateFormatRepeated)
+{
+    // more different dates than are remembered, with every date used twice
+    string input("{foreach $date in $dates}{$date|date_format:\"%Y-%m-%d %H:%M\"} {/foreach}");
+    Template tpl((Buffer(input)));
+
+    vector<VariantValue> dates;
+    string expectedOutput;
+    for (int round = 0; round < 2; ++round)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            // alternate between timestamps and strings that have to be parsed
+            time_t timestamp = 946684800 + i * 90000;
+            char buffer[64];
+            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", gmtime(&timestamp));
+            dates.emplace_back(i % 2 ? to_string(timestamp) : string(buffer));
+            expectedOutput.append(buffer).append(" ");
+        }
+    }
+
+    Data data;
+    data.assign("dates", dates);
+
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
 TEST(Modifier, NumberFormat)
 {
     string input("{$var1|number_format}\n{$var1|number_format:0}\n{$var1|number_format:1}\n{$var1|number_format:4}");
@@ -766,6 +799,44 @@ TEST(Modifier, Base64Decoding)
     }
 }
 
+TEST(Modifier, Base64EncodingMime)
+{
+    string input("{$var|base64_encode:76}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("var", std::string(100, 'a'));
+
+    // lines of 76 characters, separated by crlf
+    string expectedOutput("YWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFh\r\n"
+                          "YWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYWFhYQ==");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+TEST(Modifier, Base64RoundTrip)
+{
+    string input("{$var|base64_encode|base64_decode} {$var|base64_encode:64|base64_decode}");
+    Template tpl((Buffer(input)));
+
+    // binary data of all sizes, so that both the vectorized and the regular code is used
+    for (size_t size = 0; size < 200; size += 7)
+    {
+        string value;
+        for (size_t i = 0; i < size; ++i) value.push_back(char(i * 37 + size));
+
+        Data data;
+        data.assign("var", value);
+
+        EXPECT_EQ(value + " " + value, tpl.process(data));
+    }
+}
+
 TEST(Modifier, HeadList)
 {
     string input("{foreach $key in $var|range:5}{$key},{/foreach}");
@@ -160,4 +160,45 @@ TEST(Modifiers, ParametersDouble)
     EXPECT_EQ(expectedOutput, tpl.process(data));
 
     compile(tpl);
-}
\ No newline at end of file
+}
+
+/**
+ *  Modifier that counts how often it is called
+ */
+class CountingModifier : public Modifier {
+public:
+    int calls = 0;
+
+    VariantValue modify(const Value &input, const Parameters &params) override
+    {
+        ++calls;
+        return input.toString() + "!";
+    }
+};
+
+TEST(Modifiers, ResolvedPerData)
+{
+    string input("{foreach $item in $list}{$item|count_calls|toupper}{/foreach}");
+    Template tpl((Buffer(input)));
+
+    CountingModifier counter;
+    Data data1;
+    data1.modifier("count_calls", &counter)
+         .assign("list", std::vector<VariantValue>({ "a", "b", "c" }));
+
+    Data data2;
+    data2.assign("list", std::vector<VariantValue>({ "a", "b", "c" }));
+
+    EXPECT_EQ("A!B!C!", tpl.process(data1));
+    EXPECT_EQ(3, counter.calls);
+    EXPECT_EQ("ABC", tpl.process(data2));
+    EXPECT_EQ(3, counter.calls);
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ("A!B!C!", library.process(data1));
+        EXPECT_EQ("ABC", library.process(data2));
+        EXPECT_EQ(6, counter.calls);
+    }
+}
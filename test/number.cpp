@@ -0,0 +1,125 @@
+/**
+ *  Number.cpp
+ *
+ *  Tests for the conversions between numbers and text
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+#include <climits>
+#include <cmath>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(Number, FormatInteger)
+{
+    EXPECT_EQ("0", Number::toString((integer_t)0));
+    EXPECT_EQ("7", Number::toString((integer_t)7));
+    EXPECT_EQ("-42", Number::toString((integer_t)-42));
+    EXPECT_EQ("9223372036854775807", Number::toString((integer_t)LLONG_MAX));
+    EXPECT_EQ("-9223372036854775808", Number::toString((integer_t)LLONG_MIN));
+}
+
+TEST(Number, FormatDouble)
+{
+    // at most five decimals, without trailing zeros
+    EXPECT_EQ("1.5", Number::toString(1.5));
+    EXPECT_EQ("3", Number::toString(3.0));
+    EXPECT_EQ("0.33333", Number::toString(1.0 / 3.0));
+    EXPECT_EQ("-2.25", Number::toString(-2.25));
+    EXPECT_EQ("123456789.12346", Number::toString(123456789.123456));
+
+    // the exact binary value is rounded, just like printf() does
+    EXPECT_EQ("0", Number::toString(0.000004));
+    EXPECT_EQ("0.00001", Number::toString(0.000005));
+    EXPECT_EQ("-0", Number::toString(-0.000001));
+
+    // values that are too big for the fast path, and special values
+    EXPECT_EQ("100000000000000000000", Number::toString(1e20));
+    EXPECT_EQ("inf", Number::toString(INFINITY));
+}
+
+TEST(Number, ParseInteger)
+{
+    integer_t result;
+
+    // leading whitespace is skipped, and trailing text is ignored
+    EXPECT_TRUE(Number::parse("  123abc", 8, result));
+    EXPECT_EQ(123, result);
+    EXPECT_TRUE(Number::parse("-9223372036854775808", 20, result));
+    EXPECT_EQ(LLONG_MIN, result);
+
+    // only the given size is parsed
+    EXPECT_TRUE(Number::parse("12345", 2, result));
+    EXPECT_EQ(12, result);
+
+    // invalid input and overflows give zero
+    EXPECT_FALSE(Number::parse("abc", 3, result));
+    EXPECT_EQ(0, result);
+    EXPECT_FALSE(Number::parse("-", 1, result));
+    EXPECT_FALSE(Number::parse("9223372036854775808", 19, result));
+    EXPECT_EQ(0, result);
+}
+
+TEST(Number, ParseDouble)
+{
+    double result;
+
+    EXPECT_TRUE(Number::parse("1.25", 4, result));
+    EXPECT_EQ(1.25, result);
+    EXPECT_TRUE(Number::parse(" -0.1xyz", 8, result));
+    EXPECT_EQ(-0.1, result);
+    EXPECT_TRUE(Number::parse("2.5e3", 5, result));
+    EXPECT_EQ(2500.0, result);
+    EXPECT_TRUE(Number::parse("1e", 2, result));
+    EXPECT_EQ(1.0, result);
+
+    // long mantissas and big exponents are parsed correctly too
+    EXPECT_TRUE(Number::parse("3.14159265358979323846264", 25, result));
+    EXPECT_EQ(3.14159265358979323846264, result);
+    EXPECT_TRUE(Number::parse("1.5e100", 7, result));
+    EXPECT_EQ(1.5e100, result);
+
+    // invalid input and values that are out of range give zero
+    EXPECT_FALSE(Number::parse("abc", 3, result));
+    EXPECT_EQ(0.0, result);
+    EXPECT_FALSE(Number::parse("1e400", 5, result));
+    EXPECT_EQ(0.0, result);
+}
+
+TEST(Number, Append)
+{
+    string output("total: ");
+    Number::append((integer_t)12, output);
+    output.push_back(' ');
+    Number::append(0.5, output);
+    output.push_back(' ');
+    Number::append(-1234567.891, 2, ',', '.', output);
+    EXPECT_EQ("total: 12 0.5 -1.234.567,89", output);
+}
+
+TEST(Number, StringValues)
+{
+    string input("{$a + 1} {$b * 2} {$c + 1}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("a", "10")
+        .assign("b", " 21 apples")
+        .assign("c", "not a number");
+
+    string expectedOutput("11 42 1");
+
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ *  RegexCache.cpp
+ *
+ *  Tests for the process-wide cache of compiled regular expressions
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+#include <../include/regexcache.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(RegexCache, Reuse)
+{
+    RegexCache::clear();
+
+    // the same pattern gives the same compiled regex
+    auto regex1 = RegexCache::get("[a-z]+");
+    auto regex2 = RegexCache::get("[a-z]+");
+    EXPECT_EQ(regex1.get(), regex2.get());
+    EXPECT_TRUE(boost::regex_match("abc", *regex1));
+
+    // the flags are part of the key
+    auto regex3 = RegexCache::get("[a-z]+", boost::regex_constants::icase);
+    EXPECT_NE(regex1.get(), regex3.get());
+    EXPECT_TRUE(boost::regex_match("ABC", *regex3));
+    EXPECT_EQ(2, RegexCache::size());
+}
+
+TEST(RegexCache, Capacity)
+{
+    RegexCache::clear();
+    size_t capacity = RegexCache::capacity();
+
+    // fill the cache with much more patterns than fit in it
+    RegexCache::capacity(32);
+    for (int i = 0; i < 1000; ++i) RegexCache::get("pattern" + to_string(i));
+    EXPECT_GE(32 + 16, RegexCache::size());
+
+    // a regex that we still hold stays valid after it is removed
+    auto regex = RegexCache::get("held");
+    for (int i = 0; i < 1000; ++i) RegexCache::get("other" + to_string(i));
+    EXPECT_TRUE(boost::regex_match("held", *regex));
+
+    // restore the capacity
+    RegexCache::capacity(capacity);
+}
+
+TEST(RegexCache, Invalid)
+{
+    EXPECT_THROW(RegexCache::get("[a-z"), boost::regex_error);
+}
+
+TEST(RegexCache, Modifier)
+{
+    string input("{foreach $item in $list}{$item|regex_replace:\"[aeiou]\":\"*\"}{/foreach}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("list", VariantValue(std::vector<VariantValue>({"apple", "banana", "cherry"})));
+
+    string expectedOutput("*ppl*b*n*n*ch*rry");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ *  RenderContext.cpp
+ *
+ *  Tests for reusing a render context between calls to Template::process()
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(RenderContext, Reuse)
+{
+    string input("{$total = 0}{foreach $item in $list}{$total = $total + $item}{$item|cat:','}{/foreach}{$total}");
+    Template tpl((Buffer(input)));
+
+    RenderContext context;
+
+    for (int n = 1; n < 5; ++n)
+    {
+        std::vector<VariantValue> list;
+        for (int i = 0; i < n; ++i) list.push_back(i);
+
+        Data data;
+        data.assign("list", list);
+
+        string expectedOutput(tpl.process(data));
+        EXPECT_EQ(expectedOutput, tpl.process(context, data));
+        EXPECT_EQ(expectedOutput, context.output());
+    }
+}
+
+TEST(RenderContext, Library)
+{
+    string input("Hello {$name}!");
+    Template tpl((Buffer(input)));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        RenderContext context;
+
+        Data data1;
+        data1.assign("name", "John");
+        EXPECT_EQ("Hello John!", library.process(context, data1));
+
+        Data data2;
+        data2.assign("name", "Jane");
+        EXPECT_EQ("Hello Jane!", library.process(context, data2));
+    }
+}
+
+TEST(RenderContext, Release)
+{
+    Template tpl((Buffer("Hello {$name}!")));
+    RenderContext context;
+
+    Data data;
+    data.assign("name", "world");
+
+    tpl.process(context, data);
+    string output(context.release());
+    EXPECT_EQ("Hello world!", output);
+    EXPECT_EQ("", context.output());
+
+    EXPECT_EQ("Hello world!", tpl.process(context, data));
+}
+
+TEST(RenderContext, Failure)
+{
+    Template tpl((Buffer("{foreach $key in $list}{1/0}{/foreach}")));
+    RenderContext context;
+
+    Data data;
+    data.assign("var", "test");
+    data.assign("list", VariantValue({0,1,2,3,4}));
+
+    EXPECT_THROW(tpl.process(context, data), RunTimeError);
+
+    Template valid((Buffer("{$var}")));
+    EXPECT_EQ("test", valid.process(context, data));
+}
+
+TEST(RenderContext, Temporaries)
+{
+    string input("{foreach $item in $list}{$last = $item.value * 2}{$item.name|toupper}{/foreach}:{$last}");
+    Template tpl((Buffer(input)));
+
+    RenderContext context;
+
+    for (int n = 1; n < 100; n += 10)
+    {
+        std::vector<VariantValue> list;
+        for (int i = 0; i < n; ++i) list.push_back(std::map<std::string, VariantValue>({{ "name", "x" }, { "value", i }}));
+
+        Data data;
+        data.assign("list", list);
+
+        string expectedOutput(string(n, 'X') + ":" + to_string((n - 1) * 2));
+        EXPECT_EQ(expectedOutput, tpl.process(data));
+        EXPECT_EQ(expectedOutput, tpl.process(context, data));
+    }
+}
@@ -322,6 +322,30 @@ TEST(RunTime, AssigningInForEach)
     }
 }
 
+TEST(RunTime, AssigningOverridesData)
+{
+    string input("{$var}-{$var=2}-{$var}-{$other}");
+    Template tpl((Buffer(input)));
+
+    Data data1;
+    data1.assign("var", 1);
+    data1.assign("other", "a");
+
+    Data data2;
+    data2.assign("var", 3);
+
+    EXPECT_EQ("1--2-a", tpl.process(data1));
+    EXPECT_EQ("3--2-", tpl.process(data2));
+    EXPECT_EQ("1--2-a", tpl.process(data1));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ("1--2-a", library.process(data1));
+        EXPECT_EQ("3--2-", library.process(data2));
+    }
+}
+
 TEST(RunTime, ArrayAccess)
 {
     string input("{$list[3]}");
@@ -833,3 +857,201 @@ TEST(RunTime, IfWithModifierNumberComparison)
         EXPECT_EQ(expectedOutput2, library.process(data2));
     }
 }
+
+TEST(RunTime, RegexLiteralPattern)
+{
+    string input("{foreach $email in $emails}{if $email =~ \"^[a-z]+@\"}yes{else}no{/if}{/foreach}");
+    Template tpl((Buffer(input, 2)));
+
+    Data data;
+    data.assign("emails", VariantValue(std::vector<VariantValue>({"info@example.com", "Info@example.com", "john@example.com"})));
+
+    string expectedOutput("yesnoyes");
+
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+TEST(RunTime, RegexInvalidPattern)
+{
+    string input("{if $email =~ \"[a-z\"}yes{else}no{/if}");
+    Template tpl((Buffer(input, 2)));
+
+    Data data;
+    data.assign("email", "info@example.com");
+
+    EXPECT_THROW(tpl.process(data), RunTimeError);
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_THROW(library.process(data), RunTimeError);
+    }
+}
+
+TEST(RunTime, ConstantFolding)
+{
+    string input("{$x = 3 * 4}{$x} {1.5 * 2} {10 > 2.5} {!true} {\"1\" == 1} {\"abc\"|toupper|replace:\"B\":\"x\"} "
+                 "{if 1 == 2}no{elseif \"a\"}yes{else}no{/if}");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput("12 3 true false true AxC yes");
+    EXPECT_EQ(expectedOutput, tpl.process());
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process());
+    }
+}
+
+TEST(RunTime, ConstantFoldingEscape)
+{
+    // the escape modifier is applied at compile time, but the output is still escaped at runtime
+    Template folded((Buffer("{\"<b>\"|escape} {\"a b\"|escape:\"url\"}")));
+    Template runtime((Buffer("{$tag|escape} {$text|escape:\"url\"}")));
+
+    Data data;
+    data.assign("tag", "<b>")
+        .assign("text", "a b");
+
+    EXPECT_EQ("&lt;b&gt; a+b", folded.process(data, "raw"));
+    EXPECT_EQ(runtime.process(data, "raw"), folded.process(data, "raw"));
+    EXPECT_EQ(runtime.process(data, "html"), folded.process(data, "html"));
+
+    if (compile(folded)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(runtime.process(data, "html"), library.process(data, "html"));
+    }
+}
+
+TEST(RunTime, ConstantFoldingDouble)
+{
+    // the folded 1 / 3.0 must be passed to the shared library without losing precision
+    string input("{$x * (1 / 3.0)}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("x", 3);
+
+    string expectedOutput(tpl.process(data));
+    EXPECT_EQ(Template(Buffer("{3 * 0.3333333333333333}")).process(), expectedOutput);
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+TEST(RunTime, ConstantFoldingNegative)
+{
+    // the folded operands are negative, which the generated C code must put in parentheses
+    string input("{$x - (1 - 6)} {$y - (0 - 1.5)} {(0 - 9223372036854775807 - 1) + $x}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("x", 10)
+        .assign("y", 1.0);
+
+    string expectedOutput("15 2.5 -9223372036854775798");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+TEST(RunTime, ConstantFoldingZeroDivision)
+{
+    // a division by zero in a branch that is never taken is removed
+    Template removed((Buffer("{if false}{1/0}{/if}ok")));
+    EXPECT_EQ("ok", removed.process());
+
+    // but a division by zero that is executed still fails at runtime
+    Template failed((Buffer("{2 * (1/0)}")));
+    EXPECT_THROW(failed.process(), RunTimeError);
+
+    if (compile(failed)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_THROW(library.process(), RunTimeError);
+    }
+}
+
+TEST(RunTime, LoopInvariantOutput)
+{
+    // the output of $shop is cached, the output of $item and $name is not, because they change in the loop
+    string input("{foreach $item in $list}{$shop|toupper|escape:\"url\"}{$item|toupper}{$name}{$name = $item}{/foreach} "
+                 "{foreach $item in $list}{foreach $x in $list}{$item}{/foreach}{/foreach}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("shop", "a b")
+        .assign("name", "-")
+        .assign("list", VariantValue(std::vector<VariantValue>({ "x", "y" })));
+
+    string expectedOutput("A+BX-A+BYx xxyy");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    // the cached output is reset before the loop starts
+    data.assign("shop", "c");
+    EXPECT_EQ("CX-CYx xxyy", tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ("CX-CYx xxyy", library.process(data));
+    }
+}
+
+TEST(RunTime, LoopInvariantCallback)
+{
+    // callbacks that are not cached are called on every iteration
+    string input("{foreach $item in $list}{$counter} {/foreach}");
+    Template tpl((Buffer(input)));
+
+    int counter = 0;
+    Data data;
+    data.assign("list", VariantValue(std::vector<VariantValue>({ 1, 2, 3 })))
+        .callback("counter", [&counter]() { return ++counter; });
+
+    string expectedOutput("1 2 3 ");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        counter = 0;
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+TEST(RunTime, DateBeforeEpoch)
+{
+    // one second before the epoch is a valid timestamp too (the seconds do not depend on the timezone)
+    string input("{$date}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assignManaged("date", new DateValue("%S", -1));
+
+    string expectedOutput("59");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
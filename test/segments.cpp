@@ -0,0 +1,69 @@
+/**
+ *  Segments.cpp
+ *
+ *  Tests for collecting the output of a template as a list of segments
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(Segments, StaticText)
+{
+    // the long pieces of static text get a segment of their own
+    string header(200, 'h');
+    string footer(100, 'f');
+    string input(header + "Hello {$name}!" + footer + "{foreach $i in $list}{$i}," + footer + "{/foreach}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("name", "<world>")
+        .assign("list", VariantValue({ 1, 2 }));
+
+    Segments segments;
+    string expectedOutput(tpl.process(data, "html"));
+    EXPECT_EQ(expectedOutput, tpl.process(segments, data, "html").str());
+    EXPECT_EQ(expectedOutput.size(), segments.bytes());
+
+    // the tokenizer merges the text around the variables, so we get the header
+    // with the greeting, the name, the footer, and two segments for every iteration
+    vector<string> expectedSegments({ header + "Hello ", "&lt;world&gt;", "!" + footer, "1", "," + footer, "2", "," + footer });
+    ASSERT_EQ(expectedSegments.size(), segments.size());
+    for (size_t i = 0; i < expectedSegments.size(); ++i)
+    {
+        EXPECT_EQ(expectedSegments[i], string((const char *)segments.data()[i].iov_base, segments.data()[i].iov_len));
+    }
+
+    // the object can be reused
+    data.assign("name", "again");
+    EXPECT_EQ(tpl.process(data), tpl.process(segments, data).str());
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        data.assign("name", "<world>");
+        EXPECT_EQ(expectedOutput, library.process(segments, data, "html").str());
+        EXPECT_EQ(expectedSegments.size(), segments.size());
+    }
+}
+
+TEST(Segments, Failure)
+{
+    Template tpl((Buffer(string(100, 'x') + "{foreach $key in $list}{1/0}{/foreach}")));
+    Segments segments;
+
+    Data data;
+    data.assign("list", VariantValue({0,1,2}));
+
+    EXPECT_THROW(tpl.process(segments, data), RunTimeError);
+
+    Template valid((Buffer("short")));
+    EXPECT_EQ("short", valid.process(segments, data).str());
+    EXPECT_EQ(1, segments.size());
+}
@@ -0,0 +1,119 @@
+/**
+ *  Sink.cpp
+ *
+ *  Tests for streaming the output of a template to a sink
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(Sink, Stream)
+{
+    string input("{foreach $item in $list}item: {$item}\n{/foreach}");
+    Template tpl((Buffer(input)));
+
+    std::vector<VariantValue> list;
+    for (int i = 0; i < 5; ++i) list.push_back(i);
+
+    Data data;
+    data.assign("list", list);
+
+    string expectedOutput("item: 0\nitem: 1\nitem: 2\nitem: 3\nitem: 4\n");
+
+    ostringstream stream;
+    StreamSink sink(stream);
+    tpl.process(data, sink);
+    EXPECT_EQ(expectedOutput, stream.str());
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        ostringstream stream;
+        StreamSink sink(stream);
+        library.process(data, sink);
+        EXPECT_EQ(expectedOutput, stream.str());
+    }
+}
+
+TEST(Sink, Chunks)
+{
+    string input("{foreach $item in $list}<b>{$item}</b>{/foreach}");
+    Template tpl((Buffer(input)));
+
+    std::vector<VariantValue> list;
+    for (int i = 0; i < 10000; ++i) list.push_back(i);
+
+    Data data;
+    data.assign("list", list);
+
+    string expectedOutput(tpl.process(data));
+
+    string output;
+    size_t chunks = 0;
+    size_t biggest = 0;
+    CallbackSink sink([&](const char *buffer, size_t size) {
+        output.append(buffer, size);
+        biggest = std::max(biggest, size);
+        chunks++;
+    }, 256);
+
+    tpl.process(data, sink);
+    EXPECT_EQ(expectedOutput, output);
+    EXPECT_GT(chunks, 1);
+    EXPECT_LT(biggest, 512);
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        output.clear();
+        library.process(data, sink);
+        EXPECT_EQ(expectedOutput, output);
+    }
+}
+
+TEST(Sink, FileDescriptor)
+{
+    string input("Hello {$name}!");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("name", "world");
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    FileDescriptorSink sink(fds[1]);
+    tpl.process(data, sink);
+    close(fds[1]);
+
+    char buffer[64];
+    ssize_t size = read(fds[0], buffer, sizeof(buffer));
+    close(fds[0]);
+
+    EXPECT_EQ("Hello world!", string(buffer, size > 0 ? size : 0));
+}
+
+TEST(Sink, Failure)
+{
+    string input("{foreach $item in $list}{$item}{/foreach}");
+    Template tpl((Buffer(input)));
+
+    std::vector<VariantValue> list;
+    for (int i = 0; i < 1000; ++i) list.push_back(i);
+
+    Data data;
+    data.assign("list", list);
+
+    CallbackSink sink([](const char *buffer, size_t size) {
+        throw std::runtime_error("connection lost");
+    }, 16);
+
+    EXPECT_THROW(tpl.process(data, sink), RunTimeError);
+}
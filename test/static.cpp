@@ -0,0 +1,153 @@
+/**
+ *  Static.cpp
+ *
+ *  Tests for templates that do not use personalisation data, and of which
+ *  the output is only generated once
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+#include <thread>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(Static, Output)
+{
+    string footer(200, 'f');
+    string input("<footer>" + footer + "{if 1 == 1}&copy;{/if}</footer>");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput("<footer>" + footer + "&copy;</footer>");
+
+    EXPECT_FALSE(tpl.personalized());
+    EXPECT_EQ(expectedOutput, tpl.process());
+
+    // the output is generated once, and shared after that
+    auto output = tpl.output();
+    ASSERT_NE(nullptr, output);
+    EXPECT_EQ(expectedOutput, *output);
+    EXPECT_EQ(output, tpl.output());
+    EXPECT_EQ(output, tpl.output("raw"));
+
+    // other encodings have output of their own
+    auto html = tpl.output("html");
+    ASSERT_NE(nullptr, html);
+    EXPECT_NE(output, html);
+    EXPECT_EQ(tpl.process("html"), *html);
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process());
+        ASSERT_NE(nullptr, library.output());
+        EXPECT_EQ(expectedOutput, *library.output());
+        EXPECT_EQ(library.output(), library.output());
+    }
+}
+
+TEST(Static, Personalized)
+{
+    string input("Hello {$name}");
+    Template tpl((Buffer(input)));
+
+    // personalised templates have to be processed every time
+    EXPECT_EQ(nullptr, tpl.output());
+
+    Data data1;
+    data1.assign("name", "John");
+    EXPECT_EQ("Hello John", tpl.process(data1));
+
+    Data data2;
+    data2.assign("name", "Jane");
+    EXPECT_EQ("Hello Jane", tpl.process(data2));
+}
+
+class ExclaimModifier : public Modifier {
+public:
+    VariantValue modify(const Value &input, const Parameters &params) override
+    {
+        return input.toString() + "!";
+    }
+};
+
+TEST(Static, Modifiers)
+{
+    string input("{\"hello\"|exclaim}");
+    Template tpl((Buffer(input)));
+
+    // the modifiers come from the data, so the output is not always the same
+    EXPECT_EQ(nullptr, tpl.output());
+
+    ExclaimModifier exclaim;
+    Data data;
+    data.modifier("exclaim", &exclaim);
+
+    EXPECT_EQ("hello!", tpl.process(data));
+    EXPECT_EQ("hello", tpl.process());
+}
+
+TEST(Static, Outputs)
+{
+    string header(200, 'h');
+    string input(header + "{if 2 > 1}{1 + 2}{else}nothing{/if}");
+    Template tpl((Buffer(input)));
+
+    string expectedOutput(header + "3");
+    ASSERT_NE(nullptr, tpl.output());
+    EXPECT_EQ(expectedOutput, *tpl.output());
+
+    // the context can be reused
+    RenderContext context;
+    EXPECT_EQ(expectedOutput, tpl.process(context, Data()));
+    EXPECT_EQ(expectedOutput, tpl.process(context, Data()));
+
+    // the segments refer to the shared output
+    Segments segments;
+    EXPECT_EQ(expectedOutput, tpl.process(segments, Data()).str());
+    EXPECT_EQ(expectedOutput.size(), segments.bytes());
+    ASSERT_EQ(1, segments.size());
+    EXPECT_EQ(tpl.output()->data(), segments.data()[0].iov_base);
+
+    // and the sink gets it in one go
+    ostringstream stream;
+    StreamSink sink(stream);
+    tpl.process(Data(), sink);
+    EXPECT_EQ(expectedOutput, stream.str());
+}
+
+TEST(Static, Interpreted)
+{
+    string input("{6 * 7} is the answer");
+    Template tpl(Buffer(input), Template::never);
+
+    ASSERT_NE(nullptr, tpl.output());
+    EXPECT_EQ("42 is the answer", *tpl.output());
+    EXPECT_EQ("42 is the answer", tpl.process());
+
+    // the tiered executor knows it too
+    Template tiered(Buffer(input), 2);
+    for (int i = 0; i < 5; ++i) EXPECT_EQ("42 is the answer", tiered.process());
+    EXPECT_EQ(tiered.output(), tiered.output());
+}
+
+TEST(Static, Threads)
+{
+    Template tpl((Buffer(string(1000, 'x') + "{if true}<y>{/if}")));
+    vector<thread> threads;
+    vector<shared_ptr<const string>> outputs(8);
+
+    // every thread gets the same output, even if they render it at the same time
+    for (int i = 0; i < 8; ++i) threads.emplace_back([&tpl, &outputs, i]() {
+        outputs[i] = tpl.output("html");
+    });
+
+    for (auto &thread : threads) thread.join();
+
+    for (auto &output : outputs) EXPECT_EQ(outputs[0], output);
+    EXPECT_EQ(string(1000, 'x') + "<y>", *outputs[0]);
+}
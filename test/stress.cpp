@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <../smarttpl.h>
+#include <chrono>
 
 #include "ccode.h"
 
@@ -57,4 +58,82 @@ TEST(Stress, InnerForEachLoops)
     for (int i = 0; i < 10000; ++i) input.append("{foreach $map as $key => $value}");
     for (int i = 0; i < 10000; ++i) input.append("{/foreach}");
     EXPECT_THROW(Template tpl((Buffer(input))), std::runtime_error);
-}
\ No newline at end of file
+}
+
+/**
+ *  Every value that is created or assigned inside a loop passes through the
+ *  ownership tracking of the handler, this should not make long loops quadratic
+ */
+TEST(Stress, LongForEachLoop)
+{
+    string input("{foreach $item in $list}{$copy = $item}{$copy.value}{$total = $item.value + 1}{/foreach}{$total}");
+    Template tpl((Buffer(input)));
+
+    std::vector<VariantValue> list;
+    for (int i = 0; i < 100000; ++i) list.push_back(std::map<std::string, VariantValue>({{ "value", i % 10 }}));
+
+    Data data;
+    data.assign("list", list);
+    for (int i = 0; i < 1000; ++i) data.assign("variable" + to_string(i), i);
+
+    string expectedOutput;
+    for (int i = 0; i < 100000; ++i) expectedOutput.append(to_string(i % 10));
+    expectedOutput.append("10");
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(expectedOutput, library.process(data));
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    }
+}
+
+/**
+ *  Values that are assigned inside a loop should outlive the loop, even
+ *  though the temporaries of every iteration are destructed
+ */
+TEST(Stress, ForEachScopes)
+{
+    string input("{foreach $a in $list}{foreach $b in $list}{$sum = $sum + $a * $b}{/foreach}{$last = $a + 1}{/foreach}{$sum} {$last} {$a} {$b}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    data.assign("list", std::vector<VariantValue>({ 1, 2, 3 }));
+    data.assign("sum", 0);
+
+    string expectedOutput("36 4 3 3");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
+
+TEST(Stress, ManyVariables)
+{
+    string input("{$variable0}-{$variable500}-{$variable999|toupper}-{$variable1000}");
+    Template tpl((Buffer(input)));
+
+    Data data;
+    for (int i = 0; i < 1000; ++i) data.assign("variable" + to_string(i), "value" + to_string(i));
+    data.assign("variable999", "last");
+
+    string expectedOutput("value0-value500-LAST-");
+    EXPECT_EQ(expectedOutput, tpl.process(data));
+    EXPECT_EQ(nullptr, data.value("variable10000", 12));
+    EXPECT_NE(nullptr, data.value("variable10000", 11));
+    EXPECT_NE(nullptr, data.modifier("toupper", 7));
+
+    if (compile(tpl)) // This will compile the Template into a shared library
+    {
+        Template library(File(SHARED_LIBRARY)); // Here we load that shared library
+        EXPECT_EQ(expectedOutput, library.process(data));
+    }
+}
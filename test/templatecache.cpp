@@ -0,0 +1,157 @@
+/**
+ *  TemplateCache.cpp
+ *
+ *  Tests for the cache of compiled templates
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+#include <thread>
+#include <sys/time.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+/**
+ *  Helper function to give a file a modification time that is different
+ *  from the previous call, even on file systems with a low resolution
+ *  @param  name
+ */
+static void touchFile(const string &name)
+{
+    static time_t counter = 1000000;
+    struct timeval times[2] = { { ++counter, 0 }, { counter, 0 } };
+    utimes(name.c_str(), times);
+}
+
+/**
+ *  Helper function to write a file, with a modification time that is
+ *  different from the previous write
+ *  @param  name
+ *  @param  content
+ */
+static void writeFile(const string &name, const string &content)
+{
+    // write the file
+    ofstream(name) << content;
+
+    // make sure the modification time changes
+    touchFile(name);
+}
+
+TEST(TemplateCache, SameSource)
+{
+    TemplateCache cache;
+
+    Data data;
+    data.assign("name", "John");
+
+    Template first(cache.get(Buffer("Hello {$name}!")));
+    Template second(cache.get(Buffer("Hello {$name}!")));
+    Template other(cache.get(Buffer("Bye {$name}!")));
+
+    EXPECT_EQ("Hello John!", first.process(data));
+    EXPECT_EQ("Hello John!", second.process(data));
+    EXPECT_EQ("Bye John!", other.process(data));
+    EXPECT_EQ(2, cache.size());
+
+    // the tokenizer version is part of the key
+    Template version(cache.get(Buffer(string("Hello {$name}!"), 2)));
+    EXPECT_EQ("Hello John!", version.process(data));
+    EXPECT_EQ(3, cache.size());
+}
+
+TEST(TemplateCache, Budget)
+{
+    TemplateCache cache;
+    cache.get(Buffer("one"));
+    cache.get(Buffer("two"));
+    cache.get(Buffer("three"));
+    EXPECT_EQ(3, cache.size());
+
+    // with a small budget only the most recently used template remains
+    cache.get(Buffer("one"));
+    cache.budget(1);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_LE(cache.used(), 64 * 1024);
+
+    // templates that were removed from the cache remain valid
+    Template tpl(cache.get(Buffer("four")));
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ("four", tpl.process());
+}
+
+TEST(TemplateCache, File)
+{
+    TemplateCache cache;
+    string name("templatecache.tpl");
+
+    writeFile(name, "first {$x}");
+    Data data;
+    data.assign("x", 1);
+
+    EXPECT_EQ("first 1", cache.get(name).process(data));
+    EXPECT_EQ("first 1", cache.get(name).process(data));
+    EXPECT_EQ(1, cache.size());
+
+    // a modified file is loaded again
+    writeFile(name, "second {$x}");
+    EXPECT_EQ("second 1", cache.get(name).process(data));
+    EXPECT_EQ(2, cache.size());
+
+    // a buffer with the same content shares the compiled template
+    EXPECT_EQ("second 1", cache.get(Buffer("second {$x}")).process(data));
+    EXPECT_EQ(2, cache.size());
+
+    // files that do not exist give an error
+    unlink(name.c_str());
+    EXPECT_THROW(cache.get(name), std::runtime_error);
+}
+
+TEST(TemplateCache, Library)
+{
+    TemplateCache cache;
+
+    Template first((Buffer("first")));
+    if (!compile(first)) return; // This will compile the Template into a shared library
+    touchFile(SHARED_LIBRARY);
+
+    EXPECT_EQ("first", cache.get(SHARED_LIBRARY).process());
+    EXPECT_EQ("first", cache.get(SHARED_LIBRARY).process());
+    EXPECT_EQ(1, cache.size());
+
+    Template second((Buffer("second")));
+    if (!compile(second)) return;
+    touchFile(SHARED_LIBRARY);
+
+    // the previous library can only be found by filename, so it is removed
+    EXPECT_EQ("second", cache.get(SHARED_LIBRARY).process());
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST(TemplateCache, Threads)
+{
+    TemplateCache cache;
+    vector<thread> threads;
+    atomic<int> failures(0);
+
+    for (int i = 0; i < 8; ++i) threads.emplace_back([&cache, &failures, i]() {
+        for (int j = 0; j < 50; ++j)
+        {
+            Data data;
+            data.assign("i", i).assign("j", j);
+            Template tpl(cache.get(Buffer("{$i}-{$j}{if $j > 10}!{/if}")));
+            if (tpl.process(data) != to_string(i) + "-" + to_string(j) + (j > 10 ? "!" : "")) failures++;
+        }
+    });
+
+    for (auto &thread : threads) thread.join();
+
+    EXPECT_EQ(0, failures);
+    EXPECT_EQ(1, cache.size());
+}
@@ -0,0 +1,153 @@
+/**
+ *  Tiered.cpp
+ *
+ *  Tests for templates that are interpreted first, and compiled later
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+#include <thread>
+#include <dirent.h>
+
+#include "ccode.h"
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(Tiered, Promotion)
+{
+    string input("{foreach $i in $list}{$i * 2}{if $i % 2 == 0}even{else}odd{/if} {foreachelse}none{/foreach}{$name|toupper|substr:1:2}{$x = $list[1] + 1}{$x}");
+    Template tpl(Buffer(input), 3);
+    Template compiled((Buffer(input)));
+
+    Data data;
+    data.assign("list", VariantValue(vector<VariantValue>({ 1, 2, 3 }))).assign("name", "john");
+
+    string expectedOutput("2odd 4even 6odd OH3");
+
+    // the output is the same before and after the template is compiled
+    for (int i = 0; i < 6; ++i) EXPECT_EQ(expectedOutput, tpl.process(data));
+    EXPECT_EQ(expectedOutput, compiled.process(data));
+    EXPECT_EQ(compiled.compile(), tpl.compile());
+    EXPECT_TRUE(tpl.personalized());
+
+    // a template that is compiled right away
+    Template immediate(Buffer(input), 0);
+    EXPECT_EQ(expectedOutput, immediate.process(data));
+}
+
+TEST(Tiered, Errors)
+{
+    // templates that can not be parsed throw right away
+    EXPECT_THROW(Template(Buffer("{if $a}unterminated"), 10), CompileError);
+
+    // runtime errors are the same in every tier
+    Template tpl(Buffer("{$a / $b} {$c / 0.0}"), 2);
+    Data data;
+    data.assign("a", 10).assign("b", 0).assign("c", 1.0);
+    for (int i = 0; i < 4; ++i) EXPECT_THROW(tpl.process(data), RunTimeError);
+
+    // invalid regular expressions too
+    Template regex(Buffer("{if $a =~ $b}match{/if}"), 2);
+    data.assign("b", "[invalid");
+    for (int i = 0; i < 4; ++i) EXPECT_THROW(regex.process(data), RunTimeError);
+}
+
+TEST(Tiered, Threads)
+{
+    Template tpl(Buffer("{$i}-{$j}{if $j > 10}!{/if}"), 20);
+    vector<thread> threads;
+    atomic<int> failures(0);
+
+    // the template is promoted while the other threads keep processing it
+    for (int i = 0; i < 8; ++i) threads.emplace_back([&tpl, &failures, i]() {
+        for (int j = 0; j < 50; ++j)
+        {
+            Data data;
+            data.assign("i", i).assign("j", j);
+            if (tpl.process(data) != to_string(i) + "-" + to_string(j) + (j > 10 ? "!" : "")) failures++;
+        }
+    });
+
+    for (auto &thread : threads) thread.join();
+
+    EXPECT_EQ(0, failures);
+}
+
+TEST(Tiered, Segments)
+{
+    string header(200, 'h');
+    Template tpl(Buffer(header + "{$name}"), 2);
+
+    Data data;
+    data.assign("name", "John");
+
+    // the first render is done by the interpreter
+    Segments segments;
+    EXPECT_EQ(header + "John", tpl.process(segments, data).str());
+    ASSERT_EQ(2, segments.size());
+    const void *interpreted = segments.data()[0].iov_base;
+
+    // the second render promotes the template, we wait for the new executor
+    Segments other;
+    for (int i = 0; i < 300 && (other.size() == 0 || other.data()[0].iov_base == interpreted); ++i)
+    {
+        EXPECT_EQ(header + "John", tpl.process(other, data).str());
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+
+    // the segments of the interpreter are still valid
+    EXPECT_EQ(interpreted, segments.data()[0].iov_base);
+    EXPECT_EQ(header, string((const char *)segments.data()[0].iov_base, segments.data()[0].iov_len));
+    EXPECT_EQ(header + "John", segments.str());
+}
+
+TEST(Tiered, Library)
+{
+    char buffer[] = "/tmp/smarttpl.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(buffer));
+    string directory(buffer);
+
+    Data data;
+    data.assign("name", "John");
+
+    // the names of the files in the directory
+    auto list = [&directory]() {
+        vector<string> files;
+        DIR *dir = opendir(directory.c_str());
+        while (struct dirent *entry = readdir(dir)) if (entry->d_name[0] != '.') files.emplace_back(directory + "/" + entry->d_name);
+        closedir(dir);
+        return files;
+    };
+
+    {
+        // the shared library is compiled in the background after the second render
+        Template tpl(Buffer("Hello {$name}"), 2, directory);
+        for (int i = 0; i < 100; ++i) EXPECT_EQ("Hello John", tpl.process(data));
+
+        // the template does not wait for the compiler when it is destructed, so we do
+        // (the library is moved into place when it is ready, the name ends with .so then)
+        for (int i = 0; i < 3000 && !getenv("NO_COMPILE") && !no_gcc; ++i)
+        {
+            auto files = list();
+            if (files.size() == 1 && files[0].compare(files[0].size() - 3, 3, ".so") == 0) break;
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+
+        // the template keeps working
+        EXPECT_EQ("Hello John", tpl.process(data));
+    }
+
+    // there is one library
+    auto files = list();
+    if (!getenv("NO_COMPILE") && !no_gcc)
+    {
+        EXPECT_EQ(1, files.size());
+    }
+
+    // clean up
+    for (auto &file : files) unlink(file.c_str());
+    rmdir(buffer);
+}
@@ -0,0 +1,84 @@
+/**
+ *  VariantValue.cpp
+ *
+ *  Tests for the inline and shared storage of variant values
+ *
+ *  @copyright 2019 Copernica BV
+ */
+
+#include <gtest/gtest.h>
+#include <../smarttpl.h>
+
+using namespace SmartTpl;
+using namespace std;
+
+TEST(VariantValue, Scalars)
+{
+    EXPECT_EQ("", VariantValue().toString());
+    EXPECT_EQ("true", VariantValue(true).toString());
+    EXPECT_EQ(42, VariantValue(42).toNumeric());
+    EXPECT_EQ("3.5", VariantValue(3.5).toString());
+    EXPECT_TRUE(VariantValue(3.5).arithmeticFloat());
+    EXPECT_FALSE(VariantValue(3).arithmeticFloat());
+    EXPECT_EQ(nullptr, VariantValue(3).iterator());
+}
+
+TEST(VariantValue, Strings)
+{
+    string small("short");
+    string large(100, 'x');
+
+    EXPECT_EQ(small, VariantValue(small).toString());
+    EXPECT_EQ(large, VariantValue(large).toString());
+    EXPECT_EQ(large, VariantValue(large.data(), large.size()).toString());
+    EXPECT_EQ(123, VariantValue("123").toNumeric());
+    EXPECT_FALSE(VariantValue("0").toBoolean());
+    EXPECT_EQ("", VariantValue((const char *)nullptr).toString());
+}
+
+TEST(VariantValue, CopyAndMove)
+{
+    VariantValue value("inline");
+    VariantValue copy(value);
+    VariantValue moved(std::move(copy));
+
+    EXPECT_EQ("inline", value.toString());
+    EXPECT_EQ("inline", moved.toString());
+    EXPECT_EQ("", copy.toString());
+
+    moved = std::string(100, 'y');
+    value = moved;
+    EXPECT_EQ(string(100, 'y'), value.toString());
+    EXPECT_TRUE(value == moved);
+
+    value = 10;
+    EXPECT_EQ(10, value.toNumeric());
+    EXPECT_FALSE(value == moved);
+}
+
+TEST(VariantValue, Members)
+{
+    VariantValue list(std::vector<VariantValue>({ 1, "two", 3.0 }));
+    VariantValue map(std::map<std::string, VariantValue>({{ "key", "value" }}));
+
+    EXPECT_EQ(3, list.memberCount());
+    EXPECT_EQ("two", list.member(1).toString());
+    EXPECT_EQ("3", list.member(VariantValue(2)).toString());
+    EXPECT_EQ("value", map.member(VariantValue("key")).toString());
+    EXPECT_EQ("", VariantValue("key").member(0).toString());
+}
+
+TEST(VariantValue, Iterator)
+{
+    VariantValue list(std::vector<VariantValue>({ 1, 2, 3 }));
+    std::unique_ptr<Iterator> iterator(list.iterator());
+
+    int count = 0;
+    for (; iterator->valid(); iterator->next(), ++count)
+    {
+        EXPECT_EQ(count, iterator->key().toNumeric());
+        EXPECT_EQ(count + 1, iterator->value().toNumeric());
+        EXPECT_EQ(count + 1, iterator->current()->toNumeric());
+    }
+    EXPECT_EQ(3, count);
+}